@@ -17,6 +17,8 @@ COMMUNICATION := src/communication
 COMMON := src/common
 CLIENT := src/client
 SERVER := src/server
+SIMULATOR := src/simulator
+BENCHMARK := src/benchmark
 
 CONNECTOR := src/connector/fuse
 ifneq ($(wildcard /usr/include/xfs/dmapi.h),)
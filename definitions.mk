@@ -72,7 +72,7 @@ $(DEPDIR) $(LIBDIR) $(BINDIR):
 
 # auto dependencies
 $(DEPS): $(SOURCE_FILES) | $(DEPDIR)
-	$(CXX) $(CXXFLAGS) -MM $(SOURCE_FILES) > $@
+	$(CXX) $(CXXFLAGS) -MM $^ > $@
 
 libdir: | $(LIBDIR)
 
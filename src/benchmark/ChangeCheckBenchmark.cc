@@ -0,0 +1,142 @@
+/*******************************************************************************
+ * Copyright 2018 IBM Corp. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *******************************************************************************/
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+
+#include "src/server/ServerIncludes.h"
+
+#include "ChangeCheckBenchmark.h"
+
+/*
+ * Both variants copy the file in chunks of CHUNK_SIZE bytes to a file in
+ * the target directory that stands in for the tape and compare the
+ * modification time of the source file with the one it had before. The
+ * first one calls stat() on the file name after every chunk the way
+ * Migration::transferData did before Migration::checkUnchanged has been
+ * introduced. The second one follows Migration::transferData: the
+ * modification time is compared before the transfer, every
+ * Const::CHANGE_CHECK_SIZE bytes, and after the last chunk with fstat()
+ * on the open file. This is what FsObj::stat does for the FUSE connector
+ * apart from reading the migration attribute. fstat() is used directly
+ * such that any file can be copied.
+ */
+
+double ChangeCheckBenchmark::copy(bool byName, long *numChecks)
+
+{
+    std::chrono::time_point<std::chrono::steady_clock> start;
+    std::unique_ptr<char[]> buffer(new char[CHUNK_SIZE]);
+    std::string targetName = targetDir + "/ltfsdmbench.changecheck";
+    struct stat orig;
+    struct stat statbuf;
+    long offset = 0;
+    long checked = 0;
+    long rsize;
+    int source;
+    int target;
+
+    auto check = [&]() {
+        if ((byName ? ::stat(fileName.c_str(), &statbuf) :
+                ::fstat(source, &statbuf)) == -1)
+            THROW(Error::GENERAL_ERROR, fileName, errno);
+        if (statbuf.st_mtim.tv_sec != orig.st_mtim.tv_sec
+                || statbuf.st_mtim.tv_nsec != orig.st_mtim.tv_nsec)
+            THROW(Error::GENERAL_ERROR, fileName);
+        (*numChecks)++;
+    };
+
+    *numChecks = 0;
+
+    if ((source = open(fileName.c_str(), O_RDONLY)) == -1)
+        THROW(Error::GENERAL_ERROR, fileName, errno);
+
+    if ((target = open(targetName.c_str(), O_WRONLY | O_CREAT | O_TRUNC,
+            0600)) == -1) {
+        close(source);
+        THROW(Error::GENERAL_ERROR, targetName, errno);
+    }
+
+    try {
+        if (fstat(source, &orig) == -1)
+            THROW(Error::GENERAL_ERROR, fileName, errno);
+
+        start = std::chrono::steady_clock::now();
+
+        if (!byName)
+            check();
+
+        while (offset < orig.st_size) {
+            if ((rsize = pread(source, buffer.get(), CHUNK_SIZE, offset))
+                    <= 0)
+                THROW(Error::GENERAL_ERROR, fileName, rsize, errno);
+            if (write(target, buffer.get(), rsize) != rsize)
+                THROW(Error::GENERAL_ERROR, targetName, errno);
+
+            offset += rsize;
+
+            if (byName) {
+                check();
+            } else if (offset - checked >= Const::CHANGE_CHECK_SIZE) {
+                check();
+                checked = offset;
+            }
+        }
+
+        if (!byName)
+            check();
+    } catch (const std::exception& e) {
+        close(target);
+        close(source);
+        unlink(targetName.c_str());
+        throw;
+    }
+
+    close(target);
+    close(source);
+    unlink(targetName.c_str());
+
+    return std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count();
+}
+
+void ChangeCheckBenchmark::run()
+
+{
+    struct stat statbuf;
+    double duration;
+    long numChecks;
+
+    if (::stat(fileName.c_str(), &statbuf) == -1)
+        THROW(Error::GENERAL_ERROR, fileName, errno);
+
+    std::cout << fileName << ": " << statbuf.st_size << " bytes, "
+            << numRuns << " runs per variant" << std::endl << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+
+    // both variants alternate to be equally affected by the page cache
+    for (int i = 0; i < numRuns; i++) {
+        for (bool byName : { true, false }) {
+            duration = copy(byName, &numChecks);
+            std::cout << (byName ? "stat on the file name: " :
+                                   "fstat on the open file:") << " "
+                    << duration << " s ("
+                    << statbuf.st_size / duration / 1000000 << " MB/s), "
+                    << numChecks << " checks" << std::endl;
+        }
+    }
+}
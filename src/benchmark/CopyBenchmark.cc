@@ -0,0 +1,122 @@
+/*******************************************************************************
+ * Copyright 2018 IBM Corp. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *******************************************************************************/
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+
+#include "src/server/ServerIncludes.h"
+
+#include "CopyBenchmark.h"
+
+/*
+ * The file is copied to a file in the target directory with each of the
+ * methods of DataMover (see @ref data_mover): read and write with a buffer
+ * of BUFFER_SIZE bytes like the copy loop before DataMover has been added,
+ * and copy_file_range and sendfile with chunks of Const::TRANSFER_SIZE
+ * bytes. Unlike DataMover a method is not replaced by the next one if it
+ * is not supported; the copy fails instead.
+ */
+
+double CopyBenchmark::copy(method mth, unsigned long size)
+
+{
+    std::chrono::time_point<std::chrono::steady_clock> start;
+    std::unique_ptr<char[]> buffer;
+    std::string targetName = targetDir + "/ltfsdmbench.copy";
+    unsigned long offset = 0;
+    off_t off = 0;
+    long rsize;
+    int source;
+    int target;
+
+    if (mth == BUFFERED)
+        buffer = std::unique_ptr<char[]>(new char[BUFFER_SIZE]);
+
+    if ((source = open(fileName.c_str(), O_RDONLY)) == -1)
+        THROW(Error::GENERAL_ERROR, fileName, errno);
+
+    if ((target = open(targetName.c_str(), O_WRONLY | O_CREAT | O_TRUNC,
+            0600)) == -1) {
+        close(source);
+        THROW(Error::GENERAL_ERROR, targetName, errno);
+    }
+
+    start = std::chrono::steady_clock::now();
+
+    while (offset < size) {
+        switch (mth) {
+            case BUFFERED:
+                if ((rsize = pread(source, buffer.get(), BUFFER_SIZE, offset))
+                        > 0 && write(target, buffer.get(), rsize) != rsize)
+                    rsize = -1;
+                break;
+            case COPY_FILE_RANGE:
+#ifdef __NR_copy_file_range
+                rsize = syscall(__NR_copy_file_range, source, &off, target,
+                        NULL, Const::TRANSFER_SIZE, 0);
+#else
+                rsize = -1;
+                errno = ENOSYS;
+#endif
+                break;
+            default:
+                rsize = sendfile(target, source, &off, Const::TRANSFER_SIZE);
+        }
+
+        if (rsize <= 0) {
+            close(target);
+            close(source);
+            unlink(targetName.c_str());
+            THROW(Error::GENERAL_ERROR, fileName, mth, rsize, errno);
+        }
+
+        offset += rsize;
+    }
+
+    close(target);
+    close(source);
+    unlink(targetName.c_str());
+
+    return std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count();
+}
+
+void CopyBenchmark::run()
+
+{
+    const std::string names[] = { "read/write:     ", "copy_file_range:",
+            "sendfile:       " };
+    struct stat statbuf;
+    double duration;
+
+    if (::stat(fileName.c_str(), &statbuf) == -1)
+        THROW(Error::GENERAL_ERROR, fileName, errno);
+
+    std::cout << fileName << ": " << statbuf.st_size << " bytes, "
+            << numRuns << " runs per method" << std::endl << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+
+    // the methods alternate to be equally affected by the page cache
+    for (int i = 0; i < numRuns; i++) {
+        for (method mth : { BUFFERED, COPY_FILE_RANGE, SENDFILE }) {
+            duration = copy(mth, statbuf.st_size);
+            std::cout << names[mth] << " " << duration << " s ("
+                    << statbuf.st_size / duration / 1000000 << " MB/s)"
+                    << std::endl;
+        }
+    }
+}
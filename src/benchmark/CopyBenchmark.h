@@ -0,0 +1,41 @@
+/*******************************************************************************
+ * Copyright 2018 IBM Corp. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *******************************************************************************/
+#pragma once
+
+class CopyBenchmark
+{
+private:
+    enum method
+    {
+        BUFFERED, COPY_FILE_RANGE, SENDFILE
+    };
+
+    // the buffer size of the copy loop before DataMover has been added
+    static const unsigned long BUFFER_SIZE = 512 * 1024;
+
+    std::string fileName;
+    std::string targetDir;
+    int numRuns;
+
+    double copy(method mth, unsigned long size);
+public:
+    CopyBenchmark(std::string _fileName, std::string _targetDir, int _numRuns) :
+            fileName(_fileName), targetDir(_targetDir), numRuns(_numRuns)
+    {
+    }
+    void run();
+};
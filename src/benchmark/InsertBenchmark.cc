@@ -0,0 +1,110 @@
+/*******************************************************************************
+ * Copyright 2018 IBM Corp. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *******************************************************************************/
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+
+#include "src/server/ServerIncludes.h"
+
+#include "InsertBenchmark.h"
+
+/*
+ * Both variants add the jobs of a selective recall request with the
+ * statement SQLJobStore::ADD_SELRECALL_JOB to the in-memory database of
+ * the backend. The first one formats the statement and prepares, executes,
+ * and finalizes it for each job (SQLStatement) the way the jobs have been
+ * added before SQLCachedStatement has been introduced. The second one is
+ * SQLJobStore::addJob that binds the values to a cached statement.
+ */
+
+JobStore::job_t InsertBenchmark::genJob(int reqNum, unsigned long num)
+
+{
+    std::stringstream fileName;
+
+    // 1000 files per directory
+    fileName << "/mnt/bench/dir." << num / 1000 << "/file." << num;
+
+    return (JobStore::job_t ) { DataBase::SELRECALL, fileName.str(), reqNum,
+                    FsObj::PREMIGRATED, Const::UNSET, "",
+                    static_cast<long>(num % 65536 + 1), (fuid_t ) { 1, 1, 0,
+                            num }, 1500000000, 0, FsObj::MIGRATED,
+                    "D00001L5", static_cast<long>(num), 0 };
+}
+
+double InsertBenchmark::formatted(int reqNum)
+
+{
+    std::chrono::time_point<std::chrono::steady_clock> start;
+    JobStore::job_t job;
+
+    start = std::chrono::steady_clock::now();
+
+    for (unsigned long i = 0; i < numJobs; i++) {
+        job = genJob(reqNum, i);
+        SQLStatement stmt = SQLStatement(SQLJobStore::ADD_SELRECALL_JOB)
+                << job.op << job.fileName << job.reqNum << job.targetState
+                << job.fileSize << job.fuid.fsid_h << job.fuid.fsid_l
+                << job.fuid.igen << job.fuid.inum << job.mtimeSec
+                << job.mtimeNsec << time(NULL) << job.state << job.tapeId
+                << job.startBlock;
+        stmt.doall();
+    }
+
+    return std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count();
+}
+
+double InsertBenchmark::cached(int reqNum)
+
+{
+    std::chrono::time_point<std::chrono::steady_clock> start;
+    SQLJobStore store;
+
+    start = std::chrono::steady_clock::now();
+
+    for (unsigned long i = 0; i < numJobs; i++)
+        store.addJob(genJob(reqNum, i));
+
+    return std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count();
+}
+
+void InsertBenchmark::run()
+
+{
+    SQLJobStore store;
+    double duration;
+
+    DB.open(true, "");
+    DB.createTables();
+
+    std::cout << std::fixed << std::setprecision(1);
+
+    // the table is emptied between both variants to start with the same size
+    duration = formatted(1);
+    std::cout << "formatted statements: " << numJobs << " jobs in "
+            << duration << " s (" << numJobs / duration << " jobs/s)"
+            << std::endl;
+    store.deleteJobs(1);
+
+    duration = cached(2);
+    std::cout << "cached statements:    " << numJobs << " jobs in "
+            << duration << " s (" << numJobs / duration << " jobs/s)"
+            << std::endl;
+    store.deleteJobs(2);
+}
@@ -0,0 +1,245 @@
+/*******************************************************************************
+ * Copyright 2018 IBM Corp. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *******************************************************************************/
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+
+#include "src/server/ServerIncludes.h"
+
+#include "JobStoreBenchmark.h"
+
+/*
+ * The same workload is performed through the JobStore interface for
+ * SQLJobStore and for ColumnJobStore. It follows the calls of the
+ * backend for a migration request that is processed on NUM_TAPES
+ * cartridges (Migration::processFiles) and for a selective recall request
+ * for files on the same number of cartridges (SelRecall::execRequest).
+ * The job state changes of both are performed by numThreads threads that
+ * share a single batch like the threads of the backend that transfer or
+ * recall the files.
+ */
+
+const std::string JobStoreBenchmark::tapeIds[NUM_TAPES] = { "D00001L5",
+        "D00002L5", "D00003L5", "D00004L5" };
+
+JobStore::job_t JobStoreBenchmark::genJob(DataBase::operation op,
+        unsigned long num)
+
+{
+    std::stringstream fileName;
+    bool migration = (op == DataBase::MIGRATION);
+
+    // 1000 files per directory
+    fileName << (migration ? "/mnt/bench/mig." : "/mnt/bench/rec.")
+            << num / 1000 << "/file." << num;
+
+    // the sizes and positions on tape are spread by a multiplicative hash
+    return (JobStore::job_t ) { op, fileName.str(), migration ? 1 : 2,
+                    FsObj::PREMIGRATED, migration ? 0 : Const::UNSET,
+                    migration ? "pool1" : "",
+                    static_cast<long>((num * 2654435761UL) % (1UL << 20) + 1),
+                    (fuid_t ) { 1, 1, 0, migration ? num : numJobs + num },
+                    1500000000, 0,
+                    migration ? FsObj::RESIDENT : FsObj::MIGRATED,
+                    migration ? "" : tapeIds[num % NUM_TAPES],
+                    static_cast<long>((num * 40503UL) % numJobs), 0 };
+}
+
+void JobStoreBenchmark::parallel(const std::vector<long>& jobIds,
+        std::function<void(long)> process)
+
+{
+    std::vector<std::thread> threads;
+    unsigned long share = jobIds.size() / numThreads + 1;
+
+    for (unsigned long first = 0; first < jobIds.size(); first += share)
+        threads.push_back(
+                std::thread([&jobIds, process, first, share]() {
+                    for (unsigned long i = first;
+                            i < std::min(first + share, jobIds.size()); i++)
+                        process(jobIds[i]);
+                }));
+
+    for (std::thread& thread : threads)
+        thread.join();
+}
+
+void JobStoreBenchmark::check(JobStore& store, int reqNum,
+        FsObj::file_state state)
+
+{
+    std::map<FsObj::file_state, int> states = store.countStates(reqNum);
+
+    if (states[state] != static_cast<int>(numJobs)) {
+        std::stringstream msg;
+        msg << states[state] << " of " << numJobs << " jobs of request "
+                << reqNum << " in state " << state;
+        THROW(Error::GENERAL_ERROR, msg.str());
+    }
+}
+
+JobStoreBenchmark::results_t JobStoreBenchmark::workload(JobStore& store)
+
+{
+    std::chrono::time_point<std::chrono::steady_clock> start;
+    results_t results;
+    std::stringstream threads;
+
+    auto measure = [&](std::string phase, std::function<void()> exec) {
+        start = std::chrono::steady_clock::now();
+        exec();
+        results.push_back(
+                std::make_pair(phase,
+                        std::chrono::duration<double>(
+                                std::chrono::steady_clock::now() - start).count()));
+    };
+
+    threads << " (" << numThreads << " threads)";
+
+    measure("add migration jobs", [&]() {
+        for (unsigned long i = 0; i < numJobs; i++)
+            store.addJob(genJob(DataBase::MIGRATION, i));
+    });
+
+    // each cartridge takes its share of the remaining files (first fit)
+    measure("assign cartridges", [&]() {
+        for (int i = 0; i < NUM_TAPES; i++) {
+            std::shared_ptr<JobStore::Batch> assign = store.createBatch();
+            JobStore::unclaimed_t unclaimed = store.unclaimed(1, 0,
+                    FsObj::RESIDENT);
+            unsigned long freeSpace = unclaimed.size / (NUM_TAPES - i);
+            std::vector<long> jobIds;
+
+            store.selectUnassigned(1, 0, FsObj::RESIDENT,
+                    [&](long jobId, unsigned long size) {
+                        if (freeSpace < unclaimed.minSize)
+                            return false;
+                        if (size <= freeSpace) {
+                            freeSpace -= size;
+                            jobIds.push_back(jobId);
+                        }
+                        return true;
+                    });
+
+            for (long jobId : jobIds)
+                assign->assignTape(jobId, tapeIds[i], FsObj::RESIDENT,
+                        FsObj::TRANSFERRING);
+            assign->flush();
+        }
+    });
+
+    measure("transfer" + threads.str(), [&]() {
+        for (std::string tapeId : tapeIds) {
+            std::shared_ptr<JobStore::Batch> successes = store.createBatch();
+            std::vector<long> jobIds;
+
+            store.selectMigJobs(1, tapeId, FsObj::TRANSFERRING,
+                    [&jobIds](const JobStore::mig_job_t& job) {
+                        jobIds.push_back(job.jobId);
+                        return true;
+                    });
+
+            parallel(jobIds, [&successes](long jobId) {
+                successes->setState(nullptr, jobId, FsObj::TRANSFERRING,
+                        FsObj::PREMIGRATED);
+            });
+            successes->flush();
+        }
+    });
+    check(store, 1, FsObj::PREMIGRATED);
+
+    // the progress of a request is determined periodically
+    measure("count states", [&]() {
+        for (int i = 0; i < NUM_COUNTS; i++)
+            store.countStates(1);
+    });
+
+    measure("add recall jobs", [&]() {
+        for (unsigned long i = 0; i < numJobs; i++)
+            store.addJob(genJob(DataBase::SELRECALL, i));
+    });
+
+    measure("recall" + threads.str(), [&]() {
+        for (std::string tapeId : tapeIds) {
+            std::shared_ptr<JobStore::Batch> successes = store.createBatch();
+            std::vector<long> jobIds;
+
+            store.changeState( { 2 }, Const::UNSET, tapeId, FsObj::MIGRATED,
+                    FsObj::RECALLING_MIG);
+
+            // in the order of the start blocks
+            store.selectRecallJobs( { 2 }, tapeId,
+                    [&jobIds](const JobStore::rec_job_t& job) {
+                        jobIds.push_back(job.jobId);
+                        return true;
+                    });
+
+            parallel(jobIds, [&successes](long jobId) {
+                successes->setRecalled(nullptr, jobId, FsObj::PREMIGRATED);
+            });
+            successes->flush();
+
+            store.changeState( { 2 }, Const::UNSET, tapeId,
+                    FsObj::RECALLING_MIG, FsObj::MIGRATED);
+        }
+    });
+    check(store, 2, FsObj::PREMIGRATED);
+
+    measure("delete jobs", [&]() {
+        store.deleteJobs(1);
+        store.deleteJobs(2);
+    });
+
+    return results;
+}
+
+void JobStoreBenchmark::run()
+
+{
+    SQLJobStore sqlStore;
+    ColumnJobStore columnStore;
+    results_t sqlResults;
+    results_t columnResults;
+    double sqlTotal = 0;
+    double columnTotal = 0;
+
+    DB.open(true, "");
+    DB.createTables();
+
+    sqlResults = workload(sqlStore);
+    columnResults = workload(columnStore);
+
+    std::cout << numJobs << " jobs per request" << std::endl << std::endl;
+    std::cout << std::left << std::setw(30) << "phase" << std::right
+            << std::setw(16) << "SQLJobStore [s]" << std::setw(20)
+            << "ColumnJobStore [s]" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+
+    for (results_t::iterator sqlit = sqlResults.begin(), colit =
+            columnResults.begin(); sqlit != sqlResults.end(); ++sqlit, ++colit) {
+        std::cout << std::left << std::setw(30) << sqlit->first << std::right
+                << std::setw(16) << sqlit->second << std::setw(20)
+                << colit->second << std::endl;
+        sqlTotal += sqlit->second;
+        columnTotal += colit->second;
+    }
+
+    std::cout << std::left << std::setw(30) << "total" << std::right
+            << std::setw(16) << sqlTotal << std::setw(20) << columnTotal
+            << std::endl;
+}
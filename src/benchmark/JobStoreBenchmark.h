@@ -0,0 +1,42 @@
+/*******************************************************************************
+ * Copyright 2018 IBM Corp. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *******************************************************************************/
+#pragma once
+
+class JobStoreBenchmark
+{
+private:
+    typedef std::list<std::pair<std::string, double>> results_t;
+
+    static const int NUM_TAPES = 4;
+    static const int NUM_COUNTS = 100;
+    static const std::string tapeIds[NUM_TAPES];
+
+    unsigned long numJobs;
+    int numThreads;
+
+    JobStore::job_t genJob(DataBase::operation op, unsigned long num);
+    void parallel(const std::vector<long>& jobIds,
+            std::function<void(long)> process);
+    void check(JobStore& store, int reqNum, FsObj::file_state state);
+    results_t workload(JobStore& store);
+public:
+    JobStoreBenchmark(unsigned long _numJobs, int _numThreads) :
+            numJobs(_numJobs), numThreads(_numThreads)
+    {
+    }
+    void run();
+};
@@ -0,0 +1,174 @@
+/*******************************************************************************
+ * Copyright 2018 IBM Corp. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *******************************************************************************/
+#include <dirent.h>
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+
+#include "src/server/ServerIncludes.h"
+
+#include "TransferBenchmark.h"
+
+/*
+ * The files of the source directory are transferred to a pipe that stands
+ * in for the tape. A thread reads from the pipe at tapeRate MB/s (without
+ * limit if zero) like a drive: if it has to wait for data it continues at
+ * the same rate afterwards. The files are processed by numThreads threads
+ * that serialize the transfer on a mutex like the threads of
+ * Migration::transferData on LTFSDMDrive::mtx. The data is
+ * copied by DataMover::toTape. With read-ahead each thread first reads the
+ * beginning of its file into a BufferPool of the same size as
+ * LTFSDMDrive::pool before waiting for the mutex (DataMover::readAhead).
+ *
+ * The files are opened with FsObj. For the FUSE connector they need to be
+ * located in a managed file system to provide a file descriptor.
+ */
+
+void TransferBenchmark::drain(int fd)
+
+{
+    std::chrono::time_point<std::chrono::steady_clock> written;
+    std::unique_ptr<char[]> buffer(new char[Const::TRANSFER_SIZE]);
+    long rsize;
+
+    written = std::chrono::steady_clock::now();
+
+    while ((rsize = read(fd, buffer.get(), Const::TRANSFER_SIZE)) > 0) {
+        if (tapeRate == 0)
+            continue;
+        // the time the drive has waited for data cannot be made up
+        written = std::max(written, std::chrono::steady_clock::now())
+                + std::chrono::microseconds(rsize / tapeRate);
+        std::this_thread::sleep_until(written);
+    }
+}
+
+double TransferBenchmark::transfer(bool readAhead, unsigned long *size)
+
+{
+    std::chrono::time_point<std::chrono::steady_clock> start;
+    BufferPool pool(Const::TRANSFER_SIZE,
+            Const::READ_AHEAD_SIZE / Const::TRANSFER_SIZE);
+    std::vector<std::thread> threads;
+    std::atomic<unsigned long> next(0);
+    std::atomic<unsigned long> transferred(0);
+    std::exception_ptr error;
+    std::mutex mtx;
+    int pipefd[2];
+
+    if (pipe(pipefd) == -1)
+        THROW(Error::GENERAL_ERROR, errno);
+
+    // a larger pipe reduces the number of context switches
+    fcntl(pipefd[1], F_SETPIPE_SZ, 1024 * 1024);
+
+    start = std::chrono::steady_clock::now();
+
+    std::thread drainer(&TransferBenchmark::drain, this, pipefd[0]);
+
+    for (int i = 0; i < numThreads; i++)
+        threads.push_back(std::thread([&]() {
+            unsigned long num;
+
+            while ((num = next++) < fileNames.size()) {
+                try {
+                    FsObj source(fileNames[num]);
+                    struct stat statbuf = source.stat();
+                    DataMover mover(BLOCK_SIZE);
+                    long offset = 0;
+                    long rsize;
+
+                    if (readAhead)
+                        mover.readAhead(&source, 0, statbuf.st_size, &pool);
+
+                    std::lock_guard<std::mutex> writelock(mtx);
+
+                    while (offset < statbuf.st_size) {
+                        rsize = mover.toTape(&source, offset, pipefd[1],
+                                statbuf.st_size - offset);
+                        if (rsize <= 0)
+                            THROW(Error::GENERAL_ERROR, fileNames[num],
+                                    rsize, errno);
+                        offset += rsize;
+                    }
+
+                    transferred += statbuf.st_size;
+                } catch (const std::exception& e) {
+                    std::lock_guard<std::mutex> lock(mtx);
+                    error = std::current_exception();
+                    next = fileNames.size();
+                }
+            }
+        }));
+
+    for (std::thread& thread : threads)
+        thread.join();
+
+    close(pipefd[1]);
+    drainer.join();
+    close(pipefd[0]);
+
+    if (error)
+        std::rethrow_exception(error);
+
+    *size = transferred;
+
+    return std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count();
+}
+
+void TransferBenchmark::run()
+
+{
+    DIR *dir;
+    struct dirent *dentry;
+    struct stat statbuf;
+    unsigned long size;
+    double duration;
+
+    if ((dir = opendir(sourceDir.c_str())) == NULL)
+        THROW(Error::GENERAL_ERROR, sourceDir, errno);
+
+    while ((dentry = readdir(dir)) != NULL) {
+        std::string fileName = sourceDir + "/" + dentry->d_name;
+        if (::stat(fileName.c_str(), &statbuf) == 0
+                && S_ISREG(statbuf.st_mode))
+            fileNames.push_back(fileName);
+    }
+
+    closedir(dir);
+
+    if (fileNames.size() == 0)
+        THROW(Error::GENERAL_ERROR, sourceDir);
+
+    std::cout << fileNames.size() << " files, " << numThreads
+            << " threads, tape rate ";
+    if (tapeRate > 0)
+        std::cout << tapeRate << " MB/s";
+    else
+        std::cout << "unlimited";
+    std::cout << std::endl << std::endl << std::fixed << std::setprecision(1);
+
+    for (bool readAhead : { false, true }) {
+        duration = transfer(readAhead, &size);
+        std::cout << (readAhead ? "with read-ahead:    " :
+                                  "without read-ahead: ")
+                << size / 1000000 << " MB in " << duration << " s ("
+                << size / duration / 1000000 << " MB/s)" << std::endl;
+    }
+}
@@ -0,0 +1,40 @@
+/*******************************************************************************
+ * Copyright 2018 IBM Corp. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *******************************************************************************/
+#pragma once
+
+class TransferBenchmark
+{
+private:
+    // the default block size of LTFS
+    static const unsigned long BLOCK_SIZE = 512 * 1024;
+
+    std::string sourceDir;
+    int numThreads;
+    unsigned long tapeRate;
+    std::vector<std::string> fileNames;
+
+    void drain(int fd);
+    double transfer(bool readAhead, unsigned long *size);
+public:
+    TransferBenchmark(std::string _sourceDir, int _numThreads,
+            unsigned long _tapeRate) :
+            sourceDir(_sourceDir), numThreads(_numThreads), tapeRate(
+                    _tapeRate)
+    {
+    }
+    void run();
+};
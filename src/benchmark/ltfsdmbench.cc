@@ -0,0 +1,156 @@
+/*******************************************************************************
+ * Copyright 2018 IBM Corp. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *******************************************************************************/
+#include <iostream>
+
+#include "src/server/ServerIncludes.h"
+
+#include "InsertBenchmark.h"
+#include "JobStoreBenchmark.h"
+#include "ChangeCheckBenchmark.h"
+#include "CopyBenchmark.h"
+#include "TransferBenchmark.h"
+
+/** @page benchmark Benchmarks
+
+    # Benchmarks
+
+    The command <TT>ltfsdmbench</TT> measures the throughput of parts of
+    the backend in isolation. It links the same code as the backend but
+    neither needs a tape library nor a managed file system and the backend
+    does not need to be started. The benchmark is selected with the option
+    <TT>-b</TT>:
+
+    @verbatim
+    ltfsdmbench -b insert [-n <number of jobs>]
+    ltfsdmbench -b jobstore [-n <number of jobs>] [-t <threads>]
+    ltfsdmbench -b changecheck -f <file> -o <directory> [-r <runs>]
+    ltfsdmbench -b copy -f <file> -o <directory> [-r <runs>]
+    ltfsdmbench -b transfer -f <directory> [-t <threads>] [-w <MB/s>]
+    @endverbatim
+
+    benchmark | measures
+    :---:|---
+    insert | Adding the jobs of a selective recall request to the in-memory database: formatting and preparing the statement for each job (SQLStatement) compared to SQLJobStore::addJob that binds the values to a cached statement (SQLCachedStatement). By default 1000000 jobs are added.
+    jobstore | The same workload through the JobStore interface for SQLJobStore and for ColumnJobStore (see @ref job_store): a migration request with 1000000 jobs (by default) that is processed on four cartridges and a selective recall request with the same number of jobs. The job state changes are performed by 64 threads (by default) that share a batch. The time of each phase is printed for both job stores.
+    changecheck | Copying a file in chunks of 512 KiB to a file in another directory that stands in for the tape while checking that the file is not modified: stat() on the file name after every chunk compared to the checks of Migration::transferData (see @ref migration) with fstat() on the open file. The throughput and the number of checks are printed for 5 runs (by default) of each variant.
+    copy | Copying a file to a file in another directory with the methods of DataMover (see @ref data_mover): read and write with a buffer of 512 KiB, copy_file_range, and sendfile. The throughput is printed for 5 runs (by default) of each method.
+    transfer | Transferring the files of a directory with DataMover to a pipe that stands in for the tape and that is read at 300 MB/s (by default, 0 for no limit). The transfers are performed by 16 threads (by default) that serialize on a mutex like the threads of a drive. The throughput is printed without and with read-ahead (see @ref data_mover). With the FUSE connector the directory needs to be located in a managed file system.
+
+    The results are printed to stdout. Compare runs on the same system
+    only and build the code with optimization (e.g. by adding -O2 to
+    CXXFLAGS in definitions.mk) since the default build has none.
+ */
+
+void usage(char *name)
+
+{
+    std::cout << "usage: " << name << " -b insert [-n <number of jobs>]"
+            << std::endl << "       " << name
+            << " -b jobstore [-n <number of jobs>] [-t <threads>]"
+            << std::endl << "       " << name
+            << " -b changecheck -f <file> -o <directory> [-r <runs>]"
+            << std::endl << "       " << name
+            << " -b copy -f <file> -o <directory> [-r <runs>]" << std::endl
+            << "       " << name
+            << " -b transfer -f <directory> [-t <threads>] [-w <MB/s>]"
+            << std::endl;
+}
+
+int main(int argc, char **argv)
+
+{
+    std::string benchmark;
+    unsigned long num = 1000000;
+    // the default number of threads depends on the benchmark
+    int threads = 0;
+    std::string fileName;
+    std::string targetDir;
+    int runs = 5;
+    unsigned long tapeRate = 300;
+    int opt;
+
+    try {
+        while ((opt = getopt(argc, argv, "hb:n:t:f:o:r:w:")) != -1) {
+            switch (opt) {
+                case 'b':
+                    benchmark = optarg;
+                    break;
+                case 'n':
+                    num = std::stoul(optarg);
+                    break;
+                case 't':
+                    threads = std::stoi(optarg);
+                    break;
+                case 'f':
+                    fileName = optarg;
+                    break;
+                case 'o':
+                    targetDir = optarg;
+                    break;
+                case 'r':
+                    runs = std::stoi(optarg);
+                    break;
+                case 'w':
+                    tapeRate = std::stoul(optarg);
+                    break;
+                default:
+                    usage(argv[0]);
+                    return 1;
+            }
+        }
+    } catch (const std::exception& e) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    if (optind != argc || num == 0 || threads < 0 || runs <= 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    // the trace file only is opened by the backend
+    traceObject.setTrclevel(Trace::none);
+
+    try {
+        if (benchmark.compare("insert") == 0) {
+            InsertBenchmark(num).run();
+        } else if (benchmark.compare("jobstore") == 0) {
+            JobStoreBenchmark(num,
+                    threads > 0 ? threads : Const::MAX_STUBBING_THREADS).run();
+        } else if (benchmark.compare("changecheck") == 0
+                && fileName.size() > 0 && targetDir.size() > 0) {
+            ChangeCheckBenchmark(fileName, targetDir, runs).run();
+        } else if (benchmark.compare("copy") == 0 && fileName.size() > 0
+                && targetDir.size() > 0) {
+            CopyBenchmark(fileName, targetDir, runs).run();
+        } else if (benchmark.compare("transfer") == 0
+                && fileName.size() > 0) {
+            TransferBenchmark(fileName,
+                    threads > 0 ? threads : Const::MAX_PREMIG_THREADS,
+                    tapeRate).run();
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    } catch (const std::exception& e) {
+        std::cout << "benchmark " << benchmark << " failed: " << e.what()
+                << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -47,6 +47,7 @@
 #include "PoolDeleteCommand.h"
 #include "PoolAddCommand.h"
 #include "PoolRemoveCommand.h"
+#include "PoolLimitCommand.h"
 #include "InfoPoolsCommand.h"
 #include "RetrieveCommand.h"
 #include "HelpCommand.h"
@@ -167,6 +168,8 @@ void HelpCommand::doCommand(int argc, char **argv)
                 ltfsdmCommand = new PoolAddCommand();
             } else if (PoolRemoveCommand().compare(command)) {
                 ltfsdmCommand = new PoolRemoveCommand();
+            } else if (PoolLimitCommand().compare(command)) {
+                ltfsdmCommand = new PoolLimitCommand();
             } else {
                 ltfsdmCommand = new PoolCommand();
             }
@@ -48,6 +48,17 @@
     parameters | description
     ---|---
     -n \<request number\> | restrict the jobs to be displayed to a certain request
+    -o \<operation\> | restrict the jobs to a certain operation (e.g. migration)
+    -s \<state\> | restrict the jobs to a certain state (e.g. failed)
+    -t \<tape id\> | restrict the jobs to a certain cartridge
+    -P \<pool\> | restrict the jobs to a certain tape storage pool
+    -d \<path prefix\> | restrict the jobs to file names starting with the prefix
+    -l \<limit\> | display at most the specified number of jobs
+    -O \<offset\> | skip the specified number of jobs, ordered by the time they have been added
+    -g state\|tape\|pool | display the number of jobs and their size per state, cartridge, or pool instead
+
+    All filters and the summary are evaluated by the backend, only the
+    resulting lines are transferred to the client.
 
     Example:
 
@@ -64,6 +75,10 @@
     migration            transferring         2                    pool1                DV1462L6             1073741824           /mnt/lxfs/test1/file.7
     migration            transferring         2                    pool1                DV1462L6             1073741824           /mnt/lxfs/test1/file.8
     migration            transferring         2                    pool1                DV1462L6             1073741824           /mnt/lxfs/test1/file.9
+    [root@visp ~]# ltfsdm info jobs -n 2 -g state
+    state                number of jobs       size
+    premigrated          6                    6442450944
+    transferring         4                    4294967296
     @endverbatim
 
     The corresponding class is @ref InfoJobsCommand.
@@ -77,6 +92,7 @@ void InfoJobsCommand::printUsage()
 void InfoJobsCommand::doCommand(int argc, char **argv)
 {
     long reqOfInterest;
+    LTFSDmProtocol::LTFSDmInfoJobsRequest::GroupBy group;
 
     processOptions(argc, argv);
 
@@ -88,6 +104,24 @@ void InfoJobsCommand::doCommand(int argc, char **argv)
     } else if (requestNumber < Const::UNSET) {
         printUsage();
         THROW(Error::GENERAL_ERROR);
+    } else if (tapeList.size() > 1) {
+        MSG(LTFSDMC0113E);
+        printUsage();
+        THROW(Error::GENERAL_ERROR);
+    }
+
+    if (groupBy.compare("") == 0) {
+        group = LTFSDmProtocol::LTFSDmInfoJobsRequest::NONE;
+    } else if (groupBy.compare("state") == 0) {
+        group = LTFSDmProtocol::LTFSDmInfoJobsRequest::STATE;
+    } else if (groupBy.compare("tape") == 0) {
+        group = LTFSDmProtocol::LTFSDmInfoJobsRequest::TAPE;
+    } else if (groupBy.compare("pool") == 0) {
+        group = LTFSDmProtocol::LTFSDmInfoJobsRequest::POOL;
+    } else {
+        MSG(LTFSDMC0112E);
+        printUsage();
+        THROW(Error::GENERAL_ERROR);
     }
 
     reqOfInterest = requestNumber;
@@ -104,6 +138,14 @@ void InfoJobsCommand::doCommand(int argc, char **argv)
 
     infojobs->set_key(key);
     infojobs->set_reqnumber(reqOfInterest);
+    infojobs->set_operation(operationName);
+    infojobs->set_state(stateName);
+    infojobs->set_tapeid(tapeList.size() > 0 ? tapeList.front() : "");
+    infojobs->set_pool(poolNames);
+    infojobs->set_pathprefix(pathPrefix);
+    infojobs->set_limit(limit);
+    infojobs->set_offset(offset);
+    infojobs->set_groupby(group);
 
     try {
         commCommand.send();
@@ -112,8 +154,22 @@ void InfoJobsCommand::doCommand(int argc, char **argv)
         THROW(Error::GENERAL_ERROR);
     }
 
-    INFO(LTFSDMC0062I);
+    switch (group) {
+        case LTFSDmProtocol::LTFSDmInfoJobsRequest::STATE:
+            INFO(LTFSDMC0114I);
+            break;
+        case LTFSDmProtocol::LTFSDmInfoJobsRequest::TAPE:
+            INFO(LTFSDMC0115I);
+            break;
+        case LTFSDmProtocol::LTFSDmInfoJobsRequest::POOL:
+            INFO(LTFSDMC0116I);
+            break;
+        default:
+            INFO(LTFSDMC0062I);
+    }
+
     int recnum;
+    bool summary;
 
     do {
         try {
@@ -132,11 +188,21 @@ void InfoJobsCommand::doCommand(int argc, char **argv)
         unsigned long size = infojobsresp.filesize();
         std::string tapeid = infojobsresp.tapeid();
         std::string state = FsObj::migStateStr(infojobsresp.state());
-        if (recnum != Const::UNSET)
+        // summary lines are not bound to a request number
+        summary = infojobsresp.has_count();
+        if (summary) {
+            if (group == LTFSDmProtocol::LTFSDmInfoJobsRequest::STATE)
+                INFO(LTFSDMC0117I, state, infojobsresp.count(), size);
+            else if (group == LTFSDmProtocol::LTFSDmInfoJobsRequest::TAPE)
+                INFO(LTFSDMC0117I, tapeid, infojobsresp.count(), size);
+            else
+                INFO(LTFSDMC0117I, pool, infojobsresp.count(), size);
+        } else if (recnum != Const::UNSET) {
             INFO(LTFSDMC0063I, operation, state, recnum, pool, tapeid, size,
                     filename);
+        }
 
-    } while (!exitClient && recnum != Const::UNSET);
+    } while (!exitClient && (summary || recnum != Const::UNSET));
 
     return;
 }
@@ -25,7 +25,7 @@ private:
     }
 public:
     InfoJobsCommand() :
-            LTFSDMCommand("jobs", ":+hn:")
+            LTFSDMCommand("jobs", ":+hn:o:s:t:P:d:l:O:g:")
     {
     }
     ~InfoJobsCommand()
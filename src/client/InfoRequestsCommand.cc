@@ -42,6 +42,12 @@
     parameters | description
     ---|---
     -n \<request number\> | request number for a specific request to see the information
+    -o \<operation\> | only requests of a certain operation (e.g. selective recall)
+    -s \<state\> | only requests in a certain state (new, in progress, or completed)
+    -t \<tape id\> | only requests for a certain cartridge
+    -P \<pool\> | only requests for a certain tape storage pool
+    -l \<limit\> | at most the specified number of requests
+    -O \<offset\> | skip the specified number of requests, ordered by the request number
 
     Example:
 
@@ -73,6 +79,10 @@ void InfoRequestsCommand::doCommand(int argc, char **argv)
     } else if (requestNumber < Const::UNSET) {
         printUsage();
         THROW(Error::GENERAL_ERROR);
+    } else if (tapeList.size() > 1) {
+        MSG(LTFSDMC0113E);
+        printUsage();
+        THROW(Error::GENERAL_ERROR);
     }
 
     reqOfInterest = requestNumber;
@@ -89,6 +99,12 @@ void InfoRequestsCommand::doCommand(int argc, char **argv)
 
     inforeqs->set_key(key);
     inforeqs->set_reqnumber(reqOfInterest);
+    inforeqs->set_operation(operationName);
+    inforeqs->set_state(stateName);
+    inforeqs->set_tapeid(tapeList.size() > 0 ? tapeList.front() : "");
+    inforeqs->set_pool(poolNames);
+    inforeqs->set_limit(limit);
+    inforeqs->set_offset(offset);
 
     try {
         commCommand.send();
@@ -25,7 +25,7 @@ private:
     }
 public:
     InfoRequestsCommand() :
-            LTFSDMCommand("requests", ":+hn:")
+            LTFSDMCommand("requests", ":+hn:o:s:t:P:l:O:")
     {
     }
     ~InfoRequestsCommand()
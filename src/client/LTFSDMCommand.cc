@@ -93,6 +93,34 @@ void LTFSDMCommand::processOptions(int argc, char **argv)
             case 'C':
                 check = true;
                 break;
+            case 'o':
+                operationName = optarg;
+                break;
+            case 's':
+                stateName = optarg;
+                break;
+            case 'd':
+                pathPrefix = optarg;
+                break;
+            case 'l':
+                limit = strtol(optarg, NULL, 0);
+                if (limit < 0) {
+                    MSG(LTFSDMC0111E);
+                    printUsage();
+                    THROW(Error::GENERAL_ERROR);
+                }
+                break;
+            case 'O':
+                offset = strtol(optarg, NULL, 0);
+                if (offset < 0) {
+                    MSG(LTFSDMC0111E);
+                    printUsage();
+                    THROW(Error::GENERAL_ERROR);
+                }
+                break;
+            case 'g':
+                groupBy = optarg;
+                break;
             case ':':
                 INFO(LTFSDMC0014E);
                 printUsage();
@@ -110,6 +138,8 @@ void LTFSDMCommand::traceParms()
 {
     TRACE(Trace::normal, preMigrate, recToResident, requestNumber, poolNames,
             fileList, command, optionStr, key);
+    TRACE(Trace::normal, operationName, stateName, pathPrefix, limit, offset,
+            groupBy);
 }
 
 void LTFSDMCommand::getRequestNumber()
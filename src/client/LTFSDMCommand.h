@@ -39,6 +39,12 @@
  -x                    | indicates a forced operation
  -F                    | format a cartridge when added to a tape storage pool
  -C                    | check a cartridge when added to a tape storage pool
+ -o @<operation@>      | restrict a listing to a certain operation
+ -s @<state@>          | restrict a listing to a certain state
+ -d @<path prefix@>    | restrict a listing to file names starting with a prefix
+ -l @<limit@>          | the maximum number of entries of a listing
+ -O @<offset@>         | the number of entries of a listing to skip
+ -g @<column@>         | summarize a listing per state, tape, or pool
 
  The LTFSDMCommand::checkOptions method checks if the number
  of arguments is correct and the request number is not set.
@@ -126,7 +132,8 @@ protected:
                     Const::UNSET), fileList(""), command(command_), optionStr(
                     optionStr_), fsName(""), mountPoint(""), startTime(
                     time(NULL)), poolNames(""), tapeList( { }), forced(false), format(
-                    false), check(false), key(Const::UNSET), commCommand(
+                    false), check(false), operationName(""), stateName(""), pathPrefix(
+                    ""), limit(0), offset(0), groupBy(""), key(Const::UNSET), commCommand(
                     Const::CLIENT_SOCKET_FILE), resident(0), transferred(0), premigrated(
                     0), migrated(0), failed(0), not_all_exist(false)
     {
@@ -146,6 +153,12 @@ protected:
     bool forced;
     bool format;
     bool check;
+    std::string operationName;
+    std::string stateName;
+    std::string pathPrefix;
+    long limit;
+    long offset;
+    std::string groupBy;
     long key;
     LTFSDmCommClient commCommand;
     long resident;
@@ -0,0 +1,159 @@
+/*******************************************************************************
+ * Copyright 2018 IBM Corp. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *******************************************************************************/
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/resource.h>
+
+#include <string>
+#include <set>
+#include <vector>
+#include <list>
+#include <sstream>
+#include <exception>
+
+#include "src/common/errors.h"
+#include "src/common/LTFSDMException.h"
+#include "src/common/util.h"
+#include "src/common/Message.h"
+#include "src/common/Trace.h"
+
+#include "src/communication/ltfsdm.pb.h"
+#include "src/communication/LTFSDmComm.h"
+
+#include "LTFSDMCommand.h"
+#include "PoolLimitCommand.h"
+
+/** @page ltfsdm_pool_limit ltfsdm pool limit
+    The ltfsdm pool limit command sets the number of drives that are
+    reserved for and that can be used at most by migrations to or recalls
+    from a tape storage pool.
+
+    <tt>@LTFSDMC0108I</tt>
+
+    parameters | description
+    ---|---
+    -P \<pool name\> | pool name of the tape storage pool
+    migration\|recall | the operation the limits apply to
+    \<min. drives\> | number of drives that are kept available for the operation
+    \<max. drives\> | maximum number of drives used by the operation, 0 for no limit
+
+    Setting both numbers to 0 removes the limits. The limits are enforced
+    by the Scheduler (see @ref scheduler).
+
+    Example:
+
+    @verbatim
+    [root@visp ~]# ltfsdm pool limit -P pool1 recall 1 0
+    Drive limits for recall of tape storage pool "pool1" successfully set.
+    [root@visp ~]# ltfsdm pool limit -P pool1 migration 0 2
+    Drive limits for migration of tape storage pool "pool1" successfully set.
+    @endverbatim
+
+    The corresponding class is @ref PoolLimitCommand.
+ */
+
+void PoolLimitCommand::printUsage()
+{
+    INFO(LTFSDMC0108I);
+}
+
+void PoolLimitCommand::doCommand(int argc, char **argv)
+{
+    std::string operation;
+    int minDrives;
+    int maxDrives;
+    int error;
+
+    if (argc <= 2) {
+        printUsage();
+        THROW(Error::GENERAL_ERROR);
+    }
+
+    processOptions(argc, argv);
+
+    if (argc != optind + 3 || poolNames.compare("") == 0) {
+        printUsage();
+        THROW(Error::GENERAL_ERROR);
+    }
+
+    operation = argv[optind];
+
+    try {
+        minDrives = std::stoi(argv[optind + 1]);
+        maxDrives = std::stoi(argv[optind + 2]);
+    } catch (const std::exception& e) {
+        printUsage();
+        THROW(Error::GENERAL_ERROR);
+    }
+
+    if ((operation.compare("migration") != 0
+            && operation.compare("recall") != 0) || minDrives < 0
+            || maxDrives < 0 || (maxDrives > 0 && minDrives > maxDrives)) {
+        MSG(LTFSDMX0088E, poolNames, operation, minDrives, maxDrives);
+        THROW(Error::GENERAL_ERROR);
+    }
+
+    try {
+        connect();
+    } catch (const std::exception& e) {
+        MSG(LTFSDMC0026E);
+        THROW(Error::GENERAL_ERROR);
+    }
+
+    LTFSDmProtocol::LTFSDmPoolLimitRequest *poollimitreq =
+            commCommand.mutable_poollimitrequest();
+    poollimitreq->set_key(key);
+    poollimitreq->set_poolname(poolNames);
+    poollimitreq->set_operation(operation);
+    poollimitreq->set_mindrives(minDrives);
+    poollimitreq->set_maxdrives(maxDrives);
+
+    try {
+        commCommand.send();
+    } catch (const std::exception& e) {
+        MSG(LTFSDMC0027E);
+        THROW(Error::GENERAL_ERROR);
+    }
+
+    try {
+        commCommand.recv();
+    } catch (const std::exception& e) {
+        MSG(LTFSDMC0028E);
+        THROW(Error::GENERAL_ERROR);
+    }
+
+    const LTFSDmProtocol::LTFSDmPoolResp poolresp = commCommand.poolresp();
+
+    error = poolresp.response();
+
+    switch (error) {
+        case static_cast<long>(Error::OK):
+            INFO(LTFSDMC0109I, operation, poolNames);
+            break;
+        case static_cast<long>(Error::POOL_NOT_EXISTS):
+            MSG(LTFSDMX0025E, poolNames);
+            break;
+        case static_cast<long>(Error::WRONG_DRIVE_LIMITS):
+            MSG(LTFSDMX0088E, poolNames, operation, minDrives, maxDrives);
+            break;
+        default:
+            MSG(LTFSDMC0110E, poolNames);
+    }
+
+    if (error != static_cast<long>(Error::OK))
+        THROW(Error::GENERAL_ERROR);
+}
@@ -56,6 +56,7 @@
 #include "PoolDeleteCommand.h"
 #include "PoolAddCommand.h"
 #include "PoolRemoveCommand.h"
+#include "PoolLimitCommand.h"
 #include "InfoPoolsCommand.h"
 #include "RetrieveCommand.h"
 #include "VersionCommand.h"
@@ -278,6 +279,9 @@ int main(int argc, char *argv[])
         } else if (PoolRemoveCommand().compare(command)) {
             ltfsdmCommand = std::unique_ptr<LTFSDMCommand>(
                     new PoolRemoveCommand);
+        } else if (PoolLimitCommand().compare(command)) {
+            ltfsdmCommand = std::unique_ptr<LTFSDMCommand>(
+                    new PoolLimitCommand);
         } else {
             MSG(LTFSDMC0012E, command.c_str());
             ltfsdmCommand = std::unique_ptr<LTFSDMCommand>(new HelpCommand);
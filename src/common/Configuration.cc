@@ -99,6 +99,13 @@ void Configuration::write()
             conffiletmp << std::endl;
         }
 
+        for (std::pair<limitkey_t, drive_limits> limit : drvlimits) {
+            conffiletmp << "dlim: " << encode(limit.first.first) << " "
+                    << driveOpName(static_cast<drive_op>(limit.first.second))
+                    << " " << limit.second.minDrives << " "
+                    << limit.second.maxDrives << std::endl;
+        }
+
         for (std::pair<std::string, fsinfo> fs : fslist) {
             conffiletmp << "fsys: " << encode(fs.first) << " "
                     << fs.second.source << " " << fs.second.fstype << " "
@@ -117,6 +124,9 @@ void Configuration::read()
     std::fstream conffile(Const::CONFIG_FILE);
     std::map<std::string, std::set<std::string>> stgplisttmp;
     std::map<std::string, fsinfo> fslisttmp;
+    std::map<limitkey_t, drive_limits> drvlimitstmp;
+    drive_limits limits;
+    drive_op op;
     std::string line;
     std::string poolName;
     std::string fsName;
@@ -161,6 +171,18 @@ void Configuration::read()
             if (std::getline(liness, token, ' '))
                 THROW(Error::CONFIG_FORMAT_ERROR);
             fslisttmp[fsName] = finfo;
+        } else if (token.compare("dlim:") == 0) {
+            if (!std::getline(liness, token, ' '))
+                THROW(Error::CONFIG_FORMAT_ERROR);
+            poolName = decode(token);
+            if (!std::getline(liness, token, ' '))
+                THROW(Error::CONFIG_FORMAT_ERROR);
+            op = driveOp(token);
+            if (!(liness >> limits.minDrives >> limits.maxDrives))
+                THROW(Error::CONFIG_FORMAT_ERROR);
+            if (std::getline(liness, token, ' '))
+                THROW(Error::CONFIG_FORMAT_ERROR);
+            drvlimitstmp[std::make_pair(poolName, op)] = limits;
         } else {
             THROW(Error::CONFIG_FORMAT_ERROR);
         }
@@ -168,6 +190,7 @@ void Configuration::read()
 
     stgplist = stgplisttmp;
     fslist = fslisttmp;
+    drvlimits = drvlimitstmp;
 }
 
 void Configuration::poolCreate(std::string poolName)
@@ -198,6 +221,9 @@ void Configuration::poolDelete(std::string poolName)
 
     stgplist.erase(it);
 
+    drvlimits.erase(std::make_pair(poolName, MIGRATION_DRIVES));
+    drvlimits.erase(std::make_pair(poolName, RECALL_DRIVES));
+
     write();
 }
 
@@ -265,6 +291,58 @@ std::set<std::string> Configuration::getPools()
     return poolnames;
 }
 
+void Configuration::poolSetLimits(std::string poolName, drive_op op,
+        drive_limits limits)
+
+{
+    std::lock_guard<std::recursive_mutex> lock(mtx);
+
+    if (stgplist.find(poolName) == stgplist.end())
+        THROW(Error::CONFIG_POOL_NOT_EXISTS);
+
+    if (limits.minDrives < 0 || limits.maxDrives < 0
+            || (limits.maxDrives > 0 && limits.minDrives > limits.maxDrives))
+        THROW(Error::WRONG_DRIVE_LIMITS);
+
+    // no reservation and no maximum: remove the limits
+    if (limits.minDrives == 0 && limits.maxDrives == 0)
+        drvlimits.erase(std::make_pair(poolName, op));
+    else
+        drvlimits[std::make_pair(poolName, op)] = limits;
+
+    write();
+}
+
+std::map<Configuration::limitkey_t, Configuration::drive_limits> Configuration::getDriveLimits()
+
+{
+    std::lock_guard<std::recursive_mutex> lock(mtx);
+
+    return drvlimits;
+}
+
+std::string Configuration::driveOpName(drive_op op)
+
+{
+    switch (op) {
+        case MIGRATION_DRIVES:
+            return "migration";
+        default:
+            return "recall";
+    }
+}
+
+Configuration::drive_op Configuration::driveOp(std::string name)
+
+{
+    if (name.compare("migration") == 0)
+        return MIGRATION_DRIVES;
+    else if (name.compare("recall") == 0)
+        return RECALL_DRIVES;
+
+    THROW(Error::WRONG_DRIVE_LIMITS);
+}
+
 void Configuration::addFs(FileSystems::fsinfo newfs)
 
 {
@@ -18,6 +18,17 @@
 
 class Configuration
 {
+public:
+    enum drive_op
+    {
+        MIGRATION_DRIVES, RECALL_DRIVES
+    };
+    struct drive_limits
+    {
+        int minDrives;
+        int maxDrives;
+    };
+    typedef std::pair<std::string, int> limitkey_t;
 private:
     struct fsinfo
     {
@@ -28,6 +39,7 @@ private:
     };
     std::map<std::string, std::set<std::string>> stgplist;
     std::map<std::string, fsinfo> fslist;
+    std::map<limitkey_t, drive_limits> drvlimits;
     void write();
     std::recursive_mutex mtx;
 
@@ -42,6 +54,10 @@ public:
     void poolRemove(std::string poolName, std::string tapeId);
     std::set<std::string> getPool(std::string poolName);
     std::set<std::string> getPools();
+    void poolSetLimits(std::string poolName, drive_op op, drive_limits limits);
+    std::map<limitkey_t, drive_limits> getDriveLimits();
+    static std::string driveOpName(drive_op op);
+    static drive_op driveOp(std::string name);
 
     void addFs(FileSystems::fsinfo newfs);
     FileSystems::fsinfo getFs(std::string target);
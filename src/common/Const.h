@@ -43,6 +43,11 @@ const int MAX_PREMIG_THREADS = 16;
 const int MAX_TRANSPARENT_RECALL_THREADS = 8192;
 const std::chrono::seconds IDLE_THREAD_LIVE_TIME(10);
 const int MAX_OBJECTS_SEND = 100000;
+const int DB_BATCH_SIZE = 1000;
+const int DB_BATCH_INTERVAL = 10;
+const int DB_BATCH_SHARDS = 16;
+const int JOB_STORE_SHARDS = 16;
+const int DB_READ_BUSY_TIMEOUT = 1000;
 const int MAX_FUSE_BACKGROUND = 256 * 1024;
 const struct rlimit NOFILE_LIMIT = (struct rlimit ) { 1024 * 1024, 1024 * 1024 };
 const struct rlimit NPROC_LIMIT = (struct rlimit ) { 16 * 1024 * 1024, 16 * 1024
@@ -55,8 +60,14 @@ const std::string DMAPI_ATTR_MIG = "LTFSDMMIG";
 const std::string DMAPI_ATTR_FS = "LTFSDMFS";
 const std::string LTFS_ATTR = "user.FILE_PATH";
 const std::string LTFS_START_BLOCK = "user.ltfs.startblock";
-const int READ_BUFFER_SIZE = 512 * 1024;
+const std::string LTFS_CONTAINER_INDEX = "user.ltfsdm.index";
+const unsigned long TRANSFER_SIZE = 8 * 1024 * 1024;
+const unsigned long READ_AHEAD_SIZE = 256 * 1024 * 1024;
+const unsigned long READ_AHEAD_FILE_SIZE = 64 * 1024 * 1024;
 const long UPDATE_SIZE = 200 * 1024 * 1024;
+const long CHANGE_CHECK_SIZE = 64 * 1024 * 1024;
+const long CONTAINER_SIZE = 1024L * 1024 * 1024;
+const unsigned long MIN_MIG_SESSION_SIZE = 64UL * 1024 * 1024 * 1024;
 const int maxReplica = 3;
 const int tapeIdLength = 8;
 const std::string DMAPI_TERMINATION_MESSAGE = "termination message";
@@ -73,6 +84,13 @@ const std::string TMP_DIR_TEMPLATE = "/tmp/ltfsdm.XXXXXX";
 const std::string LTFSLE_HOST = "127.0.0.1";
 const unsigned short int LTFSLE_PORT = 7600;
 const int WAIT_TAPE_MOUNT = 60;
+const int MOUNT_TIME_ESTIMATE = 90;
+const int UNMOUNT_TIME_ESTIMATE = 60;
+const int BULK_RECALL_WINDOW = 60;
+const int BULK_RECALL_EVENTS = 16;
+const int RECALL_HISTORY_HALF_LIFE = 3600;
+const double PREMOUNT_MIN_SCORE = 4;
+const double PREMOUNT_SCORE_RATIO = 4;
 const int STARTUP_TIMEOUT = 720;
 const int COMMAND_PARTIALLY_FAILED = 1;
 const int COMMAND_FAILED = 2;
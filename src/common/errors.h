@@ -48,6 +48,7 @@ enum class Error
     FS_IN_FSTAB = 1026,
     FS_UNMOUNT = 1027,
     POOL_TOO_SMALL = 1028,
+    WRONG_DRIVE_LIMITS = 1029,
 
     ALREADY_FORMATTED = 1050,
     WRITE_PROTECTED = 1051,
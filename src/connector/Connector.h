@@ -133,6 +133,10 @@
     added | Workaround only used for the dmapi connector.
     copies | The number of tapes the data has been copied.
     tapeInfo | The tape ID and the starting block number of all tapes the data has been copied to.
+container | For each entry of tapeInfo the id of the container the data has been aggregated into and the offset of the data within it. An id of zero means the data has been written to a file of its own (see @ref tape_container "TapeContainer").
+
+    The container component has been appended to the end of the attribute.
+    Attributes written before are shorter and are read with a zero id.
 
     ### The migration state attribute
     The migration state attribute provides the information about the
@@ -209,6 +213,7 @@ public:
         bool toresident;
         fuid_t fuid;
         std::string filename;
+        pid_t pid;
     };
     static std::atomic<bool> connectorTerminate;
     static std::atomic<bool> forcedTerminate;
@@ -284,6 +289,11 @@ public:
             char tapeId[Const::tapeIdLength + 1];
             long startBlock;
         } tapeInfo[Const::maxReplica];
+        struct
+        {
+            unsigned long id;
+            long offset;
+        } container[Const::maxReplica];
     };
     //! [migration target attribute]
     enum file_state
@@ -340,7 +350,9 @@ public:
     void unlock();
     long read(long offset, unsigned long size, char *buffer);
     long write(long offset, unsigned long size, char *buffer);
-    void addTapeAttr(std::string tapeId, long startBlock);
+    int getFileDescriptor();
+    void addTapeAttr(std::string tapeId, long startBlock,
+            unsigned long containerId, long containerOffset);
     void remAttribute();
     mig_target_attr_t getAttribute();
     void preparePremigration();
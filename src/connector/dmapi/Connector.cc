@@ -866,7 +866,15 @@ long FsObj::write(long offset, unsigned long size, char *buffer)
 	return wsize;
 }
 
-void FsObj::addTapeAttr(std::string tapeId, long startBlock)
+int FsObj::getFileDescriptor()
+
+{
+	// data only is accessible by the DMAPI handle
+	return Const::UNSET;
+}
+
+void FsObj::addTapeAttr(std::string tapeId, long startBlock,
+        unsigned long containerId, long containerOffset)
 
 {
     int rc;
@@ -881,6 +889,8 @@ void FsObj::addTapeAttr(std::string tapeId, long startBlock)
     memset(attr.tapeInfo[attr.copies].tapeId, 0, Const::tapeIdLength + 1);
     strncpy(attr.tapeInfo[attr.copies].tapeId, tapeId.c_str(), Const::tapeIdLength);
     attr.tapeInfo[attr.copies].startBlock = startBlock;
+    attr.container[attr.copies].id = containerId;
+    attr.container[attr.copies].offset = containerOffset;
     TRACE(Trace::always, attr.tapeInfo[attr.copies].startBlock);
     attr.copies++;
 
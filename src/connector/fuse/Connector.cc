@@ -390,9 +390,10 @@ Connector::rec_info_t Connector::getEvents()
                     (unsigned int) request.igen(),
                     (unsigned long) request.inum() };
     recinfo.filename = request.filename();
+    recinfo.pid = request.pid();
 
     TRACE(Trace::always, recinfo.filename, recinfo.fuid.inum,
-            recinfo.toresident);
+            recinfo.toresident, recinfo.pid);
 
     return recinfo;
 }
@@ -358,7 +358,16 @@ long FsObj::write(long offset, unsigned long size, char *buffer)
     return wsize;
 }
 
-void FsObj::addTapeAttr(std::string tapeId, long startBlock)
+int FsObj::getFileDescriptor()
+
+{
+    FuseFS::FuseHandle *fh = (FuseFS::FuseHandle *) handle;
+
+    return fh->fd;
+}
+
+void FsObj::addTapeAttr(std::string tapeId, long startBlock,
+        unsigned long containerId, long containerOffset)
 
 {
     FsObj::mig_target_attr_t attr;
@@ -370,6 +379,8 @@ void FsObj::addTapeAttr(std::string tapeId, long startBlock)
     strncpy(attr.tapeInfo[attr.copies].tapeId, tapeId.c_str(),
             Const::tapeIdLength);
     attr.tapeInfo[attr.copies].startBlock = startBlock;
+    attr.container[attr.copies].id = containerId;
+    attr.container[attr.copies].offset = containerOffset;
     attr.copies++;
 
     if (fsetxattr(fh->fd, Const::LTFSDM_EA_MIGINFO.c_str(), (void *) &attr,
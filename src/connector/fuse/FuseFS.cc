@@ -338,6 +338,7 @@ int FuseFS::recall_file(FuseFS::ltfsdm_file_info *linfo, bool toresident)
     recrequest->set_igen(igen);
     recrequest->set_inum(statbuf.st_ino);
     recrequest->set_filename(path);
+    recrequest->set_pid(fc->pid);
 
     try {
         recRequest.send();
@@ -0,0 +1,48 @@
+/*******************************************************************************
+ * Copyright 2018 IBM Corp. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *******************************************************************************/
+#include "ServerIncludes.h"
+
+char *BufferPool::get()
+
+{
+    char *buffer;
+
+    std::lock_guard<std::mutex> lock(mtx);
+
+    if (freeBuffers.size() > 0) {
+        buffer = freeBuffers.front();
+        freeBuffers.pop_front();
+        return buffer;
+    }
+
+    // callers do not wait for buffers to be returned
+    if (buffers.size() == maxBuffers)
+        return nullptr;
+
+    buffers.push_back(std::unique_ptr<char[]>(new char[bufferSize]));
+    TRACE(Trace::full, buffers.size(), bufferSize);
+
+    return buffers.back().get();
+}
+
+void BufferPool::put(char *buffer)
+
+{
+    std::lock_guard<std::mutex> lock(mtx);
+
+    freeBuffers.push_back(buffer);
+}
@@ -0,0 +1,1026 @@
+/*******************************************************************************
+ * Copyright 2018 IBM Corp. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *******************************************************************************/
+#include "ServerIncludes.h"
+
+/*
+ * The jobs are kept in memory only (see @ref job_store). The job id
+ * consists of the request number (upper 32 bits) and the index of the
+ * job within its request (lower 32 bits).
+ */
+
+void ColumnJobStore::ColumnBatch::setState(std::function<void()> failed,
+        long jobId, FsObj::file_state from, FsObj::file_state to)
+
+{
+    store->changeJob(jobId, 1U << from, to);
+}
+
+void ColumnJobStore::ColumnBatch::setRecalled(std::function<void()> failed,
+        long jobId, FsObj::file_state to)
+
+{
+    store->changeJob(jobId, RECALLING, to);
+}
+
+void ColumnJobStore::ColumnBatch::assignTape(long jobId, std::string tapeId,
+        FsObj::file_state from, FsObj::file_state to)
+
+{
+    std::shared_ptr<reqjobs_t> req = store->getRequest(jobId >> 32);
+    chunk_t *chunk;
+    long pos;
+
+    if (!req)
+        return;
+
+    std::lock_guard<std::mutex> lock(req->mtx);
+
+    if (locate(req.get(), jobId, &chunk, &pos)
+            && ColumnJobStore::setState(chunk, pos, 1U << from, to))
+        chunk->tape[pos] = getIndex(req->tapes, tapeId, true);
+}
+
+size_t ColumnJobStore::hashFuid(const fuid_t& fuid)
+
+{
+    std::hash<unsigned long> hash;
+
+    return hash(fuid.fsid_h) ^ (hash(fuid.fsid_l) << 1)
+            ^ (hash(fuid.igen) << 2) ^ (hash(fuid.inum) << 3);
+}
+
+std::string ColumnJobStore::getName(chunk_t *chunk, long pos)
+
+{
+    unsigned int start = (pos == 0 ? 0 : chunk->nameEnd[pos - 1]);
+
+    return chunk->names.substr(start, chunk->nameEnd[pos] - start);
+}
+
+unsigned int ColumnJobStore::getIndex(std::vector<std::string>& table,
+        const std::string& value, bool add)
+
+{
+    for (unsigned int i = 0; i < table.size(); i++)
+        if (table[i].compare(value) == 0)
+            return i;
+
+    if (add == false)
+        return NO_TAPE;
+
+    table.push_back(value);
+    return table.size() - 1;
+}
+
+bool ColumnJobStore::locate(reqjobs_t *req, long jobId, chunk_t **chunk,
+        long *pos)
+
+{
+    long local = (jobId & 0xffffffffL) - req->base;
+
+    if (local < 0 || local >= req->numJobs.load(std::memory_order_acquire))
+        return false;
+
+    *chunk = req->chunks.load(std::memory_order_acquire)[local >> CHUNK_BITS];
+    *pos = local & (CHUNK_SIZE - 1);
+
+    return true;
+}
+
+bool ColumnJobStore::setState(chunk_t *chunk, long pos, unsigned int from,
+        unsigned char to)
+
+{
+    unsigned char state = chunk->state[pos].load();
+
+    /*
+     * The counter of the new state is incremented before and the one of
+     * the previous state decremented after the state changed. Therefore
+     * a chunk with a counter of zero does not contain a job in that state.
+     */
+    chunk->numInState[to]++;
+
+    do {
+        if ((from & (1U << state)) == 0) {
+            chunk->numInState[to]--;
+            return false;
+        }
+    } while (!chunk->state[pos].compare_exchange_weak(state, to));
+
+    chunk->numInState[state]--;
+
+    return true;
+}
+
+long ColumnJobStore::getJobs(reqjobs_t *req, chunk_t ***chunks)
+
+{
+    long num = req->numJobs.load(std::memory_order_acquire);
+
+    *chunks = req->chunks.load(std::memory_order_acquire);
+
+    return num;
+}
+
+template<typename F> bool ColumnJobStore::scanChunk(chunk_t *chunk, long num,
+        int state, F process)
+
+{
+    unsigned char cur;
+
+    if (state != Const::UNSET && chunk->numInState[state] == 0)
+        return true;
+
+    for (long pos = 0; pos < num; pos++) {
+        cur = chunk->state[pos].load(std::memory_order_relaxed);
+        if (cur == DELETED || (state != Const::UNSET && cur != state))
+            continue;
+        if (process(pos) == false)
+            return false;
+    }
+
+    return true;
+}
+
+template<typename F> void ColumnJobStore::scan(reqjobs_t *req, int state,
+        F process)
+
+{
+    chunk_t **chunks;
+    long num = getJobs(req, &chunks);
+
+    for (long start = 0; start < num; start += CHUNK_SIZE) {
+        chunk_t *chunk = chunks[start >> CHUNK_BITS];
+        if (scanChunk(chunk, std::min(num - start, (long) CHUNK_SIZE), state,
+                [chunk, start, &process](long pos) {
+                    return process(chunk, pos, start + pos);
+                }) == false)
+            return;
+    }
+}
+
+std::shared_ptr<ColumnJobStore::reqjobs_t> ColumnJobStore::getRequest(
+        int reqNum)
+
+{
+    shard_t& shard = shards[(unsigned int) reqNum % Const::JOB_STORE_SHARDS];
+    std::lock_guard<std::mutex> lock(shard.mtx);
+    auto it = shard.requests.find(reqNum);
+
+    if (it == shard.requests.end())
+        return nullptr;
+
+    return it->second;
+}
+
+std::map<int, std::shared_ptr<ColumnJobStore::reqjobs_t>> ColumnJobStore::getRequests()
+
+{
+    std::map<int, std::shared_ptr<reqjobs_t>> requests;
+
+    for (shard_t& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard.mtx);
+        requests.insert(shard.requests.begin(), shard.requests.end());
+    }
+
+    return requests;
+}
+
+bool ColumnJobStore::exists(index_t& index, size_t hash, const job_t& job,
+        bool byFuid)
+
+{
+    auto range = index.jobs.equal_range(hash);
+    std::shared_ptr<reqjobs_t> req;
+    chunk_t *chunk;
+    long pos;
+
+    for (auto it = range.first; it != range.second; ++it) {
+        if (!(req = getRequest(it->second >> 32)))
+            continue;
+        std::lock_guard<std::mutex> lock(req->mtx);
+        if (locate(req.get(), it->second, &chunk, &pos) == false
+                || chunk->state[pos] == DELETED
+                || chunk->replNum[pos] != job.replNum)
+            continue;
+        if (byFuid) {
+            if (chunk->fsidH[pos] == job.fuid.fsid_h
+                    && chunk->fsidL[pos] == job.fuid.fsid_l
+                    && chunk->igen[pos] == job.fuid.igen
+                    && chunk->inum[pos] == job.fuid.inum)
+                return true;
+        } else if (getName(chunk, pos).compare(job.fileName) == 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+long ColumnJobStore::append(const job_t& job)
+
+{
+    shard_t& shard =
+            shards[(unsigned int) job.reqNum % Const::JOB_STORE_SHARDS];
+    std::shared_ptr<reqjobs_t> req;
+    chunk_t **chunks;
+    chunk_t *chunk;
+    long local;
+    long pos;
+
+    while (true) {
+        {
+            std::lock_guard<std::mutex> lock(shard.mtx);
+            std::shared_ptr<reqjobs_t>& entry = shard.requests[job.reqNum];
+            if (!entry) {
+                auto it = shard.bases.find(job.reqNum);
+                if (it == shard.bases.end()) {
+                    entry = std::make_shared<reqjobs_t>(job.op, 0);
+                } else {
+                    entry = std::make_shared<reqjobs_t>(job.op, it->second);
+                    shard.bases.erase(it);
+                }
+            }
+            req = entry;
+        }
+        req->mtx.lock();
+        // removed meanwhile by deleteRecalled or deleteJobs
+        if (req->removed == false)
+            break;
+        req->mtx.unlock();
+    }
+
+    std::lock_guard<std::mutex> lock(req->mtx, std::adopt_lock);
+
+    local = req->numJobs.load(std::memory_order_relaxed);
+    pos = local & (CHUNK_SIZE - 1);
+    chunks = req->chunks.load(std::memory_order_relaxed);
+
+    /*
+     * Readers load the number of jobs before the chunk directory. A new
+     * directory and a new chunk therefore are published before the number
+     * of jobs is incremented. Previous directories are kept since readers
+     * may still use them.
+     */
+    if (pos == 0) {
+        if ((local >> CHUNK_BITS) == req->capacity) {
+            long capacity = std::max(2 * req->capacity, 16L);
+            chunk_t **dir = new chunk_t*[capacity]();
+            std::copy(chunks, chunks + req->capacity, dir);
+            req->dirs.emplace_back(dir);
+            req->capacity = capacity;
+            req->chunks.store(dir, std::memory_order_release);
+            chunks = dir;
+        }
+        req->owned.emplace_back(new chunk_t());
+        chunks[local >> CHUNK_BITS] = req->owned.back().get();
+    }
+
+    chunk = chunks[local >> CHUNK_BITS];
+    chunk->tape[pos].store(getIndex(req->tapes, job.tapeId, true),
+            std::memory_order_relaxed);
+    chunk->targetState[pos] = job.targetState;
+    chunk->replNum[pos] = job.replNum;
+    chunk->pool[pos] = getIndex(req->pools, job.pool, true);
+    chunk->startBlock[pos] = job.startBlock;
+    chunk->fileSize[pos] = job.fileSize;
+    chunk->fsidH[pos] = job.fuid.fsid_h;
+    chunk->fsidL[pos] = job.fuid.fsid_l;
+    chunk->igen[pos] = job.fuid.igen;
+    chunk->inum[pos] = job.fuid.inum;
+    chunk->mtimeSec[pos] = job.mtimeSec;
+    chunk->mtimeNsec[pos] = job.mtimeNsec;
+    chunk->connInfo[pos] = job.connInfo;
+    chunk->names.append(job.fileName);
+    chunk->nameEnd[pos] = chunk->names.size();
+    chunk->numInState[job.state]++;
+    chunk->state[pos].store(job.state, std::memory_order_relaxed);
+
+    req->numLive++;
+    req->numJobs.store(local + 1, std::memory_order_release);
+
+    return ((long) job.reqNum << 32) | (req->base + local);
+}
+
+bool ColumnJobStore::changeJob(long jobId, unsigned int from,
+        unsigned char to)
+
+{
+    std::shared_ptr<reqjobs_t> req = getRequest(jobId >> 32);
+    chunk_t *chunk;
+    long pos;
+
+    if (!req || locate(req.get(), jobId, &chunk, &pos) == false)
+        return false;
+
+    return setState(chunk, pos, from, to);
+}
+
+void ColumnJobStore::sortView(reqjobs_t *req, unsigned int tape)
+
+{
+    view_t& view = req->views[tape];
+    chunk_t **chunks;
+    long num = getJobs(req, &chunks);
+    long sorted = view.jobs.size();
+    auto byStartBlock = [chunks](unsigned int a, unsigned int b) {
+        return chunks[a >> CHUNK_BITS]->startBlock[a & (CHUNK_SIZE - 1)]
+                < chunks[b >> CHUNK_BITS]->startBlock[b & (CHUNK_SIZE - 1)];
+    };
+
+    // only the jobs that have been added since the last call are sorted
+    for (long local = view.numJobs; local < num; local++)
+        if (chunks[local >> CHUNK_BITS]->tape[local & (CHUNK_SIZE - 1)]
+                == tape)
+            view.jobs.push_back(local);
+    view.numJobs = num;
+
+    std::stable_sort(view.jobs.begin() + sorted, view.jobs.end(),
+            byStartBlock);
+    std::inplace_merge(view.jobs.begin(), view.jobs.begin() + sorted,
+            view.jobs.end(), byStartBlock);
+}
+
+void ColumnJobStore::removeJobs(int reqNum, std::shared_ptr<reqjobs_t> req,
+        unsigned int from, unsigned int tape, bool all)
+
+{
+    shard_t& shard = shards[(unsigned int) reqNum % Const::JOB_STORE_SHARDS];
+    std::list<std::pair<size_t, long>> nameKeys;
+    std::list<std::pair<size_t, long>> fuidKeys;
+    bool unique = (req->op != DataBase::SELRECALL);
+    std::hash<std::string> hash;
+
+    {
+        std::lock_guard<std::mutex> lock(req->mtx);
+        scan(req.get(), Const::UNSET,
+                [&](chunk_t *chunk, long pos, long local) {
+                    if ((all == false && chunk->tape[pos] != tape)
+                            || setState(chunk, pos, from, DELETED) == false)
+                        return true;
+                    req->numLive--;
+                    if (unique == false)
+                        return true;
+                    long jobId = ((long) reqNum << 32) | (req->base + local);
+                    std::string name = getName(chunk, pos);
+                    if (name.compare("") != 0)
+                        nameKeys.push_back(std::make_pair(hash(name), jobId));
+                    fuidKeys.push_back(std::make_pair(hashFuid((fuid_t ) {
+                        chunk->fsidH[pos], chunk->fsidL[pos],
+                        chunk->igen[pos], chunk->inum[pos] }), jobId));
+                    return true;
+                });
+    }
+
+    for (auto key : nameKeys) {
+        index_t& index = names[key.first % Const::JOB_STORE_SHARDS];
+        std::lock_guard<std::mutex> lock(index.mtx);
+        auto range = index.jobs.equal_range(key.first);
+        for (auto it = range.first; it != range.second; ++it)
+            if (it->second == key.second) {
+                index.jobs.erase(it);
+                break;
+            }
+    }
+
+    for (auto key : fuidKeys) {
+        index_t& index = fuids[key.first % Const::JOB_STORE_SHARDS];
+        std::lock_guard<std::mutex> lock(index.mtx);
+        auto range = index.jobs.equal_range(key.first);
+        for (auto it = range.first; it != range.second; ++it)
+            if (it->second == key.second) {
+                index.jobs.erase(it);
+                break;
+            }
+    }
+
+    // the memory of a request is released with its last job
+    std::lock_guard<std::mutex> shardlock(shard.mtx);
+    std::lock_guard<std::mutex> lock(req->mtx);
+    auto it = shard.requests.find(reqNum);
+
+    if ((all || req->numLive == 0) && it != shard.requests.end()
+            && it->second == req) {
+        shard.requests.erase(it);
+        shard.bases[reqNum] = req->base + req->numJobs;
+        req->removed = true;
+    }
+}
+
+void ColumnJobStore::addJob(const job_t& job)
+
+{
+    // the same unique constraints as for the JOB_QUEUE table
+    bool unique = (job.op != DataBase::SELRECALL);
+    bool named = unique && job.fileName.compare("") != 0;
+    size_t nameHash = std::hash<std::string>()(job.fileName);
+    size_t fuidHash = hashFuid(job.fuid);
+    index_t& nameIndex = names[nameHash % Const::JOB_STORE_SHARDS];
+    index_t& fuidIndex = fuids[fuidHash % Const::JOB_STORE_SHARDS];
+    std::unique_lock<std::mutex> namelock(nameIndex.mtx, std::defer_lock);
+    std::unique_lock<std::mutex> fuidlock(fuidIndex.mtx, std::defer_lock);
+    long jobId;
+
+    if (named)
+        namelock.lock();
+
+    if (unique) {
+        fuidlock.lock();
+        if ((named && exists(nameIndex, nameHash, job, false))
+                || exists(fuidIndex, fuidHash, job, true)) {
+            TRACE(Trace::error, job.fileName, job.replNum);
+            errno = SQLITE_CONSTRAINT_UNIQUE;
+            THROW(Error::GENERAL_ERROR, job.fileName, job.replNum);
+        }
+    }
+
+    jobId = append(job);
+
+    if (named)
+        nameIndex.jobs.emplace(nameHash, jobId);
+    if (unique)
+        fuidIndex.jobs.emplace(fuidHash, jobId);
+}
+
+std::shared_ptr<JobStore::Batch> ColumnJobStore::createBatch()
+
+{
+    return std::make_shared<ColumnJobStore::ColumnBatch>(this);
+}
+
+void ColumnJobStore::failJob(long jobId)
+
+{
+    changeJob(jobId, ANY_STATE, FsObj::FAILED);
+}
+
+void ColumnJobStore::failReplicas(int reqNum, long jobId)
+
+{
+    std::shared_ptr<reqjobs_t> req = getRequest(reqNum);
+    std::list<long> candidates;
+    std::string name;
+    size_t hash;
+    chunk_t *chunk;
+    long pos;
+
+    if (!req || (jobId >> 32) != reqNum)
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(req->mtx);
+        if (locate(req.get(), jobId, &chunk, &pos) == false)
+            return;
+        name = getName(chunk, pos);
+    }
+
+    if (name.compare("") == 0)
+        return;
+
+    hash = std::hash<std::string>()(name);
+
+    {
+        index_t& index = names[hash % Const::JOB_STORE_SHARDS];
+        std::lock_guard<std::mutex> lock(index.mtx);
+        auto range = index.jobs.equal_range(hash);
+        for (auto it = range.first; it != range.second; ++it)
+            if ((it->second >> 32) == reqNum)
+                candidates.push_back(it->second);
+    }
+
+    for (long candidate : candidates) {
+        std::lock_guard<std::mutex> lock(req->mtx);
+        if (locate(req.get(), candidate, &chunk, &pos)
+                && getName(chunk, pos).compare(name) == 0)
+            setState(chunk, pos, ANY_STATE, FsObj::FAILED);
+    }
+}
+
+void ColumnJobStore::setResumeOffset(long jobId, unsigned long offset,
+        std::string tapeId)
+
+{
+    std::shared_ptr<reqjobs_t> req = getRequest(jobId >> 32);
+    chunk_t *chunk;
+    long pos;
+
+    if (!req)
+        return;
+
+    std::lock_guard<std::mutex> lock(req->mtx);
+
+    if (locate(req.get(), jobId, &chunk, &pos)) {
+        chunk->resumeOffset[pos] = offset;
+        chunk->resumeTape[pos] = getIndex(req->tapes, tapeId, true);
+    }
+}
+
+void ColumnJobStore::changeState(const std::set<int>& reqNums, int replNum,
+        std::string tapeId, FsObj::file_state from, FsObj::file_state to)
+
+{
+    std::shared_ptr<reqjobs_t> req;
+    unsigned int tape;
+
+    for (int reqNum : reqNums) {
+        if (!(req = getRequest(reqNum)))
+            continue;
+        {
+            std::lock_guard<std::mutex> lock(req->mtx);
+            tape = getIndex(req->tapes, tapeId, false);
+        }
+        if (tape == NO_TAPE)
+            continue;
+        scan(req.get(), from, [&](chunk_t *chunk, long pos, long local) {
+            if (chunk->tape[pos] == tape
+                    && (replNum == Const::UNSET
+                            || chunk->replNum[pos] == replNum))
+                setState(chunk, pos, 1U << from, to);
+            return true;
+        });
+    }
+}
+
+JobStore::unclaimed_t ColumnJobStore::unclaimed(int reqNum, int replNum,
+        FsObj::file_state state)
+
+{
+    std::shared_ptr<reqjobs_t> req = getRequest(reqNum);
+    unclaimed_t unclaimed = (unclaimed_t ) { 0, 0, 0, 0 };
+
+    if (!req)
+        return unclaimed;
+
+    scan(req.get(), state, [&](chunk_t *chunk, long pos, long local) {
+        if (chunk->replNum[pos] != replNum)
+            return true;
+        unsigned long size = chunk->fileSize[pos];
+        if (unclaimed.num == 0 || size < unclaimed.minSize)
+            unclaimed.minSize = size;
+        if (size > unclaimed.maxSize)
+            unclaimed.maxSize = size;
+        unclaimed.size += size;
+        unclaimed.num++;
+        return true;
+    });
+
+    return unclaimed;
+}
+
+void ColumnJobStore::selectUnassigned(int reqNum, int replNum,
+        FsObj::file_state state,
+        std::function<bool(long jobId, unsigned long size)> process)
+
+{
+    std::shared_ptr<reqjobs_t> req = getRequest(reqNum);
+    std::vector<std::pair<unsigned long, long>> jobs;
+
+    if (!req)
+        return;
+
+    scan(req.get(), state, [&](chunk_t *chunk, long pos, long local) {
+        if (chunk->replNum[pos] == replNum)
+            jobs.push_back(std::make_pair(chunk->fileSize[pos],
+                            ((long) reqNum << 32) | (req->base + local)));
+        return true;
+    });
+
+    // largest files first
+    std::stable_sort(jobs.begin(), jobs.end(),
+            [](const std::pair<unsigned long, long>& a,
+                    const std::pair<unsigned long, long>& b) {
+                return a.first > b.first;
+            });
+
+    for (std::pair<unsigned long, long> job : jobs)
+        if (process(job.second, job.first) == false)
+            break;
+}
+
+void ColumnJobStore::selectMigJobs(int reqNum, std::string tapeId,
+        FsObj::file_state state, std::function<bool(const mig_job_t&)> process)
+
+{
+    std::shared_ptr<reqjobs_t> req = getRequest(reqNum);
+    std::list<mig_job_t> jobs;
+    unsigned int tape;
+    chunk_t **chunks;
+    long num;
+
+    if (!req)
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(req->mtx);
+        tape = getIndex(req->tapes, tapeId, false);
+    }
+    if (tape == NO_TAPE)
+        return;
+
+    num = getJobs(req.get(), &chunks);
+
+    // the lock is only held while the jobs of a single chunk are copied
+    for (long start = 0; start < num; start += CHUNK_SIZE) {
+        chunk_t *chunk = chunks[start >> CHUNK_BITS];
+        {
+            std::lock_guard<std::mutex> lock(req->mtx);
+            scanChunk(chunk, std::min(num - start, (long) CHUNK_SIZE), state,
+                    [&](long pos) {
+                        if (chunk->tape[pos] != tape)
+                            return true;
+                        mig_job_t job;
+                        job.jobId = ((long) reqNum << 32)
+                                | (req->base + start + pos);
+                        job.fileName = getName(chunk, pos);
+                        job.mtimeSec = chunk->mtimeSec[pos];
+                        job.mtimeNsec = chunk->mtimeNsec[pos];
+                        job.inum = chunk->inum[pos];
+                        job.resumeOffset = chunk->resumeOffset[pos];
+                        job.resumeTapeId = req->tapes[chunk->resumeTape[pos]];
+                        jobs.push_back(job);
+                        return true;
+                    });
+        }
+        for (const mig_job_t& job : jobs)
+            if (process(job) == false)
+                return;
+        jobs.clear();
+    }
+}
+
+void ColumnJobStore::selectRecallJobs(const std::set<int>& reqNums,
+        std::string tapeId, std::function<bool(const rec_job_t&)> process)
+
+{
+    struct ref_t
+    {
+        long startBlock;
+        reqjobs_t *req;
+        int reqNum;
+        unsigned int tape;
+        unsigned int local;
+    };
+    std::list<std::shared_ptr<reqjobs_t>> reqs;
+    std::vector<ref_t> refs;
+    std::shared_ptr<reqjobs_t> req;
+    unsigned int tape;
+    chunk_t *chunk;
+    long pos;
+    long sorted;
+
+    for (int reqNum : reqNums) {
+        if (!(req = getRequest(reqNum)))
+            continue;
+        reqs.push_back(req);
+        std::lock_guard<std::mutex> lock(req->mtx);
+        if ((tape = getIndex(req->tapes, tapeId, false)) == NO_TAPE)
+            continue;
+        sortView(req.get(), tape);
+        sorted = refs.size();
+        for (unsigned int local : req->views[tape].jobs) {
+            chunk = req->chunks.load()[local >> CHUNK_BITS];
+            pos = local & (CHUNK_SIZE - 1);
+            if ((RECALLING & (1U << chunk->state[pos])) != 0)
+                refs.push_back((ref_t ) { chunk->startBlock[pos], req.get(),
+                                reqNum, tape, local });
+        }
+        std::inplace_merge(refs.begin(), refs.begin() + sorted, refs.end(),
+                [](const ref_t& a, const ref_t& b) {
+                    return a.startBlock < b.startBlock;
+                });
+    }
+
+    for (const ref_t& ref : refs) {
+        rec_job_t job;
+        {
+            std::lock_guard<std::mutex> lock(ref.req->mtx);
+            chunk = ref.req->chunks.load()[ref.local >> CHUNK_BITS];
+            pos = ref.local & (CHUNK_SIZE - 1);
+            job.state = static_cast<FsObj::file_state>(chunk->state[pos].load());
+            if ((RECALLING & (1U << job.state)) == 0
+                    || chunk->tape[pos] != ref.tape)
+                continue;
+            job.op = ref.req->op;
+            job.reqNum = ref.reqNum;
+            job.jobId = ((long) ref.reqNum << 32)
+                    | (ref.req->base + ref.local);
+            job.fuid = (fuid_t ) { chunk->fsidH[pos], chunk->fsidL[pos],
+                            chunk->igen[pos], chunk->inum[pos] };
+            job.fileName = getName(chunk, pos);
+            job.targetState =
+                    static_cast<FsObj::file_state>(chunk->targetState[pos]);
+            job.connInfo = chunk->connInfo[pos];
+        }
+        if (process(job) == false)
+            return;
+    }
+}
+
+void ColumnJobStore::selectTransRecalls(
+        std::function<bool(const rec_job_t&)> process)
+
+{
+    std::list<rec_job_t> jobs;
+    chunk_t **chunks;
+    long num;
+
+    for (auto entry : getRequests()) {
+        reqjobs_t *req = entry.second.get();
+        if (req->op != DataBase::TRARECALL)
+            continue;
+        num = getJobs(req, &chunks);
+        for (long start = 0; start < num; start += CHUNK_SIZE) {
+            chunk_t *chunk = chunks[start >> CHUNK_BITS];
+            {
+                std::lock_guard<std::mutex> lock(req->mtx);
+                scanChunk(chunk, std::min(num - start, (long) CHUNK_SIZE),
+                        Const::UNSET, [&](long pos) {
+                            rec_job_t job;
+                            job.op = req->op;
+                            job.reqNum = entry.first;
+                            job.jobId = ((long) entry.first << 32)
+                                    | (req->base + start + pos);
+                            job.fuid = (fuid_t ) { chunk->fsidH[pos],
+                                            chunk->fsidL[pos], chunk->igen[pos],
+                                            chunk->inum[pos] };
+                            job.fileName = getName(chunk, pos);
+                            job.state = static_cast<FsObj::file_state>(
+                                    chunk->state[pos].load());
+                            job.targetState = static_cast<FsObj::file_state>(
+                                    chunk->targetState[pos]);
+                            job.connInfo = chunk->connInfo[pos];
+                            jobs.push_back(job);
+                            return true;
+                        });
+            }
+            for (const rec_job_t& job : jobs)
+                if (process(job) == false)
+                    return;
+            jobs.clear();
+        }
+    }
+}
+
+void ColumnJobStore::info(const info_filter_t& filter,
+        std::function<bool(const info_t&)> process)
+
+{
+    std::map<int, std::shared_ptr<reqjobs_t>> requests;
+    std::map<std::pair<int, std::string>, std::pair<long, unsigned long>> groups;
+    std::list<info_t> infos;
+    long skipped = 0;
+    long count = 0;
+    bool done = false;
+    info_t info;
+
+    if (filter.reqNum == Const::UNSET)
+        requests = getRequests();
+    else if (std::shared_ptr<reqjobs_t> req = getRequest(filter.reqNum))
+        requests[filter.reqNum] = req;
+
+    // the same order as for the JOB_ID of the JOB_QUEUE table
+    for (auto entry : requests) {
+        reqjobs_t *req = entry.second.get();
+        unsigned int tape = NO_TAPE;
+        unsigned int pool = NO_TAPE;
+        std::vector<std::pair<long, unsigned long>> local;
+        chunk_t **chunks;
+        long num;
+
+        if (done)
+            break;
+
+        if (filter.byOperation && filter.operations.count(req->op) == 0)
+            continue;
+
+        {
+            std::lock_guard<std::mutex> lock(req->mtx);
+            if (filter.tapeId.size() > 0
+                    && (tape = getIndex(req->tapes, filter.tapeId, false))
+                            == NO_TAPE)
+                continue;
+            if (filter.pool.size() > 0
+                    && (pool = getIndex(req->pools, filter.pool, false))
+                            == NO_TAPE)
+                continue;
+        }
+
+        num = getJobs(req, &chunks);
+
+        for (long start = 0; start < num && done == false; start +=
+                CHUNK_SIZE) {
+            chunk_t *chunk = chunks[start >> CHUNK_BITS];
+            std::unique_lock<std::mutex> lock(req->mtx);
+            local.resize(
+                    std::max(req->tapes.size(), req->pools.size())
+                            + NUM_STATES);
+            scanChunk(chunk, std::min(num - start, (long) CHUNK_SIZE),
+                    Const::UNSET, [&](long pos) {
+                        unsigned int key = chunk->state[pos];
+                        if ((filter.byState && filter.states.count(key) == 0)
+                                || (tape != NO_TAPE && chunk->tape[pos] != tape)
+                                || (pool != NO_TAPE && chunk->pool[pos] != pool)
+                                || (filter.pathPrefix.size() > 0
+                                        && getName(chunk, pos).compare(0,
+                                                filter.pathPrefix.size(),
+                                                filter.pathPrefix) != 0))
+                            return true;
+                        switch (filter.groupBy) {
+                            case JobStore::GROUP_STATE:
+                                break;
+                            case JobStore::GROUP_TAPE:
+                                key = chunk->tape[pos];
+                                break;
+                            case JobStore::GROUP_POOL:
+                                key = chunk->pool[pos];
+                                break;
+                            default:
+                                if (skipped < filter.offset) {
+                                    skipped++;
+                                    return true;
+                                }
+                                info.op = req->op;
+                                info.fileName = getName(chunk, pos);
+                                info.reqNum = entry.first;
+                                info.pool = req->pools[chunk->pool[pos]];
+                                info.fileSize = chunk->fileSize[pos];
+                                info.tapeId = req->tapes[chunk->tape[pos]];
+                                info.state =
+                                        static_cast<FsObj::file_state>(key);
+                                info.count = 1;
+                                infos.push_back(info);
+                                if (filter.limit > 0
+                                        && ++count >= filter.limit) {
+                                    done = true;
+                                    return false;
+                                }
+                                return true;
+                        }
+                        local[key].first++;
+                        local[key].second += chunk->fileSize[pos];
+                        return true;
+                    });
+            lock.unlock();
+
+            // the lock is not held while the jobs are sent
+            for (const info_t& job : infos)
+                if (process(job) == false) {
+                    done = true;
+                    break;
+                }
+            infos.clear();
+        }
+
+        if (filter.groupBy == JobStore::NO_GROUP)
+            continue;
+
+        std::lock_guard<std::mutex> lock(req->mtx);
+        for (unsigned int i = 0; i < local.size(); i++) {
+            if (local[i].first == 0)
+                continue;
+            std::pair<long, unsigned long>& group =
+                    (filter.groupBy == JobStore::GROUP_STATE ?
+                            groups[std::make_pair(i, "")] :
+                            groups[std::make_pair(0,
+                                    filter.groupBy == JobStore::GROUP_TAPE ?
+                                            req->tapes[i] : req->pools[i])]);
+            group.first += local[i].first;
+            group.second += local[i].second;
+        }
+    }
+
+    if (filter.groupBy == JobStore::NO_GROUP)
+        return;
+
+    // the grouped column is returned within the corresponding field
+    for (auto group : groups) {
+        if (skipped++ < filter.offset)
+            continue;
+        if (filter.limit > 0 && count++ >= filter.limit)
+            break;
+        info.op = DataBase::NOOP;
+        info.fileName = "";
+        info.reqNum = filter.reqNum;
+        info.state = static_cast<FsObj::file_state>(Const::UNSET);
+        info.tapeId = "";
+        info.pool = "";
+        if (filter.groupBy == JobStore::GROUP_STATE)
+            info.state = static_cast<FsObj::file_state>(group.first.first);
+        else if (filter.groupBy == JobStore::GROUP_TAPE)
+            info.tapeId = group.first.second;
+        else
+            info.pool = group.first.second;
+        info.count = group.second.first;
+        info.fileSize = group.second.second;
+        if (process(info) == false)
+            break;
+    }
+}
+
+std::set<std::string> ColumnJobStore::getTapes(int reqNum)
+
+{
+    std::shared_ptr<reqjobs_t> req = getRequest(reqNum);
+    std::set<unsigned int> indexes;
+    std::set<std::string> tapes;
+
+    if (!req)
+        return tapes;
+
+    std::lock_guard<std::mutex> lock(req->mtx);
+
+    scan(req.get(), Const::UNSET, [&](chunk_t *chunk, long pos, long local) {
+        indexes.insert(chunk->tape[pos]);
+        return true;
+    });
+
+    for (unsigned int index : indexes)
+        tapes.insert(req->tapes[index]);
+
+    return tapes;
+}
+
+int ColumnJobStore::countJobs(int reqNum, std::string tapeId, int state)
+
+{
+    std::shared_ptr<reqjobs_t> req = getRequest(reqNum);
+    unsigned int tape;
+    int num = 0;
+
+    if (!req)
+        return 0;
+
+    {
+        std::lock_guard<std::mutex> lock(req->mtx);
+        tape = getIndex(req->tapes, tapeId, false);
+    }
+    if (tape == NO_TAPE)
+        return 0;
+
+    scan(req.get(), state, [&](chunk_t *chunk, long pos, long local) {
+        if (chunk->tape[pos] == tape)
+            num++;
+        return true;
+    });
+
+    return num;
+}
+
+std::map<FsObj::file_state, int> ColumnJobStore::countStates(int reqNum)
+
+{
+    std::shared_ptr<reqjobs_t> req = getRequest(reqNum);
+    std::map<FsObj::file_state, int> states;
+
+    if (!req)
+        return states;
+
+    scan(req.get(), Const::UNSET, [&](chunk_t *chunk, long pos, long local) {
+        states[static_cast<FsObj::file_state>(chunk->state[pos].load())]++;
+        return true;
+    });
+
+    return states;
+}
+
+void ColumnJobStore::deleteRecalled(const std::set<int>& reqNums,
+        std::string tapeId)
+
+{
+    std::shared_ptr<reqjobs_t> req;
+    unsigned int tape;
+
+    for (int reqNum : reqNums) {
+        if (!(req = getRequest(reqNum)))
+            continue;
+        {
+            std::lock_guard<std::mutex> lock(req->mtx);
+            tape = getIndex(req->tapes, tapeId, false);
+        }
+        if (tape != NO_TAPE)
+            removeJobs(reqNum, req, RECALLING, tape, false);
+    }
+}
+
+void ColumnJobStore::deleteJobs(int reqNum)
+
+{
+    std::shared_ptr<reqjobs_t> req = getRequest(reqNum);
+
+    if (req)
+        removeJobs(reqNum, req, ANY_STATE, NO_TAPE, true);
+}
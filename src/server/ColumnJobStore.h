@@ -0,0 +1,167 @@
+/*******************************************************************************
+ * Copyright 2018 IBM Corp. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *******************************************************************************/
+#pragma once
+
+class ColumnJobStore: public JobStore
+{
+private:
+    static const int CHUNK_BITS = 10;
+    static const long CHUNK_SIZE = 1L << CHUNK_BITS;
+    static const int NUM_STATES = FsObj::RECALLING_PREMIG + 1;
+    // state of deleted jobs
+    static const unsigned char DELETED = NUM_STATES;
+    static const unsigned int ANY_STATE = (1U << NUM_STATES) - 1;
+    static const unsigned int RECALLING = (1U << FsObj::RECALLING_MIG)
+            | (1U << FsObj::RECALLING_PREMIG);
+    static const unsigned int NO_TAPE = UINT_MAX;
+
+    // the columns of CHUNK_SIZE jobs of a request
+    struct chunk_t
+    {
+        std::atomic<unsigned char> state[CHUNK_SIZE];
+        std::atomic<unsigned int> tape[CHUNK_SIZE];
+        unsigned char targetState[CHUNK_SIZE];
+        signed char replNum[CHUNK_SIZE];
+        unsigned char pool[CHUNK_SIZE];
+        long startBlock[CHUNK_SIZE];
+        unsigned long fileSize[CHUNK_SIZE];
+        unsigned long fsidH[CHUNK_SIZE];
+        unsigned long fsidL[CHUNK_SIZE];
+        unsigned int igen[CHUNK_SIZE];
+        unsigned long inum[CHUNK_SIZE];
+        long mtimeSec[CHUNK_SIZE];
+        long mtimeNsec[CHUNK_SIZE];
+        std::intptr_t connInfo[CHUNK_SIZE];
+        std::atomic<unsigned long> resumeOffset[CHUNK_SIZE];
+        std::atomic<unsigned int> resumeTape[CHUNK_SIZE];
+        unsigned int nameEnd[CHUNK_SIZE];
+        std::string names;
+        // not less than the number of jobs in each state (incl. DELETED)
+        std::atomic<int> numInState[NUM_STATES + 1];
+    };
+    // jobs of a cartridge sorted by their start block
+    struct view_t
+    {
+        long numJobs;
+        std::vector<unsigned int> jobs;
+    };
+    struct reqjobs_t
+    {
+        reqjobs_t(DataBase::operation op_, long base_) :
+                op(op_), base(base_), removed(false), numJobs(0), numLive(0),
+                capacity(0), chunks(nullptr), tapes(1, ""), pools(1, "")
+        {
+        }
+        std::mutex mtx;
+        DataBase::operation op;
+        long base;
+        bool removed;
+        std::atomic<long> numJobs;
+        std::atomic<long> numLive;
+        long capacity;
+        std::atomic<chunk_t**> chunks;
+        std::list<std::unique_ptr<chunk_t*[]>> dirs;
+        std::list<std::unique_ptr<chunk_t>> owned;
+        std::vector<std::string> tapes;
+        std::vector<std::string> pools;
+        std::map<unsigned int, view_t> views;
+    };
+    struct shard_t
+    {
+        std::mutex mtx;
+        std::unordered_map<int, std::shared_ptr<reqjobs_t>> requests;
+        // next job index of requests that have been removed
+        std::unordered_map<int, long> bases;
+    };
+    struct index_t
+    {
+        std::mutex mtx;
+        std::unordered_multimap<size_t, long> jobs;
+    };
+
+    class ColumnBatch: public JobStore::Batch
+    {
+    private:
+        ColumnJobStore *store;
+    public:
+        ColumnBatch(ColumnJobStore *store_) :
+                store(store_)
+        {
+        }
+        void setState(std::function<void()> failed, long jobId,
+                FsObj::file_state from, FsObj::file_state to);
+        void setRecalled(std::function<void()> failed, long jobId,
+                FsObj::file_state to);
+        void assignTape(long jobId, std::string tapeId,
+                FsObj::file_state from, FsObj::file_state to);
+        void flush()
+        {
+        }
+    };
+
+    shard_t shards[Const::JOB_STORE_SHARDS];
+    index_t names[Const::JOB_STORE_SHARDS];
+    index_t fuids[Const::JOB_STORE_SHARDS];
+
+    static size_t hashFuid(const fuid_t& fuid);
+    static std::string getName(chunk_t *chunk, long pos);
+    static unsigned int getIndex(std::vector<std::string>& table,
+            const std::string& value, bool add);
+    static bool locate(reqjobs_t *req, long jobId, chunk_t **chunk,
+            long *pos);
+    static bool setState(chunk_t *chunk, long pos, unsigned int from,
+            unsigned char to);
+    static long getJobs(reqjobs_t *req, chunk_t ***chunks);
+    template<typename F> static bool scanChunk(chunk_t *chunk, long num,
+            int state, F process);
+    template<typename F> static void scan(reqjobs_t *req, int state,
+            F process);
+    std::shared_ptr<reqjobs_t> getRequest(int reqNum);
+    std::map<int, std::shared_ptr<reqjobs_t>> getRequests();
+    bool exists(index_t& index, size_t hash, const job_t& job, bool byFuid);
+    long append(const job_t& job);
+    bool changeJob(long jobId, unsigned int from, unsigned char to);
+    void sortView(reqjobs_t *req, unsigned int tape);
+    void removeJobs(int reqNum, std::shared_ptr<reqjobs_t> req,
+            unsigned int from, unsigned int tape, bool all);
+public:
+    ColumnJobStore()
+    {
+    }
+    void addJob(const job_t& job);
+    std::shared_ptr<Batch> createBatch();
+    void failJob(long jobId);
+    void failReplicas(int reqNum, long jobId);
+    void setResumeOffset(long jobId, unsigned long offset, std::string tapeId);
+    void changeState(const std::set<int>& reqNums, int replNum,
+            std::string tapeId, FsObj::file_state from, FsObj::file_state to);
+    unclaimed_t unclaimed(int reqNum, int replNum, FsObj::file_state state);
+    void selectUnassigned(int reqNum, int replNum, FsObj::file_state state,
+            std::function<bool(long jobId, unsigned long size)> process);
+    void selectMigJobs(int reqNum, std::string tapeId, FsObj::file_state state,
+            std::function<bool(const mig_job_t&)> process);
+    void selectRecallJobs(const std::set<int>& reqNums, std::string tapeId,
+            std::function<bool(const rec_job_t&)> process);
+    void selectTransRecalls(std::function<bool(const rec_job_t&)> process);
+    void info(const info_filter_t& filter,
+            std::function<bool(const info_t&)> process);
+    std::set<std::string> getTapes(int reqNum);
+    int countJobs(int reqNum, std::string tapeId, int state);
+    std::map<FsObj::file_state, int> countStates(int reqNum);
+    void deleteRecalled(const std::set<int>& reqNums, std::string tapeId);
+    void deleteJobs(int reqNum);
+};
@@ -18,11 +18,19 @@
 
 DataBase DB;
 
-std::mutex DataBase::trans_mutex;
+std::recursive_mutex DataBase::trans_mutex;
 
 DataBase::~DataBase()
 
 {
+    for (std::pair<const std::string, std::list<sqlite3_stmt*>>& entry :
+            stmtCache)
+        for (sqlite3_stmt *stmt : entry.second)
+            sqlite3_finalize(stmt);
+
+    if (rodb != NULL)
+        sqlite3_close(rodb);
+
     if (dbNeedsClosed)
         sqlite3_close(db);
 
@@ -34,38 +42,22 @@ void DataBase::cleanup()
 {
     unlink(Const::DB_FILE.c_str());
     unlink((Const::DB_FILE + "-journal").c_str());
+    unlink((Const::DB_FILE + "-wal").c_str());
+    unlink((Const::DB_FILE + "-shm").c_str());
 }
 
-void DataBase::fits(sqlite3_context *ctx, int argc, sqlite3_value **argv)
-
-{
-    assert(argc == 5);
-
-    unsigned long size = sqlite3_value_int64(argv[1]);
-    unsigned long *free = (unsigned long *) sqlite3_value_int64(argv[2]);
-    unsigned long *num_found = (unsigned long *) sqlite3_value_int64(argv[3]);
-    unsigned long *total = (unsigned long *) sqlite3_value_int64(argv[4]);
-
-    if (*free >= size) {
-        *free -= size;
-        (*total)++;
-        (*num_found)++;
-        sqlite3_result_int(ctx, 1);
-    } else {
-        (*total)++;
-        sqlite3_result_int(ctx, 0);
-    }
-}
-
-void DataBase::open(bool dbUseMemory)
+void DataBase::open(bool dbUseMemory, std::string dbFile)
 
 {
     int rc;
     std::string sql;
     std::string uri;
+    SQLStatement stmt;
 
     if (dbUseMemory)
         uri = "file::memory:";
+    else if (dbFile.compare("") != 0)
+        uri = std::string("file:") + dbFile;
     else
         uri = std::string("file:") + Const::DB_FILE;
 
@@ -105,8 +97,57 @@ void DataBase::open(bool dbUseMemory)
 
     dbNeedsClosed = true;
 
-    sqlite3_create_function(db, "FITS", 5, SQLITE_UTF8, NULL, &DataBase::fits,
-    NULL, NULL);
+    if (dbUseMemory == false) {
+        stmt(DataBase::JOURNAL_MODE_WAL);
+        stmt.doall();
+    }
+
+    if (dbUseMemory == false && dbFile.compare("") != 0) {
+        /*
+         * A persistent job store is kept across restarts of the backend.
+         * With a write ahead log a commit only appends to the log and with
+         * synchronous=NORMAL it is synced at checkpoints only: a power loss
+         * may lose the last transactions but never corrupts the database.
+         */
+        persistent = true;
+
+        stmt(DataBase::SYNCHRONOUS_NORMAL);
+        stmt.doall();
+    }
+
+    openReadConnection(uri, dbUseMemory);
+}
+
+void DataBase::openReadConnection(std::string uri, bool dbUseMemory)
+
+{
+    int rc;
+    SQLReadStatement stmt;
+
+    /*
+     * For a database file the read-only connection has its own cache
+     * and reads a snapshot of the write ahead log. An in-memory database
+     * only can be shared by a shared cache: without read_uncommitted the
+     * table locks of a reading statement would block the writers.
+     */
+    rc = sqlite3_open_v2(uri.c_str(), &rodb, SQLITE_OPEN_READONLY |
+    SQLITE_OPEN_FULLMUTEX |
+    (dbUseMemory ? SQLITE_OPEN_SHAREDCACHE : SQLITE_OPEN_PRIVATECACHE), NULL);
+
+    if (rc != SQLITE_OK) {
+        TRACE(Trace::error, rc, uri);
+        sqlite3_close(rodb);
+        rodb = NULL;
+        errno = rc;
+        THROW(Error::GENERAL_ERROR, uri, rc);
+    }
+
+    sqlite3_busy_timeout(rodb, Const::DB_READ_BUSY_TIMEOUT);
+
+    if (dbUseMemory) {
+        stmt(DataBase::READ_UNCOMMITTED);
+        stmt.doall();
+    }
 }
 
 void DataBase::createTables()
@@ -119,6 +160,78 @@ void DataBase::createTables()
 
     stmt(DataBase::CREATE_REQUEST_QUEUE);
     stmt.doall();
+
+    stmt(DataBase::CREATE_JOB_DIRS);
+    stmt.doall();
+
+    stmt(DataBase::CREATE_JOB_LIST);
+    stmt.doall();
+
+    stmt(DataBase::CREATE_JOB_LIST_INSERT);
+    stmt.doall();
+
+    stmt(DataBase::CREATE_JOB_QUEUE_DELETE);
+    stmt.doall();
+
+    stmt(DataBase::CREATE_JOB_QUEUE_TAPE_INDEX);
+    stmt.doall();
+
+    stmt(DataBase::CREATE_JOB_QUEUE_REPL_INDEX);
+    stmt.doall();
+
+    checkQueryPlans();
+}
+
+void DataBase::checkQueryPlans()
+
+{
+    SQLStatement stmt;
+    int id;
+    int parent;
+    int notused;
+    std::string detail;
+
+    for (std::pair<std::string, const std::string*> indexed : INDEXED_STATEMENTS) {
+        // passed as C string since the statement must not be escaped
+        stmt(DataBase::QUERY_PLAN) << toParameters(*indexed.second).c_str();
+        stmt.prepare();
+        while (stmt.step(&id, &parent, &notused, &detail)) {
+            TRACE(Trace::full, indexed.first, detail);
+            if (detail.compare(0, 5, "SCAN ") == 0)
+                TRACE(Trace::normal, indexed.first, detail);
+        }
+        stmt.finalize();
+    }
+}
+
+std::string DataBase::toParameters(const std::string& fmtstr)
+
+{
+    std::string sql;
+    unsigned long pos;
+    unsigned long end;
+
+    // replace %n% and '%n%' by the parameter ?n
+    for (pos = 0; pos < fmtstr.size(); pos++) {
+        if (fmtstr[pos] != '%'
+                || (end = fmtstr.find('%', pos + 1)) == std::string::npos
+                || end == pos + 1
+                || fmtstr.find_first_not_of("0123456789", pos + 1) != end) {
+            sql += fmtstr[pos];
+            continue;
+        }
+        if (pos > 0 && fmtstr[pos - 1] == '\''
+                && fmtstr.compare(end + 1, 1, "'") == 0) {
+            sql.pop_back();
+            sql += "?" + fmtstr.substr(pos + 1, end - pos - 1);
+            pos = end + 1;
+        } else {
+            sql += "?" + fmtstr.substr(pos + 1, end - pos - 1);
+            pos = end;
+        }
+    }
+
+    return sql;
 }
 
 std::string DataBase::opStr(DataBase::operation op)
@@ -167,6 +280,50 @@ int DataBase::lastUpdates()
     return sqlite3_changes(db);
 }
 
+sqlite3_stmt *DataBase::getStatement(const std::string& fmtstr)
+
+{
+    std::string sql;
+    sqlite3_stmt *stmt;
+    int rc;
+
+    {
+        std::lock_guard<std::mutex> lock(cachemtx);
+        std::list<sqlite3_stmt*>& stmts = stmtCache[fmtstr];
+
+        if (stmts.empty() == false) {
+            stmt = stmts.front();
+            stmts.pop_front();
+            return stmt;
+        }
+    }
+
+    sql = toParameters(fmtstr);
+
+    rc = sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, NULL);
+
+    if (rc != SQLITE_OK) {
+        TRACE(Trace::error, sql, rc);
+        errno = rc;
+        THROW(Error::GENERAL_ERROR, rc);
+    }
+
+    TRACE(Trace::normal, sql);
+
+    return stmt;
+}
+
+void DataBase::putStatement(const std::string& fmtstr, sqlite3_stmt *stmt)
+
+{
+    std::lock_guard<std::mutex> lock(cachemtx);
+
+    sqlite3_reset(stmt);
+    sqlite3_clear_bindings(stmt);
+
+    stmtCache[fmtstr].push_back(stmt);
+}
+
 SQLStatement& SQLStatement::operator()(std::string _fmtstr)
 
 {
@@ -187,53 +344,36 @@ void SQLStatement::prepare()
 {
     int rc;
 
-    rc = sqlite3_prepare_v2(DB.getDB(), fmt.str().c_str(), -1, &stmt, NULL);
+    rc = sqlite3_prepare_v2(readOnly ? DB.getReadDB() : DB.getDB(),
+            fmt.str().c_str(), -1, &stmt, NULL);
 
     if (rc != SQLITE_OK) {
         TRACE(Trace::error, fmt.str(), rc);
         errno = rc;
         THROW(Error::GENERAL_ERROR, rc);
     }
-}
-
-std::string SQLStatement::encode(std::string s)
-
-{
-    std::string enc;
 
-    for (char c : s) {
-        switch (c) {
-            case 0047:
-                enc += "\\0047";
-                break;
-            case 0134:
-                enc += "\\0134";
-                break;
-            default:
-                enc += c;
-        }
+    // changes are serialized with the transactions (see SQLTransaction)
+    if (readOnly == false && locked == false
+            && sqlite3_stmt_readonly(stmt) == 0) {
+        DataBase::trans_mutex.lock();
+        locked = true;
     }
-
-    return enc;
 }
 
-std::string SQLStatement::decode(std::string s)
+// within an SQL string literal a single quote is written twice
+std::string SQLStatement::escape(std::string s)
 
 {
-    unsigned long pos = s.size();
+    std::string esc;
 
-    while ((pos = s.rfind("\\", pos)) != std::string::npos) {
-        if (s.compare(pos, 5, "\\0047") == 0) {
-            s.replace(pos, 5, std::string(1, 0047));
-        } else if (s.compare(pos, 5, "\\0134") == 0) {
-            s.replace(pos, 5, std::string(1, 0134));
-        } else {
-            THROW(Error::GENERAL_ERROR, s);
-        }
-        pos--;
+    for (char c : s) {
+        if (c == '\'')
+            esc += c;
+        esc += c;
     }
 
-    return s;
+    return esc;
 }
 
 void SQLStatement::getColumn(int *result, int column)
@@ -293,7 +433,7 @@ void SQLStatement::getColumn(std::string *result, int column)
     const char *column_ctr = reinterpret_cast<const char*>(sqlite3_column_text(
             stmt, column));
     if (column_ctr != NULL)
-        *result = decode(std::string(column_ctr));
+        *result = std::string(column_ctr);
     else
         *result = "";
 }
@@ -341,6 +481,14 @@ void SQLStatement::bind(int num, std::string value)
 void SQLStatement::finalize()
 
 {
+    std::unique_lock<std::recursive_mutex> lock;
+
+    if (locked) {
+        lock = std::unique_lock<std::recursive_mutex>(DataBase::trans_mutex,
+                std::adopt_lock);
+        locked = false;
+    }
+
     if (stmt_rc != SQLITE_ROW && stmt_rc != SQLITE_DONE) {
         TRACE(Trace::error, fmt.str(), stmt_rc);
         errno = stmt_rc;
@@ -363,3 +511,247 @@ void SQLStatement::doall()
     step();
     finalize();
 }
+
+SQLCachedStatement::SQLCachedStatement(const std::string& _fmtstr) :
+        fmtstr(_fmtstr), stmt(DB.getStatement(_fmtstr))
+
+{
+}
+
+SQLCachedStatement::~SQLCachedStatement()
+
+{
+    DB.putStatement(fmtstr, stmt);
+}
+
+void SQLCachedStatement::bindValue(int num, int value)
+
+{
+    int rc;
+
+    if ((rc = sqlite3_bind_int(stmt, num, value)) != SQLITE_OK) {
+        TRACE(Trace::error, fmtstr, num, rc);
+        errno = rc;
+        THROW(Error::GENERAL_ERROR, rc);
+    }
+}
+
+void SQLCachedStatement::bindValue(int num, unsigned int value)
+
+{
+    bindValue(num, static_cast<int>(value));
+}
+
+void SQLCachedStatement::bindValue(int num, long value)
+
+{
+    int rc;
+
+    if ((rc = sqlite3_bind_int64(stmt, num, value)) != SQLITE_OK) {
+        TRACE(Trace::error, fmtstr, num, rc);
+        errno = rc;
+        THROW(Error::GENERAL_ERROR, rc);
+    }
+}
+
+// convert unsigned to signed since there is unsigned in SQLite
+void SQLCachedStatement::bindValue(int num, unsigned long value)
+
+{
+    bindValue(num, static_cast<long>(value));
+}
+
+void SQLCachedStatement::bindValue(int num, long long value)
+
+{
+    bindValue(num, static_cast<long>(value));
+}
+
+void SQLCachedStatement::bindValue(int num, unsigned long long value)
+
+{
+    bindValue(num, static_cast<long>(value));
+}
+
+void SQLCachedStatement::bindValue(int num, const std::string& value)
+
+{
+    int rc;
+
+    if ((rc = sqlite3_bind_text(stmt, num, value.c_str(), value.size(),
+            SQLITE_TRANSIENT)) != SQLITE_OK) {
+        TRACE(Trace::error, fmtstr, num, rc);
+        errno = rc;
+        THROW(Error::GENERAL_ERROR, rc);
+    }
+}
+
+void SQLCachedStatement::bindValue(int num, const char *value)
+
+{
+    int rc;
+
+    if (value == nullptr)
+        rc = sqlite3_bind_null(stmt, num);
+    else
+        rc = sqlite3_bind_text(stmt, num, value, -1, SQLITE_TRANSIENT);
+
+    if (rc != SQLITE_OK) {
+        TRACE(Trace::error, fmtstr, num, rc);
+        errno = rc;
+        THROW(Error::GENERAL_ERROR, rc);
+    }
+}
+
+SQLTransaction::SQLTransaction() :
+        lock(DataBase::trans_mutex)
+
+{
+    SQLCachedStatement(DataBase::BEGIN_TRANSACTION).exec();
+}
+
+SQLTransaction::~SQLTransaction()
+
+{
+    if (std::uncaught_exception()) {
+        rollback();
+        return;
+    }
+
+    try {
+        commit();
+    } catch (const std::exception& e) {
+        TRACE(Trace::error, e.what());
+    }
+}
+
+void SQLTransaction::commit()
+
+{
+    if (lock.owns_lock() == false)
+        return;
+
+    try {
+        SQLCachedStatement(DataBase::COMMIT_TRANSACTION).exec();
+    } catch (const std::exception& e) {
+        TRACE(Trace::error, e.what());
+        rollback();
+        throw;
+    }
+
+    lock.unlock();
+}
+
+void SQLTransaction::rollback()
+
+{
+    if (lock.owns_lock() == false)
+        return;
+
+    // SQLite already may have rolled back the transaction by itself
+    try {
+        SQLCachedStatement(DataBase::ROLLBACK_TRANSACTION).exec();
+    } catch (const std::exception& e) {
+        TRACE(Trace::error, e.what());
+    }
+
+    lock.unlock();
+}
+
+SQLBatchStatement::~SQLBatchStatement()
+
+{
+    try {
+        flush();
+    } catch (const std::exception& e) {
+        TRACE(Trace::error, e.what());
+    }
+}
+
+void SQLBatchStatement::execPending()
+
+{
+    std::vector<entry_t> batch;
+    std::vector<entry_t> failed;
+    int lost = 0;
+
+    for (shard_t& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard.mtx);
+
+        batch.insert(batch.end(),
+                std::make_move_iterator(shard.pending.begin()),
+                std::make_move_iterator(shard.pending.end()));
+        shard.pending.clear();
+    }
+    numPending -= batch.size();
+    lastExec = time(NULL);
+
+    if (batch.size() == 0)
+        return;
+
+    TRACE(Trace::normal, fmtstr, batch.size());
+
+    /*
+     * Other threads cannot change the database while the transaction is
+     * open (DataBase::trans_mutex). If it is rolled back only the
+     * statements of this batch are reverted and all of them are retried.
+     */
+    try {
+        SQLTransaction trans;
+        SQLCachedStatement stmt(fmtstr);
+
+        for (entry_t& entry : batch) {
+            try {
+                entry.exec(stmt);
+            } catch (const std::exception& e) {
+                TRACE(Trace::error, e.what());
+                failed.push_back(entry);
+            }
+        }
+
+        trans.commit();
+    } catch (const std::exception& e) {
+        // the transaction has been rolled back, including successful entries
+        TRACE(Trace::error, e.what());
+        failed = batch;
+    }
+
+    if (failed.size() == 0)
+        return;
+
+    // a second attempt for each statement without a transaction
+    SQLCachedStatement stmt(fmtstr);
+
+    for (entry_t& entry : failed) {
+        try {
+            entry.exec(stmt);
+            continue;
+        } catch (const std::exception& e) {
+            TRACE(Trace::error, e.what());
+        }
+
+        lost++;
+
+        if (entry.failed == nullptr)
+            continue;
+
+        try {
+            entry.failed();
+        } catch (const std::exception& e) {
+            TRACE(Trace::error, e.what());
+        }
+    }
+
+    TRACE(Trace::error, fmtstr, failed.size(), lost);
+
+    if (lost > 0)
+        MSG(LTFSDMS0132E, lost);
+}
+
+void SQLBatchStatement::flush()
+
+{
+    std::lock_guard<std::mutex> lock(execmtx);
+
+    execPending();
+}
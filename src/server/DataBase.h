@@ -20,11 +20,30 @@ class DataBase
 {
 private:
     sqlite3 *db;
+    sqlite3 *rodb;
     bool dbNeedsClosed;
-    static void fits(sqlite3_context *ctx, int argc, sqlite3_value **argv);
+    bool persistent;
+    std::mutex cachemtx;
+    std::unordered_map<std::string, std::list<sqlite3_stmt*>> stmtCache;
     static const std::string CREATE_JOB_QUEUE;
     static const std::string CREATE_REQUEST_QUEUE;
+    static const std::string CREATE_JOB_DIRS;
+    static const std::string CREATE_JOB_LIST;
+    static const std::string CREATE_JOB_LIST_INSERT;
+    static const std::string CREATE_JOB_QUEUE_DELETE;
+    static const std::string CREATE_JOB_QUEUE_TAPE_INDEX;
+    static const std::string CREATE_JOB_QUEUE_REPL_INDEX;
+    static const std::string QUERY_PLAN;
+    static const std::string JOURNAL_MODE_WAL;
+    static const std::string SYNCHRONOUS_NORMAL;
+    static const std::string READ_UNCOMMITTED;
+    static const std::list<std::pair<std::string, const std::string*>> INDEXED_STATEMENTS;
+
+    void openReadConnection(std::string uri, bool dbUseMemory);
 public:
+    static const std::string BEGIN_TRANSACTION;
+    static const std::string COMMIT_TRANSACTION;
+    static const std::string ROLLBACK_TRANSACTION;
     enum operation
     {
         MOUNT,     /**@< 0 */
@@ -43,36 +62,49 @@ public:
         REQ_INPROGRESS, /**@< 1 */
         REQ_COMPLETED /**@< 2 */
     };
-    static std::mutex trans_mutex;
+    static std::recursive_mutex trans_mutex;
     DataBase() :
-            db(NULL), dbNeedsClosed(false)
+            db(NULL), rodb(NULL), dbNeedsClosed(false), persistent(false)
     {
     }
     ~DataBase();
     void cleanup();
-    void open(bool dbUseMemory);
+    void open(bool dbUseMemory, std::string dbFile);
+    bool isPersistent()
+    {
+        return persistent;
+    }
     void createTables();
+    void checkQueryPlans();
+    static std::string toParameters(const std::string& fmtstr);
     int lastUpdates();
     sqlite3 *getDB()
     {
         return db;
     }
+    sqlite3 *getReadDB()
+    {
+        return (rodb != NULL ? rodb : db);
+    }
     static std::string opStr(operation op);
     static std::string reqStateStr(req_state reqs);
+    sqlite3_stmt *getStatement(const std::string& fmtstr);
+    void putStatement(const std::string& fmtstr, sqlite3_stmt *stmt);
 };
 
 extern DataBase DB;
 
 class SQLStatement
 {
+protected:
+    bool readOnly;
 private:
     std::string fmtstr;
     sqlite3_stmt *stmt;
     boost::format fmt;
     int stmt_rc;
+    bool locked;
 
-    std::string encode(std::string s);
-    std::string decode(std::string s);
     void getColumn(int *result, int column);
     void getColumn(unsigned int *result, int column);
     void getColumn(DataBase::operation *result, int column);
@@ -103,17 +135,20 @@ private:
 
 public:
     SQLStatement() :
-            fmtstr(""), stmt(nullptr), fmt(""), stmt_rc(0)
+            readOnly(false), fmtstr(""), stmt(nullptr), fmt(""), stmt_rc(0),
+            locked(false)
     {
     }
     SQLStatement(std::string _fmtstr) :
-            fmtstr(_fmtstr), stmt(nullptr), fmt(boost::format(fmtstr)), stmt_rc(
-                    0)
+            readOnly(false), fmtstr(_fmtstr), stmt(nullptr), fmt(
+                    boost::format(fmtstr)), stmt_rc(0), locked(false)
     {
     }
     SQLStatement& operator()(std::string _fmtstr);
     ~SQLStatement()
     {
+        if (locked)
+            DataBase::trans_mutex.unlock();
     }
 
     // convert unsigned to signed since there is unsigned in SQLite
@@ -143,7 +178,7 @@ public:
     SQLStatement& operator<<(std::string s)
     {
         try {
-            fmt % encode(s);
+            fmt % escape(s);
         } catch (const std::exception& e) {
             MSG(LTFSDMS0102E);
             THROW(Error::GENERAL_ERROR, e.what(), fmtstr);
@@ -177,6 +212,7 @@ public:
         return *this;
     }
 
+    static std::string escape(std::string s);
     std::string str();
     void bind(int num, int value);
     void bind(int num, std::string value);
@@ -200,3 +236,132 @@ public:
     void finalize();
     void doall();
 };
+
+class SQLReadStatement: public SQLStatement
+{
+public:
+    SQLReadStatement() :
+            SQLStatement()
+    {
+        readOnly = true;
+    }
+};
+
+class SQLCachedStatement
+{
+private:
+    std::string fmtstr;
+    sqlite3_stmt *stmt;
+
+    void bindValue(int num, int value);
+    void bindValue(int num, unsigned int value);
+    void bindValue(int num, long value);
+    void bindValue(int num, unsigned long value);
+    void bindValue(int num, long long value);
+    void bindValue(int num, unsigned long long value);
+    void bindValue(int num, const std::string& value);
+    void bindValue(int num, const char *value);
+
+    void bindAll(int num)
+    {
+    }
+
+    template<typename T, typename ... Args>
+    void bindAll(int num, T value, Args ... args)
+    {
+        bindValue(num, value);
+        bindAll(num + 1, args ...);
+    }
+
+public:
+    SQLCachedStatement(const std::string& _fmtstr);
+    ~SQLCachedStatement();
+
+    template<typename ... Args>
+    void exec(Args ... args)
+    {
+        int rc;
+        std::unique_lock<std::recursive_mutex> lock(DataBase::trans_mutex,
+                std::defer_lock);
+
+        bindAll(1, args ...);
+
+        // changes are serialized with the transactions (see SQLTransaction)
+        if (sqlite3_stmt_readonly(stmt) == 0)
+            lock.lock();
+
+        rc = sqlite3_step(stmt);
+        sqlite3_reset(stmt);
+
+        if (rc != SQLITE_ROW && rc != SQLITE_DONE) {
+            TRACE(Trace::error, fmtstr, rc);
+            errno = rc;
+            THROW(Error::GENERAL_ERROR, rc);
+        }
+    }
+};
+
+class SQLTransaction
+{
+private:
+    std::unique_lock<std::recursive_mutex> lock;
+public:
+    SQLTransaction();
+    ~SQLTransaction();
+    void commit();
+    void rollback();
+};
+
+class SQLBatchStatement
+{
+private:
+    struct entry_t
+    {
+        std::function<void(SQLCachedStatement&)> exec;
+        std::function<void()> failed;
+    };
+    struct shard_t
+    {
+        std::mutex mtx;
+        std::vector<entry_t> pending;
+    };
+    std::string fmtstr;
+    shard_t shards[Const::DB_BATCH_SHARDS];
+    std::mutex execmtx;
+    std::atomic<int> numPending;
+    std::atomic<time_t> lastExec;
+
+    void execPending();
+public:
+    SQLBatchStatement(const std::string& _fmtstr) :
+            fmtstr(_fmtstr), numPending(0), lastExec(time(NULL))
+    {
+    }
+    ~SQLBatchStatement();
+
+    // failed is called if the statement cannot be executed (may be nullptr)
+    template<typename ... Args>
+    void add(std::function<void()> failed, Args ... args)
+    {
+        shard_t& shard = shards[std::hash<std::thread::id>()(
+                std::this_thread::get_id()) % Const::DB_BATCH_SHARDS];
+
+        {
+            std::lock_guard<std::mutex> lock(shard.mtx);
+            shard.pending.push_back( {
+                    [=](SQLCachedStatement& stmt) {stmt.exec(args ...);},
+                    failed });
+        }
+
+        if (++numPending < Const::DB_BATCH_SIZE
+                && time(NULL) - lastExec < Const::DB_BATCH_INTERVAL)
+            return;
+
+        // if another thread already executes a batch this one continues
+        std::unique_lock<std::mutex> lock(execmtx, std::try_to_lock);
+        if (lock.owns_lock())
+            execPending();
+    }
+
+    void flush();
+};
@@ -0,0 +1,243 @@
+/*******************************************************************************
+ * Copyright 2018 IBM Corp. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *******************************************************************************/
+#include "ServerIncludes.h"
+
+/** @page data_mover Data Mover
+
+    The data of a file is copied between the disk and the tape by
+    DataMover::toTape (migration) and DataMover::fromTape (recall). Each
+    call copies at most a single chunk. The chunk size is the largest
+    multiple of the block size of the tape file system
+    (LTFSDMInventory::getBlockSize) that does not exceed
+    Const::TRANSFER_SIZE. The callers check for suspension, termination,
+    and modification of the file in between two chunks.
+
+    If the connector provides a file descriptor for the disk file
+    (FsObj::getFileDescriptor) the data is copied by the kernel without
+    passing it through user space. The following methods are tried in
+    this order:
+
+    method | description
+    ---|---
+    copy_file_range | copy within the kernel, might fail between different file systems
+    sendfile | copy using the page cache of the source file
+    buffered | read and write using a buffer of the chunk size
+
+    If a method is not supported (errors like EXDEV, EINVAL, or ENOSYS) the
+    next one is used for the remaining data of the file. The same happens
+    if a method does not copy anything at the beginning. The disk side
+    always is addressed by offset (for sendfile to disk the file position
+    is set before) and the tape side by the file position, so switching
+    between methods within a file is consistent. The DMAPI
+    connector does not provide a file descriptor; there the data always
+    is copied by FsObj::read and FsObj::write.
+
+    ## Read-ahead
+
+    The data transfers of a drive are serialized by LTFSDMDrive::mtx but
+    are executed by up to Const::MAX_PREMIG_THREADS threads. Before
+    waiting for that mutex each thread reads the beginning of its file
+    (up to Const::READ_AHEAD_FILE_SIZE bytes) into buffers of the
+    LTFSDMDrive::pool (DataMover::readAhead). DataMover::toTape writes
+    these buffers first and continues with the methods above for the rest
+    of the file. This way the disk reads of the next files overlap the
+    tape writes of the current one and the drive keeps streaming at file
+    boundaries.
+
+    The BufferPool of a drive is bounded to Const::READ_AHEAD_SIZE. A
+    thread does not wait for free buffers: if none is available it reads
+    less or nothing ahead. Therefore the threads waiting for the drive
+    cannot block the one that is writing.
+ */
+
+DataMover::DataMover(unsigned long blockSize) :
+        mth(COPY_FILE_RANGE), moved(false), chunkSize(Const::TRANSFER_SIZE), pool(
+                nullptr)
+
+{
+    if (blockSize > 0)
+        chunkSize = blockSize
+                * std::max(1UL, Const::TRANSFER_SIZE / blockSize);
+
+    TRACE(Trace::full, blockSize, chunkSize);
+}
+
+DataMover::~DataMover()
+
+{
+    for (chunk_t chunk : prefetched)
+        pool->put(chunk.buffer);
+}
+
+void DataMover::readAhead(FsObj *source, long offset, unsigned long size,
+        BufferPool *_pool)
+
+{
+    int srcfd = source->getFileDescriptor();
+    long end = offset + std::min(size, Const::READ_AHEAD_FILE_SIZE);
+    unsigned long readSize;
+    char *buf;
+    long rsize;
+
+    pool = _pool;
+
+    // the chunk size exceeds the buffer size for large tape blocks
+    readSize = std::min(chunkSize, pool->getBufferSize());
+
+    while (offset < end && (buf = pool->get()) != nullptr) {
+        if (srcfd != Const::UNSET)
+            rsize = pread(srcfd, buf, std::min(readSize,
+                    (unsigned long) (end - offset)), offset);
+        else
+            rsize = source->read(offset, std::min(readSize,
+                    (unsigned long) (end - offset)), buf);
+
+        // errors are reported when the data is copied without read-ahead
+        if (rsize <= 0) {
+            pool->put(buf);
+            break;
+        }
+
+        prefetched.push_back((chunk_t ) { buf, offset, rsize });
+        offset += rsize;
+    }
+
+    TRACE(Trace::full, prefetched.size());
+}
+
+bool DataMover::kernelCopy(int fdin, off_t *offin, int fdout,
+        off_t *offout, unsigned long size, long *copied)
+
+{
+    while (mth != BUFFERED) {
+        if (mth == COPY_FILE_RANGE) {
+#ifdef __NR_copy_file_range
+            *copied = syscall(__NR_copy_file_range, fdin, offin, fdout,
+                    offout, size, 0);
+#else
+            *copied = -1;
+            errno = ENOSYS;
+#endif
+        } else {
+            // sendfile always writes at the file position of the output
+            if (offout != NULL && lseek(fdout, *offout, SEEK_SET) != *offout)
+                *copied = -1;
+            else if ((*copied = sendfile(fdout, fdin, offin, size)) > 0
+                    && offout != NULL)
+                *offout += *copied;
+        }
+
+        if (*copied > 0 || (*copied == 0 && moved)) {
+            moved = true;
+            return true;
+        }
+
+        if (*copied == -1 && errno != EXDEV && errno != EINVAL
+                && errno != ENOSYS && errno != EOPNOTSUPP)
+            return true;
+
+        TRACE(Trace::always, mth, *copied, errno);
+        mth = (mth == COPY_FILE_RANGE ? SENDFILE : BUFFERED);
+    }
+
+    return false;
+}
+
+char *DataMover::getBuffer()
+
+{
+    if (!buffer)
+        buffer = std::unique_ptr<char[]>(new char[chunkSize]);
+
+    return buffer.get();
+}
+
+long DataMover::toTape(FsObj *source, long offset, int fd, unsigned long size)
+
+{
+    int srcfd = source->getFileDescriptor();
+    off_t off = offset;
+    long rsize;
+
+    if (prefetched.size() > 0) {
+        chunk_t chunk = prefetched.front();
+        prefetched.pop_front();
+        if (chunk.offset == offset) {
+            rsize = write(fd, chunk.buffer, chunk.size);
+            pool->put(chunk.buffer);
+            if (rsize != chunk.size)
+                return -1;
+            moved = true;
+            return rsize;
+        }
+        pool->put(chunk.buffer);
+    }
+
+    size = std::min(size, chunkSize);
+
+    if (srcfd != Const::UNSET
+            && kernelCopy(srcfd, &off, fd, NULL, size, &rsize))
+        return rsize;
+
+    // FsObj::read of the FUSE connector does not take the offset into account
+    if (srcfd != Const::UNSET)
+        rsize = pread(srcfd, getBuffer(), size, offset);
+    else
+        rsize = source->read(offset, size, getBuffer());
+
+    if (rsize <= 0)
+        return rsize;
+
+    if (write(fd, getBuffer(), rsize) != rsize)
+        return -1;
+
+    moved = true;
+    return rsize;
+}
+
+long DataMover::fromTape(int fd, FsObj *target, long offset,
+        unsigned long size)
+
+{
+    int tgtfd = target->getFileDescriptor();
+    off_t off = offset;
+    long rsize;
+    long wsize;
+
+    size = std::min(size, chunkSize);
+
+    if (tgtfd != Const::UNSET
+            && kernelCopy(fd, NULL, tgtfd, &off, size, &rsize))
+        return rsize;
+
+    rsize = read(fd, getBuffer(), size);
+
+    if (rsize <= 0)
+        return rsize;
+
+    // FsObj::write of the FUSE connector does not take the offset into account
+    if (tgtfd != Const::UNSET)
+        wsize = pwrite(tgtfd, getBuffer(), rsize, offset);
+    else
+        wsize = target->write(offset, (unsigned long) rsize, getBuffer());
+
+    if (wsize != rsize)
+        return -1;
+
+    moved = true;
+    return rsize;
+}
@@ -0,0 +1,49 @@
+/*******************************************************************************
+ * Copyright 2018 IBM Corp. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *******************************************************************************/
+#pragma once
+
+class DataMover
+{
+private:
+    enum method
+    {
+        COPY_FILE_RANGE, SENDFILE, BUFFERED
+    };
+    struct chunk_t
+    {
+        char *buffer;
+        long offset;
+        long size;
+    };
+    method mth;
+    bool moved;
+    unsigned long chunkSize;
+    std::unique_ptr<char[]> buffer;
+    BufferPool *pool;
+    std::list<chunk_t> prefetched;
+
+    bool kernelCopy(int fdin, off_t *offin, int fdout, off_t *offout,
+            unsigned long size, long *copied);
+    char *getBuffer();
+public:
+    DataMover(unsigned long blockSize);
+    ~DataMover();
+    void readAhead(FsObj *source, long offset, unsigned long size,
+            BufferPool *_pool);
+    long toTape(FsObj *source, long offset, int fd, unsigned long size);
+    long fromTape(int fd, FsObj *target, long offset, unsigned long size);
+};
@@ -79,8 +79,7 @@ bool FileOperation::queryResult(long reqNumber, long *resident,
             Scheduler::updReq.erase(Scheduler::updReq.find(reqNumber));
         }
 
-        stmt(FileOperation::DELETE_JOBS) << reqNumber;
-        stmt.doall();
+        jobStore->deleteJobs(reqNumber);
 
         stmt(FileOperation::DELETE_REQUESTS) << reqNumber;
         stmt.doall();
@@ -20,19 +20,27 @@ class FileOperation
 {
 protected:
     unsigned long requestSize;
-    static std::string genInumString(std::list<unsigned long> inumList);
+    std::list<JobStore::job_t> jobs;
 public:
+    static std::string genInumString(std::list<unsigned long> inumList);
     static const std::string REQUEST_STATE;
-    static const std::string DELETE_JOBS;
     static const std::string DELETE_REQUESTS;
     FileOperation() :
             requestSize(0)
     {
     }
     virtual ~FileOperation() = default;
+    // collects the jobs of a file without accessing the database
     virtual void addJob(std::string fileName)
     {
     }
+    std::list<JobStore::job_t> takeJobs()
+    {
+        std::list<JobStore::job_t> taken;
+
+        taken.swap(jobs);
+        return taken;
+    }
     virtual void start()
     {
     }
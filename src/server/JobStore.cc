@@ -0,0 +1,74 @@
+/*******************************************************************************
+ * Copyright 2018 IBM Corp. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *******************************************************************************/
+#include "ServerIncludes.h"
+
+/** @page job_store Job store
+
+    # Job store
+
+    The jobs of the requests are accessed by the JobStore interface
+    (global object jobStore). The requests themselves remain within the
+    REQUEST_QUEUE table. There are two implementations that are selected
+    when the backend is started:
+
+    - SQLJobStore keeps the jobs within the JOB_QUEUE table (see
+      @ref sqlite). This is the default and the only implementation
+      that can be used together with the option <TT>-j &lt;file&gt;</TT>.
+    - ColumnJobStore keeps the jobs in memory (option <TT>-c</TT>).
+
+    The job id that is returned by the select methods is used to change
+    a single job, e.g. JobStore::Batch::setState. State changes of single
+    jobs that have been processed are collected by a JobStore::Batch.
+
+    ## ColumnJobStore
+
+    The requests are kept in Const::JOB_STORE_SHARDS shards selected by
+    the request number, each protected by its own mutex. The jobs of a
+    request are stored column by column in chunks of
+    ColumnJobStore::CHUNK_SIZE jobs: the state, the cartridge, the file
+    size, the inode number etc. each are kept within an array. A
+    statement like Migration::processFiles that selects the jobs of a
+    request in a certain state only reads the state column and the chunks
+    without any job in that state are skipped entirely. For this purpose
+    each chunk counts the jobs in each state.
+
+    The state of a job is changed by a compare and swap without a lock.
+    Therefore state changes do not need to be deferred and the batches
+    are applied immediately. The file names of a chunk are appended to a
+    single string. The other columns, new jobs, and the cartridges that
+    are assigned to jobs are protected by the mutex of the request.
+
+    The jobs of a cartridge are selected in the order of their start
+    block (RecallSession::processFiles). The jobs of a request on a
+    cartridge are sorted once. Jobs that have been added later are sorted
+    separately and merged into that order.
+
+    The unique constraints of the JOB_QUEUE table (a file can be added
+    once per replica for migration and transparent recall) are checked by
+    two hash indexes, one for the file name and one for the file uid.
+    A job that already exists is reported the same way as by SQLite
+    (errno is set to SQLITE_CONSTRAINT_UNIQUE). The jobs of a request are
+    kept until the request is deleted or, for recall requests, until all
+    jobs of a request have been recalled.
+
+    Since the jobs are not stored persistently ColumnJobStore cannot be
+    used together with the option <TT>-j &lt;file&gt;</TT>. Jobs that
+    are added while an SQLTransaction is open are not removed if that
+    transaction is rolled back.
+ */
+
+JobStore *jobStore = NULL;
@@ -0,0 +1,156 @@
+/*******************************************************************************
+ * Copyright 2018 IBM Corp. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *******************************************************************************/
+#pragma once
+
+class JobStore
+{
+public:
+    enum group_by
+    {
+        NO_GROUP, GROUP_STATE, GROUP_TAPE, GROUP_POOL
+    };
+    struct job_t
+    {
+        DataBase::operation op;
+        std::string fileName; // "" if not known
+        int reqNum;
+        int targetState;
+        int replNum;
+        std::string pool;
+        long fileSize;
+        fuid_t fuid;
+        long mtimeSec;
+        long mtimeNsec;
+        FsObj::file_state state;
+        std::string tapeId;
+        long startBlock;
+        std::intptr_t connInfo;
+    };
+    struct mig_job_t
+    {
+        long jobId;
+        std::string fileName;
+        long mtimeSec;
+        long mtimeNsec;
+        unsigned long inum;
+        unsigned long resumeOffset;
+        std::string resumeTapeId;
+    };
+    struct rec_job_t
+    {
+        DataBase::operation op;
+        int reqNum;
+        long jobId;
+        fuid_t fuid;
+        std::string fileName;
+        FsObj::file_state state;
+        FsObj::file_state targetState;
+        std::intptr_t connInfo;
+    };
+    struct unclaimed_t
+    {
+        int num;
+        unsigned long size;
+        unsigned long maxSize;
+        unsigned long minSize;
+    };
+    struct info_filter_t
+    {
+        int reqNum; // Const::UNSET for all requests
+        bool byOperation;
+        std::set<int> operations;
+        bool byState;
+        std::set<int> states;
+        std::string tapeId;
+        std::string pool;
+        std::string pathPrefix;
+        group_by groupBy;
+        long limit;
+        long offset;
+    };
+    struct info_t
+    {
+        DataBase::operation op;
+        std::string fileName;
+        int reqNum;
+        std::string pool;
+        unsigned long fileSize;
+        std::string tapeId;
+        FsObj::file_state state;
+        long count;
+    };
+
+    // state changes of single jobs that may be stored deferred
+    class Batch
+    {
+    public:
+        virtual ~Batch() = default;
+        // failed is called if the change cannot be stored (may be nullptr)
+        virtual void setState(std::function<void()> failed, long jobId,
+                FsObj::file_state from, FsObj::file_state to) = 0;
+        // from FsObj::RECALLING_MIG or FsObj::RECALLING_PREMIG
+        virtual void setRecalled(std::function<void()> failed, long jobId,
+                FsObj::file_state to) = 0;
+        virtual void assignTape(long jobId, std::string tapeId,
+                FsObj::file_state from, FsObj::file_state to) = 0;
+        virtual void flush() = 0;
+    };
+
+    virtual ~JobStore() = default;
+
+    // an existing job is reported with errno SQLITE_CONSTRAINT_UNIQUE
+    virtual void addJob(const job_t& job) = 0;
+    virtual std::shared_ptr<Batch> createBatch() = 0;
+    virtual void failJob(long jobId) = 0;
+    // all replicas of the file of that job within the request
+    virtual void failReplicas(int reqNum, long jobId) = 0;
+    virtual void setResumeOffset(long jobId, unsigned long offset,
+            std::string tapeId) = 0;
+    // replNum Const::UNSET for all replicas
+    virtual void changeState(const std::set<int>& reqNums, int replNum,
+            std::string tapeId, FsObj::file_state from,
+            FsObj::file_state to) = 0;
+    virtual unclaimed_t unclaimed(int reqNum, int replNum,
+            FsObj::file_state state) = 0;
+
+    // the select methods stop if process returns false
+    virtual void selectUnassigned(int reqNum, int replNum,
+            FsObj::file_state state,
+            std::function<bool(long jobId, unsigned long size)> process) = 0;
+    virtual void selectMigJobs(int reqNum, std::string tapeId,
+            FsObj::file_state state,
+            std::function<bool(const mig_job_t&)> process) = 0;
+    // jobs in FsObj::RECALLING_MIG or FsObj::RECALLING_PREMIG state
+    virtual void selectRecallJobs(const std::set<int>& reqNums,
+            std::string tapeId,
+            std::function<bool(const rec_job_t&)> process) = 0;
+    virtual void selectTransRecalls(
+            std::function<bool(const rec_job_t&)> process) = 0;
+    virtual void info(const info_filter_t& filter,
+            std::function<bool(const info_t&)> process) = 0;
+
+    virtual std::set<std::string> getTapes(int reqNum) = 0;
+    // state Const::UNSET for all states
+    virtual int countJobs(int reqNum, std::string tapeId, int state) = 0;
+    virtual std::map<FsObj::file_state, int> countStates(int reqNum) = 0;
+    // jobs in FsObj::RECALLING_MIG or FsObj::RECALLING_PREMIG state
+    virtual void deleteRecalled(const std::set<int>& reqNums,
+            std::string tapeId) = 0;
+    virtual void deleteJobs(int reqNum) = 0;
+};
+
+extern JobStore *jobStore;
@@ -17,7 +17,7 @@
 #include "ServerIncludes.h"
 
 LTFSDMCartridge::LTFSDMCartridge(boost::shared_ptr<Cartridge> c) :
-        cart(c), inProgress(0), pool(""), requested(false), state(
+        cart(c), inProgress(0), pool(""), requested(false), mountTime(0), state(
                 LTFSDMCartridge::TAPE_UNKNOWN), result(Error::OK)
 {
 }
@@ -68,6 +68,10 @@ void LTFSDMCartridge::setState(state_t _state)
 
     state = _state;
 
+    // after an unmount the content of the tape is not under control anymore
+    if (state == LTFSDMCartridge::TAPE_UNMOUNTED)
+        knownDirs.clear();
+
     TRACE(Trace::always, this->get_le()->GetObjectID(), state);
 }
 
@@ -102,3 +106,64 @@ void LTFSDMCartridge::unsetRequested()
 
     requested = false;
 }
+
+void LTFSDMCartridge::setMountTime(time_t _mountTime)
+
+{
+    std::lock_guard<std::recursive_mutex> lock(LTFSDMInventory::mtx);
+
+    mountTime = _mountTime;
+}
+
+time_t LTFSDMCartridge::getMountTime()
+
+{
+    std::lock_guard<std::recursive_mutex> lock(LTFSDMInventory::mtx);
+
+    return mountTime;
+}
+
+bool LTFSDMCartridge::isKnownDir(std::string path)
+
+{
+    std::lock_guard<std::recursive_mutex> lock(LTFSDMInventory::mtx);
+
+    return knownDirs.count(path) > 0;
+}
+
+void LTFSDMCartridge::addKnownDir(std::string path)
+
+{
+    std::lock_guard<std::recursive_mutex> lock(LTFSDMInventory::mtx);
+
+    knownDirs.insert(path);
+}
+
+void LTFSDMCartridge::clearKnownDirs()
+
+{
+    std::lock_guard<std::recursive_mutex> lock(LTFSDMInventory::mtx);
+
+    knownDirs.clear();
+}
+
+void LTFSDMCartridge::addPendingLink(std::string origPath,
+        std::string dataPath)
+
+{
+    std::lock_guard<std::recursive_mutex> lock(LTFSDMInventory::mtx);
+
+    pendingLinks.push_back(std::make_pair(origPath, dataPath));
+}
+
+std::list<std::pair<std::string, std::string>> LTFSDMCartridge::takePendingLinks()
+
+{
+    std::list<std::pair<std::string, std::string>> links;
+
+    std::lock_guard<std::recursive_mutex> lock(LTFSDMInventory::mtx);
+
+    links.swap(pendingLinks);
+
+    return links;
+}
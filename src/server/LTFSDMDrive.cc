@@ -18,13 +18,14 @@
 
 LTFSDMDrive::LTFSDMDrive(boost::shared_ptr<Drive> d) :
         drive(d), busy(false), umountReqNum(Const::UNSET), umountReqPool(""), toUnBlock(
-                DataBase::NOOP), mtx(nullptr), wqp(nullptr)
+                DataBase::NOOP), mtx(nullptr), wqp(nullptr), pool(nullptr)
 {
 }
 
 LTFSDMDrive::~LTFSDMDrive()
 {
     delete (mtx);
+    delete (pool);
 }
 
 void LTFSDMDrive::update()
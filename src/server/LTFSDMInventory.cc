@@ -391,25 +391,19 @@ void LTFSDMInventory::updateCartridge(std::string tapeId)
         try {
             std::lock_guard<std::recursive_mutex> lock(LTFSDMInventory::mtx);
 
-            for (std::shared_ptr<LTFSDMCartridge> c : cartridges) {
-                if (c->get_le()->GetObjectID().compare(tapeId) == 0) {
-                    MSG(LTFSDMS0106I, tapeId);
+            std::shared_ptr<LTFSDMCartridge> c;
 
-                    c->update();
+            if ((c = getCartridge(tapeId)) != nullptr) {
+                MSG(LTFSDMS0106I, tapeId);
 
-                    c->setState(LTFSDMCartridge::TAPE_UNMOUNTED);
-                    for (std::shared_ptr<LTFSDMDrive> d : drives) {
-                        TRACE(Trace::always, tapeId, c->get_le()->get_slot(),
-                                d->get_le()->get_slot());
-                        if (c->get_le()->get_slot()
-                                == d->get_le()->get_slot()) {
-                            c->setState(LTFSDMCartridge::TAPE_MOUNTED);
-                            break;
-                        }
-                    }
+                c->update();
+                updateSlotIndex(c);
 
-                    break;
-                }
+                TRACE(Trace::always, tapeId, c->get_le()->get_slot());
+                if (getMountingDrive(c) != nullptr)
+                    c->setState(LTFSDMCartridge::TAPE_MOUNTED);
+                else
+                    c->setState(LTFSDMCartridge::TAPE_UNMOUNTED);
             }
 
         } catch (const LTFSDMException& e) {
@@ -441,6 +435,10 @@ void LTFSDMInventory::inventorize()
 
     drives.clear();
     cartridges.clear();
+    driveById.clear();
+    cartridgeById.clear();
+    driveBySlot.clear();
+    cartridgeBySlot.clear();
 
     lookupDrives();
 
@@ -450,6 +448,16 @@ void LTFSDMInventory::inventorize()
             [] (const std::shared_ptr<LTFSDMCartridge> c1, const std::shared_ptr<LTFSDMCartridge> c2)
             {   return (c1->get_le()->GetObjectID().compare(c2->get_le()->GetObjectID()) < 0);});
 
+    for (std::shared_ptr<LTFSDMDrive> d : drives) {
+        driveById[d->get_le()->GetObjectID()] = d;
+        driveBySlot[d->get_le()->get_slot()] = d;
+    }
+
+    for (std::shared_ptr<LTFSDMCartridge> c : cartridges) {
+        cartridgeById[c->get_le()->GetObjectID()] = c;
+        updateSlotIndex(c);
+    }
+
     for (std::string poolname : Server::conf.getPools()) {
         for (std::string cartridgeid : Server::conf.getPool(poolname)) {
             if (getCartridge(cartridgeid) == nullptr) {
@@ -466,21 +474,20 @@ void LTFSDMInventory::inventorize()
     }
 
     for (std::shared_ptr<LTFSDMCartridge> c : cartridges) {
+        std::shared_ptr<LTFSDMDrive> d;
         c->setState(LTFSDMCartridge::TAPE_UNMOUNTED);
-        for (std::shared_ptr<LTFSDMDrive> d : drives) {
-            if (c->get_le()->get_slot() == d->get_le()->get_slot()) {
-                c->setState(LTFSDMCartridge::TAPE_MOUNTED);
-                if (c->get_le()->get_handling().compare("UNMOUNTED") == 0) {
-                    MSG(LTFSDML0020E, c->get_le()->GetObjectID());
-                    try {
-                        c->get_le()->Mount(d->get_le()->GetObjectID());
-                    } catch (AdminLibException& e) {
-                        MSG(LTFSDMS0100E, c->get_le()->GetObjectID(), e.what());
-                    } catch (const std::exception& e) {
-                        MSG(LTFSDMS0105E, c->get_le()->GetObjectID());
-                    }
+        if ((d = getMountingDrive(c)) != nullptr) {
+            c->setState(LTFSDMCartridge::TAPE_MOUNTED);
+            c->setMountTime(time(NULL));
+            if (c->get_le()->get_handling().compare("UNMOUNTED") == 0) {
+                MSG(LTFSDML0020E, c->get_le()->GetObjectID());
+                try {
+                    c->get_le()->Mount(d->get_le()->GetObjectID());
+                } catch (AdminLibException& e) {
+                    MSG(LTFSDMS0100E, c->get_le()->GetObjectID(), e.what());
+                } catch (const std::exception& e) {
+                    MSG(LTFSDMS0105E, c->get_le()->GetObjectID());
                 }
-                break;
             }
         }
     }
@@ -491,10 +498,14 @@ void LTFSDMInventory::inventorize()
         drive->wqp =
                 new ThreadPool<std::string, std::string, long, long,
                         Migration::mig_info_t,
-                        std::shared_ptr<std::list<unsigned long>>,
-                        std::shared_ptr<bool>>(&Migration::transferData,
+                        std::shared_ptr<JobStore::Batch>,
+                        std::shared_ptr<bool>,
+                        std::shared_ptr<TapeContainer>>(
+                        &Migration::transferData,
                         Const::MAX_PREMIG_THREADS, threadName.str());
         drive->mtx = new std::mutex();
+        drive->pool = new BufferPool(Const::TRANSFER_SIZE,
+                Const::READ_AHEAD_SIZE / Const::TRANSFER_SIZE);
     }
 }
 
@@ -575,12 +586,12 @@ std::shared_ptr<LTFSDMDrive> LTFSDMInventory::getDrive(std::string driveid)
 
 {
     std::lock_guard<std::recursive_mutex> lock(LTFSDMInventory::mtx);
+    std::unordered_map<std::string, std::shared_ptr<LTFSDMDrive>>::iterator it;
 
-    for (std::shared_ptr<LTFSDMDrive> drive : drives)
-        if (drive->get_le()->GetObjectID().compare(driveid) == 0)
-            return drive;
+    if ((it = driveById.find(driveid)) == driveById.end())
+        return nullptr;
 
-    return nullptr;
+    return it->second;
 }
 
 std::list<std::shared_ptr<LTFSDMCartridge>> LTFSDMInventory::getCartridges()
@@ -596,12 +607,75 @@ std::shared_ptr<LTFSDMCartridge> LTFSDMInventory::getCartridge(
 
 {
     std::lock_guard<std::recursive_mutex> lock(LTFSDMInventory::mtx);
+    std::unordered_map<std::string, std::shared_ptr<LTFSDMCartridge>>::iterator it;
 
-    for (std::shared_ptr<LTFSDMCartridge> cartridge : cartridges)
-        if (cartridge->get_le()->GetObjectID().compare(cartridgeid) == 0)
-            return cartridge;
+    if ((it = cartridgeById.find(cartridgeid)) == cartridgeById.end())
+        return nullptr;
 
-    return nullptr;
+    return it->second;
+}
+
+/*
+ * The following two methods do not copy the lists of drives and
+ * cartridges. The caller needs to hold the LTFSDMInventory::mtx lock
+ * as long as the returned list is in use.
+ */
+const std::list<std::shared_ptr<LTFSDMDrive>>& LTFSDMInventory::getDriveList()
+
+{
+    return drives;
+}
+
+const std::list<std::shared_ptr<LTFSDMCartridge>>& LTFSDMInventory::getCartridgeList()
+
+{
+    return cartridges;
+}
+
+std::shared_ptr<LTFSDMCartridge> LTFSDMInventory::getMountedCartridge(
+        std::shared_ptr<LTFSDMDrive> drive)
+
+{
+    std::lock_guard<std::recursive_mutex> lock(LTFSDMInventory::mtx);
+    std::unordered_map<int, std::shared_ptr<LTFSDMCartridge>>::iterator it;
+
+    if ((it = cartridgeBySlot.find(drive->get_le()->get_slot()))
+            == cartridgeBySlot.end())
+        return nullptr;
+
+    return it->second;
+}
+
+std::shared_ptr<LTFSDMDrive> LTFSDMInventory::getMountingDrive(
+        std::shared_ptr<LTFSDMCartridge> cartridge)
+
+{
+    std::lock_guard<std::recursive_mutex> lock(LTFSDMInventory::mtx);
+    std::unordered_map<int, std::shared_ptr<LTFSDMDrive>>::iterator it;
+
+    if ((it = driveBySlot.find(cartridge->get_le()->get_slot()))
+            == driveBySlot.end())
+        return nullptr;
+
+    return it->second;
+}
+
+void LTFSDMInventory::updateSlotIndex(
+        std::shared_ptr<LTFSDMCartridge> cartridge)
+
+{
+    std::lock_guard<std::recursive_mutex> lock(LTFSDMInventory::mtx);
+    std::unordered_map<int, std::shared_ptr<LTFSDMCartridge>>::iterator it;
+
+    for (it = cartridgeBySlot.begin(); it != cartridgeBySlot.end(); ++it) {
+        if (it->second == cartridge) {
+            cartridgeBySlot.erase(it);
+            break;
+        }
+    }
+
+    if (driveBySlot.count(cartridge->get_le()->get_slot()) > 0)
+        cartridgeBySlot[cartridge->get_le()->get_slot()] = cartridge;
 }
 
 void LTFSDMInventory::update(std::shared_ptr<LTFSDMDrive> drive)
@@ -618,6 +692,7 @@ void LTFSDMInventory::update(std::shared_ptr<LTFSDMCartridge> cartridge)
     std::lock_guard<std::recursive_mutex> lock(LTFSDMInventory::mtx);
 
     cartridge->update();
+    updateSlotIndex(cartridge);
 }
 
 void LTFSDMInventory::poolCreate(std::string poolname)
@@ -724,6 +799,29 @@ void LTFSDMInventory::poolRemove(std::string poolname, std::string cartridgeid)
     cartridge->setPool("");
 }
 
+void LTFSDMInventory::poolLimit(std::string poolname, std::string operation,
+        Configuration::drive_limits limits)
+
+{
+    std::lock_guard<std::recursive_mutex> lock(LTFSDMInventory::mtx);
+
+    try {
+        Server::conf.poolSetLimits(poolname,
+                Configuration::driveOp(operation), limits);
+    } catch (const LTFSDMException& e) {
+        if (e.getError() == Error::CONFIG_POOL_NOT_EXISTS) {
+            MSG(LTFSDMX0025E, poolname);
+            THROW(Error::POOL_NOT_EXISTS);
+        } else if (e.getError() == Error::WRONG_DRIVE_LIMITS) {
+            MSG(LTFSDMX0088E, poolname, operation, limits.minDrives,
+                    limits.maxDrives);
+            THROW(Error::WRONG_DRIVE_LIMITS);
+        } else {
+            THROW(Error::GENERAL_ERROR);
+        }
+    }
+}
+
 void LTFSDMInventory::mount(std::string driveid, std::string cartridgeid,
         TapeMover::operation op)
 
@@ -752,7 +850,9 @@ void LTFSDMInventory::mount(std::string driveid, std::string cartridgeid,
         std::lock_guard<std::recursive_mutex> lock(LTFSDMInventory::mtx);
 
         cartridge->update();
+        updateSlotIndex(cartridge);
         cartridge->setState(LTFSDMCartridge::TAPE_MOUNTED);
+        cartridge->setMountTime(time(NULL));
         TRACE(Trace::always, drive->get_le()->GetObjectID());
         drive->setFree();
         drive->unsetMoveReq();
@@ -807,6 +907,7 @@ void LTFSDMInventory::unmount(std::string driveid, std::string cartridgeid)
         std::lock_guard<std::recursive_mutex> lock(LTFSDMInventory::mtx);
 
         cartridge->update();
+        updateSlotIndex(cartridge);
         cartridge->setState(LTFSDMCartridge::TAPE_UNMOUNTED);
         TRACE(Trace::always, drive->get_le()->GetObjectID());
         drive->setFree();
@@ -840,6 +941,10 @@ void LTFSDMInventory::unmount(std::string driveid, std::string cartridgeid)
 void LTFSDMInventory::format(std::string cartridgeid)
 
 {
+    std::shared_ptr<LTFSDMCartridge> cartridge = getCartridge(cartridgeid);
+
+    if (cartridge != nullptr)
+        cartridge->clearKnownDirs();
 }
 
 void LTFSDMInventory::check(std::string cartridgeid)
@@ -878,6 +983,49 @@ bool LTFSDMInventory::requestExists(long reqNum, std::string pool)
     return false;
 }
 
+/*
+ * The recall history has its own mutex instead of LTFSDMInventory::mtx
+ * since it is updated for each file that is added to a recall request.
+ * The scheduler reads it while holding LTFSDMInventory::mtx.
+ */
+void LTFSDMInventory::addRecall(std::string cartridgeid)
+
+{
+    std::lock_guard<std::mutex> lock(recallmtx);
+    recall_history_t& history = recallHistory[cartridgeid];
+    time_t now = time(NULL);
+
+    /*
+     * Recalls within a short time count once: a burst of recalls of a
+     * single process or the files of a selective recall do not make a
+     * cartridge hot but repeated accesses over time do.
+     */
+    if (history.score > 0 && now - history.last < Const::BULK_RECALL_WINDOW)
+        return;
+
+    // each recall counts less the longer it is ago
+    history.score = history.score
+            * pow(0.5,
+                    (double) (now - history.last)
+                            / Const::RECALL_HISTORY_HALF_LIFE) + 1;
+    history.last = now;
+}
+
+double LTFSDMInventory::getRecallScore(std::string cartridgeid)
+
+{
+    std::lock_guard<std::mutex> lock(recallmtx);
+    std::unordered_map<std::string, recall_history_t>::iterator it;
+
+    if ((it = recallHistory.find(cartridgeid)) == recallHistory.end())
+        return 0;
+
+    return it->second.score
+            * pow(0.5,
+                    (double) (time(NULL) - it->second.last)
+                            / Const::RECALL_HISTORY_HALF_LIFE);
+}
+
 std::string LTFSDMInventory::getMountPoint()
 
 {
@@ -36,7 +36,9 @@ private:
 public:
     std::mutex *mtx;
     ThreadPool<std::string, std::string, long, long, Migration::mig_info_t,
-            std::shared_ptr<std::list<unsigned long>>, std::shared_ptr<bool>> *wqp;
+            std::shared_ptr<JobStore::Batch>, std::shared_ptr<bool>,
+            std::shared_ptr<TapeContainer>> *wqp;
+    BufferPool *pool;
     LTFSDMDrive(boost::shared_ptr<Drive> d);
     ~LTFSDMDrive();
     boost::shared_ptr<Drive> get_le()
@@ -63,6 +65,9 @@ private:
     unsigned long inProgress;
     std::string pool;
     bool requested;
+    time_t mountTime;
+    std::unordered_set<std::string> knownDirs;
+    std::list<std::pair<std::string, std::string>> pendingLinks;
 public:
     enum state_t
     {
@@ -88,6 +93,13 @@ public:
     bool isRequested();
     void setRequested();
     void unsetRequested();
+    void setMountTime(time_t _mountTime);
+    time_t getMountTime();
+    bool isKnownDir(std::string path);
+    void addKnownDir(std::string path);
+    void clearKnownDirs();
+    void addPendingLink(std::string origPath, std::string dataPath);
+    std::list<std::pair<std::string, std::string>> takePendingLinks();
 
     std::mutex mtx;
     std::condition_variable cond;
@@ -97,12 +109,23 @@ public:
 class LTFSDMInventory
 {
 private:
+    struct recall_history_t
+    {
+        double score;
+        time_t last;
+    };
     std::list<std::shared_ptr<LTFSDMDrive>> drives;
     std::list<std::shared_ptr<LTFSDMCartridge>> cartridges;
+    std::unordered_map<std::string, std::shared_ptr<LTFSDMDrive>> driveById;
+    std::unordered_map<std::string, std::shared_ptr<LTFSDMCartridge>> cartridgeById;
+    std::unordered_map<int, std::shared_ptr<LTFSDMDrive>> driveBySlot;
+    std::unordered_map<int, std::shared_ptr<LTFSDMCartridge>> cartridgeBySlot;
     boost::shared_ptr<LTFSAdminSession> sess;
     boost::shared_ptr<LTFSNode> node;
     std::string mountPoint;
     unsigned long blockSize;
+    std::unordered_map<std::string, recall_history_t> recallHistory;
+    std::mutex recallmtx;
 
     void connect(std::string node_addr, unsigned short int port_num);
     void disconnect();
@@ -115,6 +138,7 @@ private:
     void remCartridge(boost::shared_ptr<Cartridge> cartridge,
             bool keep_on_drive = false);
     void lookupCartridges(bool assigned_only = false, bool force = false);
+    void updateSlotIndex(std::shared_ptr<LTFSDMCartridge> cartridge);
 public:
     LTFSDMInventory();
     ~LTFSDMInventory();
@@ -131,6 +155,12 @@ public:
     std::shared_ptr<LTFSDMDrive> getDrive(std::string driveid);
     std::list<std::shared_ptr<LTFSDMCartridge>> getCartridges();
     std::shared_ptr<LTFSDMCartridge> getCartridge(std::string cartridgeid);
+    const std::list<std::shared_ptr<LTFSDMDrive>>& getDriveList();
+    const std::list<std::shared_ptr<LTFSDMCartridge>>& getCartridgeList();
+    std::shared_ptr<LTFSDMCartridge> getMountedCartridge(
+            std::shared_ptr<LTFSDMDrive> drive);
+    std::shared_ptr<LTFSDMDrive> getMountingDrive(
+            std::shared_ptr<LTFSDMCartridge> cartridge);
 
     void update(std::shared_ptr<LTFSDMDrive>);
     void update(std::shared_ptr<LTFSDMCartridge>);
@@ -139,6 +169,8 @@ public:
     void poolDelete(std::string poolname);
     void poolAdd(std::string poolname, std::string cartridgeid);
     void poolRemove(std::string poolname, std::string cartridgeid);
+    void poolLimit(std::string poolname, std::string operation,
+            Configuration::drive_limits limits);
 
     void mount(std::string driveid, std::string cartridgeid,
             TapeMover::operation op);
@@ -147,6 +179,8 @@ public:
     void check(std::string cartridgeid);
 
     bool requestExists(long reqNum, std::string pool);
+    void addRecall(std::string cartridgeid);
+    double getRecallScore(std::string cartridgeid);
 
     std::string getMountPoint();
     unsigned long getBlockSize();
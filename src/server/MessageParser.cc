@@ -49,6 +49,7 @@
     MessageParser::poolDeleteMessage | pool delete command
     MessageParser::poolAddMessage | pool add command
     MessageParser::poolRemoveMessage | pool remove command
+    MessageParser::poolLimitMessage | pool limit command
     MessageParser::infoPoolsMessage | info pools command
     MessageParser::retrieveMessage | retrieve command
 
@@ -56,7 +57,12 @@
     from the client to the backend. This is handled within the MessageParser::getObjects
     method. Sending the objects and querying the migration and recall status
     is performed over same connection like the initial migration and recall
-    requests to be followed and not processed by the Receiver.
+    requests to be followed and not processed by the Receiver. The jobs for
+    the file names of each message (up to Const::MAX_OBJECTS_SEND) are added
+    within a single transaction (see @ref sqlite). The files are examined
+    (FileOperation::addJob) before that transaction is started such that
+    other threads are not blocked meanwhile. A file name that cannot be
+    added is reported individually.
 
     The following graph provides an overview of the complete client message processing:
 
@@ -124,6 +130,12 @@ void MessageParser::getObjects(LTFSDmCommServer *command, long localReqNumber,
         const LTFSDmProtocol::LTFSDmSendObjects sendobjects =
                 command->sendobjects();
 
+        /*
+         * The files are examined before the transaction is started: the
+         * transaction blocks all other threads that change the database
+         * and FileOperation::addJob might take LTFSDMInventory::mtx that
+         * is held by the scheduler while it changes the database.
+         */
         for (int j = 0; j < sendobjects.filenames_size(); j++) {
             if (Server::terminate == true) {
                 command->closeAcc();
@@ -134,14 +146,6 @@ void MessageParser::getObjects(LTFSDmCommServer *command, long localReqNumber,
             if (filename.filename().compare("") != 0) {
                 try {
                     fopt->addJob(filename.filename());
-                } catch (const LTFSDMException& e) {
-                    TRACE(Trace::error, e.what());
-                    if (e.getErrno() == SQLITE_CONSTRAINT_PRIMARYKEY
-                            || e.getErrno() == SQLITE_CONSTRAINT_UNIQUE)
-                        MSG(LTFSDMS0019E, filename.filename().c_str());
-                    else
-                        MSG(LTFSDMS0015E, filename.filename().c_str(),
-                                e.what());
                 } catch (const std::exception& e) {
                     TRACE(Trace::error, e.what());
                 }
@@ -150,6 +154,31 @@ void MessageParser::getObjects(LTFSDmCommServer *command, long localReqNumber,
             }
         }
 
+        SQLTransaction trans;
+
+        for (const JobStore::job_t& job : fopt->takeJobs()) {
+            try {
+                jobStore->addJob(job);
+            } catch (const LTFSDMException& e) {
+                TRACE(Trace::error, e.what());
+                if (e.getErrno() == SQLITE_CONSTRAINT_PRIMARYKEY
+                        || e.getErrno() == SQLITE_CONSTRAINT_UNIQUE)
+                    MSG(LTFSDMS0019E, job.fileName.c_str());
+                else
+                    MSG(LTFSDMS0015E, job.fileName.c_str(), e.what());
+            } catch (const std::exception& e) {
+                TRACE(Trace::error, e.what());
+            }
+        }
+
+        try {
+            trans.commit();
+        } catch (const std::exception& e) {
+            TRACE(Trace::error, e.what());
+            MSG(LTFSDMS0121E, requestNumber);
+            THROW(Error::GENERAL_ERROR);
+        }
+
         if (cont == false) {
             for (std::string pool : pools) {
                 unsigned long free = 0;
@@ -322,9 +351,7 @@ void MessageParser::migrationMessage(long key, LTFSDmCommServer *command,
             getObjects(command, localReqNumber, pid, requestNumber,
                     dynamic_cast<FileOperation*>(mig), pools);
         } catch (const std::exception& e) {
-            SQLStatement stmt;
-            stmt(FileOperation::DELETE_JOBS) << requestNumber;
-            stmt.doall();
+            jobStore->deleteJobs(requestNumber);
             return;
         }
         mig->addRequest();
@@ -382,9 +409,7 @@ void MessageParser::selRecallMessage(long key, LTFSDmCommServer *command,
             getObjects(command, localReqNumber, pid, requestNumber,
                     dynamic_cast<FileOperation*>(srec));
         } catch (const std::exception& e) {
-            SQLStatement stmt;
-            stmt(FileOperation::DELETE_JOBS) << requestNumber;
-            stmt.doall();
+            jobStore->deleteJobs(requestNumber);
             return;
         }
         srec->addRequest();
@@ -597,6 +622,40 @@ void MessageParser::addMessage(long key, LTFSDmCommServer *command,
     }
 }
 
+std::string MessageParser::genCondition(const std::string& filter,
+        std::string value)
+
+{
+    SQLStatement cond;
+
+    cond(filter) << value;
+    return cond.str();
+}
+
+std::string MessageParser::genWhere(const std::list<std::string>& conditions)
+
+{
+    std::string where;
+
+    for (const std::string& cond : conditions)
+        where += (where.empty() ? " WHERE " : " AND ") + cond;
+
+    return where;
+}
+
+std::string MessageParser::genPage(const char *order, long limit, long offset)
+
+{
+    SQLStatement page;
+
+    if (limit <= 0 && offset <= 0)
+        return "";
+
+    // LIMIT -1 does not restrict the number of rows
+    page(MessageParser::PAGE) << order << (limit > 0 ? limit : -1) << offset;
+    return page.str();
+}
+
 void MessageParser::infoRequestsMessage(long key, LTFSDmCommServer *command,
         long localReqNumber)
 
@@ -606,8 +665,9 @@ void MessageParser::infoRequestsMessage(long key, LTFSDmCommServer *command,
             command->inforequestsrequest();
     long keySent = inforeqs.key();
     int requestNumber = inforeqs.reqnumber();
-    SQLStatement stmt;
-    std::stringstream ssql;
+    SQLReadStatement stmt;
+    std::list<std::string> conditions;
+    std::list<unsigned long> values;
     DataBase::operation op;
     int reqNum;
     std::string tapeId;
@@ -622,12 +682,48 @@ void MessageParser::infoRequestsMessage(long key, LTFSDmCommServer *command,
         return;
     }
 
-    TRACE(Trace::normal, requestNumber);
+    TRACE(Trace::normal, requestNumber, inforeqs.operation(), inforeqs.state(),
+            inforeqs.tapeid(), inforeqs.pool(), inforeqs.limit(),
+            inforeqs.offset());
 
     if (requestNumber != Const::UNSET)
-        stmt(MessageParser::INFO_ONE_REQUEST) << requestNumber;
-    else
-        stmt(MessageParser::INFO_ALL_REQUESTS);
+        conditions.push_back(
+                genCondition(MessageParser::FILTER_REQ_NUM,
+                        std::to_string(requestNumber)));
+
+    if (inforeqs.operation().size() > 0) {
+        for (int i = DataBase::MOUNT; i < DataBase::NOOP; i++)
+            if (DataBase::opStr(static_cast<DataBase::operation>(i))
+                    == inforeqs.operation())
+                values.push_back(i);
+        conditions.push_back(
+                genCondition(MessageParser::FILTER_OPERATION,
+                        FileOperation::genInumString(values)));
+        values.clear();
+    }
+
+    if (inforeqs.state().size() > 0) {
+        for (int i = DataBase::REQ_NEW; i <= DataBase::REQ_COMPLETED; i++)
+            if (DataBase::reqStateStr(static_cast<DataBase::req_state>(i))
+                    == inforeqs.state())
+                values.push_back(i);
+        conditions.push_back(
+                genCondition(MessageParser::FILTER_REQ_STATE,
+                        FileOperation::genInumString(values)));
+    }
+
+    if (inforeqs.tapeid().size() > 0)
+        conditions.push_back(
+                genCondition(MessageParser::FILTER_TAPE_ID, inforeqs.tapeid()));
+
+    if (inforeqs.pool().size() > 0)
+        conditions.push_back(
+                genCondition(MessageParser::FILTER_TAPE_POOL, inforeqs.pool()));
+
+    // passed as C strings since the conditions already are escaped
+    stmt(MessageParser::INFO_REQUESTS) << genWhere(conditions).c_str()
+            << genPage("REQ_NUM", inforeqs.limit(), inforeqs.offset()).c_str();
+    TRACE(Trace::normal, stmt.str());
 
     stmt.prepare();
 
@@ -679,14 +775,8 @@ void MessageParser::infoJobsMessage(long key, LTFSDmCommServer *command,
             command->infojobsrequest();
     long keySent = infojobs.key();
     int requestNumber = infojobs.reqnumber();
-    SQLStatement stmt;
-    DataBase::operation op;
-    std::string fileName;
-    int reqNum;
-    std::string pool;
-    unsigned long fileSize;
-    std::string tapeId;
-    FsObj::file_state state;
+    JobStore::info_filter_t filter;
+    bool sendError = false;
 
     TRACE(Trace::normal, keySent);
 
@@ -695,37 +785,79 @@ void MessageParser::infoJobsMessage(long key, LTFSDmCommServer *command,
         return;
     }
 
-    TRACE(Trace::normal, requestNumber);
+    TRACE(Trace::normal, requestNumber, infojobs.operation(), infojobs.state(),
+            infojobs.tapeid(), infojobs.pool(), infojobs.pathprefix(),
+            infojobs.limit(), infojobs.offset(), infojobs.groupby());
+
+    filter.reqNum = requestNumber;
+
+    filter.byOperation = (infojobs.operation().size() > 0);
+    if (filter.byOperation)
+        for (int i = DataBase::MOUNT; i < DataBase::NOOP; i++)
+            if (DataBase::opStr(static_cast<DataBase::operation>(i))
+                    == infojobs.operation())
+                filter.operations.insert(i);
+
+    // RECALLING_MIG and RECALLING_PREMIG share the same name
+    filter.byState = (infojobs.state().size() > 0);
+    if (filter.byState)
+        for (int i = FsObj::RESIDENT; i <= FsObj::RECALLING_PREMIG; i++)
+            if (FsObj::migStateStr(i) == infojobs.state())
+                filter.states.insert(i);
+
+    filter.tapeId = infojobs.tapeid();
+    filter.pool = infojobs.pool();
+    filter.pathPrefix = infojobs.pathprefix();
+
+    switch (infojobs.groupby()) {
+        case LTFSDmProtocol::LTFSDmInfoJobsRequest::STATE:
+            filter.groupBy = JobStore::GROUP_STATE;
+            break;
+        case LTFSDmProtocol::LTFSDmInfoJobsRequest::TAPE:
+            filter.groupBy = JobStore::GROUP_TAPE;
+            break;
+        case LTFSDmProtocol::LTFSDmInfoJobsRequest::POOL:
+            filter.groupBy = JobStore::GROUP_POOL;
+            break;
+        default:
+            filter.groupBy = JobStore::NO_GROUP;
+    }
 
-    if (requestNumber != Const::UNSET)
-        stmt(MessageParser::INFO_SEL_JOBS) << requestNumber;
-    else
-        stmt(MessageParser::INFO_ALL_JOBS);
+    filter.limit = infojobs.limit();
+    filter.offset = infojobs.offset();
 
-    stmt.prepare();
+    jobStore->info(filter,
+            [command, &filter, &sendError](const JobStore::info_t& info) {
+                LTFSDmProtocol::LTFSDmInfoJobsResp *infojobsresp =
+                        command->mutable_infojobsresp();
 
-    while (stmt.step(&op, &fileName, &reqNum, &pool, &fileSize, &tapeId, &state)) {
-        LTFSDmProtocol::LTFSDmInfoJobsResp *infojobsresp =
-                command->mutable_infojobsresp();
+                if (filter.groupBy == JobStore::NO_GROUP) {
+                    infojobsresp->set_operation(DataBase::opStr(info.op));
+                } else {
+                    // the grouped column is returned within its field
+                    infojobsresp->set_operation("");
+                    infojobsresp->set_count(info.count);
+                }
+                infojobsresp->set_filename(info.fileName);
+                infojobsresp->set_reqnumber(info.reqNum);
+                infojobsresp->set_pool(info.pool);
+                infojobsresp->set_filesize(info.fileSize);
+                infojobsresp->set_tapeid(info.tapeId);
+                infojobsresp->set_state(info.state);
 
-        infojobsresp->set_operation(DataBase::opStr(op));
-        infojobsresp->set_filename(fileName);
-        infojobsresp->set_reqnumber(reqNum);
-        infojobsresp->set_pool(pool);
-        infojobsresp->set_filesize(fileSize);
-        infojobsresp->set_tapeid(tapeId);
-        infojobsresp->set_state(state);
+                try {
+                    command->send();
+                } catch (const std::exception& e) {
+                    TRACE(Trace::error, e.what());
+                    MSG(LTFSDMS0007E);
+                    sendError = true;
+                    return false;
+                }
+                return true;
+            });
 
-        try {
-            command->send();
-        } catch (const std::exception& e) {
-            TRACE(Trace::error, e.what());
-            MSG(LTFSDMS0007E);
-            stmt.finalize();
-            return;
-        }
-    }
-    stmt.finalize();
+    if (sendError)
+        return;
 
     LTFSDmProtocol::LTFSDmInfoJobsResp *infojobsresp =
             command->mutable_infojobsresp();
@@ -736,6 +868,7 @@ void MessageParser::infoJobsMessage(long key, LTFSDmCommServer *command,
     infojobsresp->set_filesize(Const::UNSET);
     infojobsresp->set_tapeid("");
     infojobsresp->set_state(Const::UNSET);
+    infojobsresp->clear_count();
 
     try {
         command->send();
@@ -1165,6 +1298,53 @@ void MessageParser::poolRemoveMessage(long key, LTFSDmCommServer *command)
     }
 }
 
+void MessageParser::poolLimitMessage(long key, LTFSDmCommServer *command)
+
+{
+    TRACE(Trace::always, __PRETTY_FUNCTION__);
+    const LTFSDmProtocol::LTFSDmPoolLimitRequest poollimit =
+            command->poollimitrequest();
+    long keySent = poollimit.key();
+    std::string poolName;
+    Configuration::drive_limits limits;
+    int response = static_cast<int>(Error::OK);
+
+    TRACE(Trace::normal, keySent);
+
+    if (key != keySent) {
+        MSG(LTFSDMS0008E, keySent);
+        return;
+    }
+
+    poolName = poollimit.poolname();
+    limits.minDrives = poollimit.mindrives();
+    limits.maxDrives = poollimit.maxdrives();
+
+    {
+        std::lock_guard<std::recursive_mutex> lock(LTFSDMInventory::mtx);
+        try {
+            inventory->poolLimit(poolName, poollimit.operation(), limits);
+        } catch (const LTFSDMException& e) {
+            response = static_cast<int>(e.getError());
+        } catch (const std::exception& e) {
+            response = static_cast<int>(Error::GENERAL_ERROR);
+        }
+    }
+
+    LTFSDmProtocol::LTFSDmPoolResp *poolresp = command->mutable_poolresp();
+
+    poolresp->set_response(response);
+
+    try {
+        command->send();
+    } catch (const std::exception& e) {
+        TRACE(Trace::error, e.what());
+        MSG(LTFSDMS0007E);
+    }
+
+    Scheduler::invoke();
+}
+
 void MessageParser::infoPoolsMessage(long key, LTFSDmCommServer *command)
 
 {
@@ -1333,6 +1513,8 @@ void MessageParser::run(long key, LTFSDmCommServer command,
                     poolAddMessage(key, &command);
                 } else if (command.has_poolremoverequest()) {
                     poolRemoveMessage(key, &command);
+                } else if (command.has_poollimitrequest()) {
+                    poolLimitMessage(key, &command);
                 } else if (command.has_infopoolsrequest()) {
                     infoPoolsMessage(key, &command);
                 } else if (command.has_retrieverequest()) {
@@ -19,12 +19,22 @@
 class MessageParser
 
 {
+    friend class DataBase;
+    friend class SQLJobStore;
 private:
     static const std::string ALL_REQUESTS;
-    static const std::string INFO_ALL_REQUESTS;
-    static const std::string INFO_ONE_REQUEST;
-    static const std::string INFO_ALL_JOBS;
-    static const std::string INFO_SEL_JOBS;
+    static const std::string INFO_REQUESTS;
+    static const std::string FILTER_REQ_NUM;
+    static const std::string FILTER_OPERATION;
+    static const std::string FILTER_REQ_STATE;
+    static const std::string FILTER_TAPE_ID;
+    static const std::string FILTER_TAPE_POOL;
+    static const std::string PAGE;
+
+    static std::string genCondition(const std::string& filter,
+            std::string value);
+    static std::string genWhere(const std::list<std::string>& conditions);
+    static std::string genPage(const char *order, long limit, long offset);
 
     static void getObjects(LTFSDmCommServer *command, long localReqNumber,
             unsigned long pid, long requestNumber, FileOperation *fopt,
@@ -53,6 +63,7 @@ private:
     static void poolDeleteMessage(long key, LTFSDmCommServer *command);
     static void poolAddMessage(long key, LTFSDmCommServer *command);
     static void poolRemoveMessage(long key, LTFSDmCommServer *command);
+    static void poolLimitMessage(long key, LTFSDmCommServer *command);
     static void infoPoolsMessage(long key, LTFSDmCommServer *command);
     static void retrieveMessage(long key, LTFSDmCommServer *command);
 public:
@@ -130,8 +130,10 @@
     - create a Migration object
     - respond back to the client with a request number
     - MessageParser::getObjects: retrieving file names to migrate
-        - Migration::addJob: add migration information the the SQLite table JOB_QUEUE
+        - Migration::addJob: determine the migration information of each file
+        - JobStore::addJob: add the jobs of a message to the SQLite table JOB_QUEUE
     - Migration::addRequest: add a request to the SQLite table REQUEST_QUEUE
+      and to the scheduler's ready queue (Scheduler::queueRequest)
     - MessageParser::reqStatusMessage: provide updates of the migration processing to the client
 
     </TT>
@@ -165,6 +167,37 @@
     necessary for the client that initiated the request to receive progress
     information.
 
+    ### Parallel sessions
+
+    A migration request for a tape storage pool is not bound to a single
+    cartridge. While there are files left that have not been assigned to a
+    cartridge the request stays within the scheduler's ready queue and
+    can be scheduled on further cartridges of the same pool. Each time it
+    is scheduled an additional record for that cartridge (a session) is
+    added to the REQUEST_QUEUE table. Within Migration::processFiles each
+    session only assigns its share of the remaining files to its cartridge:
+    the size of the remaining files divided by the number of drives but at
+    least the size of the largest file and Const::MIN_MIG_SESSION_SIZE.
+    This way a large migration is processed by several drives in parallel.
+    The request is not scheduled on a further cartridge before the
+    session has assigned its share (Scheduler::sessionStarted); otherwise
+    a second cartridge could be mounted for files the first session is
+    about to take.
+
+    The files are assigned by Migration::assignJobs in decreasing order of
+    their size (first fit decreasing): a file is assigned if it fits into
+    the space that is left, otherwise the next smaller one is tried.
+    @snippet server/SQLStatements.cc migration_placement
+    Large files therefore are not left over for a further cartridge and
+    the cartridges are filled closer to their capacity. The assignment of
+    all sessions of a request is serialized by Migration::sessmtx.
+
+    After a session is finished the number of files is checked that have
+    not been assigned to any cartridge. If there are any the request is
+    set to DataBase::REQ_NEW and scheduled again. Otherwise the record
+    for the pool is marked as DataBase::REQ_COMPLETED. The request is
+    finished if all of its records are completed.
+
     ### Migration::processFiles
 
     The Migration::processFiles method is called twice first to transfer the
@@ -208,10 +241,13 @@
             before -> after [];
        }
        @enddot
-    -# A list is returned containing the inode numbers of these files where
-       the previous operation was successful. Change all corresponding jobs
-       to FsObj::TRANSFERRED or FsObj::MIGRATED depending of the migration
-       phase. The following changed indicates that data transfer stopped
+    -# Each job where the previous operation was successful is changed to
+       FsObj::TRANSFERRED or FsObj::MIGRATED depending of the migration
+       phase. These changes are collected by a JobStore::Batch. For
+       SQLJobStore they are committed in batches of Const::DB_BATCH_SIZE
+       jobs (or at least every Const::DB_BATCH_INTERVAL seconds) while the
+       files are processed.
+       The following changed indicates that data transfer stopped
        before file file.5:
        @dot
        digraph step_1 {
@@ -225,8 +261,8 @@
             before -> after [];
        }
        @enddot
-    -# The remaining jobs (those where no corresponding inode numbers were
-       in the list) have not been processed and need to be changed to the
+    -# The remaining jobs (those that have not been changed in the previous
+       step) have not been processed and need to be changed to the
        original state if these were still in FsObj::TRANSFERRING or
        FsObj::CHANGINGFSTATE state. Jobs that failed in the second step already
        have been marked as FsObj::FAILED. A reason for remaining jobs left
@@ -294,7 +330,12 @@
        state is to perform a proper cleanup in case the back end process
        terminates unexpectedly. See FuseFS::recoverState for recovery of
        a migration state.
-    -# The file data is transferred to tape.
+    -# The file data is transferred to tape. The modification time of the
+       source file is compared to the one recorded when the job has been
+       added (Migration::checkUnchanged). This happens before the
+       transfer, every Const::CHANGE_CHECK_SIZE bytes, and after the last
+       chunk. The comparison uses the already open file and therefore
+       does not need a path lookup.
     -# The corresponding tape id is added to the attributes of the file.
     -# The state in the JOB_QUEUE table is changed to TRANSFERRED since
        that data transfer was successful.
@@ -321,6 +362,11 @@
     -# The FILE_PATH attribute is set on the data file on tape.
     -# A symbolic link is created by recreating the original
        full path on tape pointing to the corresponding data file.
+       The directories of that path that already exist are remembered
+       per cartridge until it is unmounted. If the backend is started
+       with the -l option the links of all files of a session are
+       created together after the data transfers have finished
+       (Server::createLinks).
     -# The status object @ref Status "mrStatus" gets updated
        for the output statistics.
     -# The tape is added to the attribute of the data file on tape.
@@ -329,6 +375,33 @@
     Since the copy of data from disk to tape is performed in a loop by
     doing the reads and writes this loop is serialized by
     a std::mutex LTFSDMDrive::mtx.
+    The beginning of each file is read before that mutex is acquired
+    (see @ref data_mover).
+
+    Before each chunk (see @ref data_mover) is copied it is checked
+    if a request with a higher priority (e.g. a recall) requires the drive
+    (LTFSDMDrive::getToUnblock). In this case the data transfer is suspended
+    even if the file is only partially written. The number of bytes already
+    written and the cartridge id are stored within the JOB_QUEUE table
+    (columns RESUME_OFFSET and RESUME_TAPE_ID), the job is reset to its
+    previous state and the drive gets released. If the file is processed
+    later again on the same cartridge the data transfer continues at that
+    offset (LTFSDMS0119I). If it is processed on a different cartridge or the
+    data on tape is shorter than expected the data transfer restarts from
+    the beginning of the file. The partially written data on the other
+    cartridge is removed if that cartridge is mounted
+    (Migration::removePartialData), otherwise LTFSDMS0131W is reported. The modification time recorded when the
+    job was added is compared again before a resumed transfer continues,
+    so data written before the suspension is only kept if the file has
+    not been changed since. During the transfer the modification time is
+    checked every Const::CHANGE_CHECK_SIZE bytes and after the last chunk.
+
+    Files smaller than TapeContainer::threshold are not written to a
+    separate file on tape. Migration::writeMember appends their data to
+    a container that is shared by all data transfers of the session
+    (see @ref tape_container). For these files the FILE_PATH attribute
+    and the symbolic link are omitted and the data transfer is not
+    suspended once it has started.
 
     ### Migration::changeFileState
 
@@ -350,6 +423,7 @@
  */
 
 std::mutex Migration::pmigmtx;
+std::mutex Migration::sessmtx;
 
 ThreadPool<Migration, int, std::string, std::string, std::string, bool> Migration::swq(
         &Migration::execRequest, Const::MAX_STUBBING_THREADS, "stub2-wq");
@@ -412,7 +486,6 @@ void Migration::addJob(std::string fileName)
     int replNum;
     struct stat statbuf;
     FsObj::file_state state;
-    SQLStatement stmt;
     fuid_t fuid;
 
     try {
@@ -427,18 +500,18 @@ void Migration::addJob(std::string fileName)
         state = checkState(fileName, &fso);
 
         fuid = fso.getfuid();
-        stmt(Migration::ADD_JOB) << DataBase::MIGRATION << fileName << reqNumber
-                << targetState << statbuf.st_size << fuid.fsid_h << fuid.fsid_l
-                << fuid.igen << fuid.inum << statbuf.st_mtim.tv_sec
-                << statbuf.st_mtim.tv_nsec << time(NULL) << state;
         requestSize += fso.stat().st_size;
     } catch (const std::exception& e) {
         MSG(LTFSDMS0077E, fileName);
         TRACE(Trace::error, e.what());
-        stmt(Migration::ADD_JOB) << DataBase::MIGRATION << fileName << reqNumber
-                << targetState << Const::UNSET << Const::UNSET << Const::UNSET
-                << Const::UNSET << Const::UNSET << 0 << 0 << time(NULL)
-                << FsObj::FAILED;
+        statbuf.st_size = Const::UNSET;
+        statbuf.st_mtim.tv_sec = 0;
+        statbuf.st_mtim.tv_nsec = 0;
+        fuid.fsid_h = Const::UNSET;
+        fuid.fsid_l = Const::UNSET;
+        fuid.igen = Const::UNSET;
+        fuid.inum = Const::UNSET;
+        state = FsObj::FAILED;
     }
 
     replNum = Const::UNSET;
@@ -446,21 +519,13 @@ void Migration::addJob(std::string fileName)
     if (pools.size() == 0)
         pools.insert("");
 
-    TRACE(Trace::normal, stmt.str());
-
     for (std::string pool : pools) {
-        TRACE(Trace::full, stmt.str());
-        try {
-            replNum++;
-            stmt.prepare();
-            stmt.bind(1, replNum);
-            stmt.bind(2, pool);
-            stmt.step();
-            stmt.finalize();
-        } catch (const std::exception& e) {
-            TRACE(Trace::error, e.what());
-            MSG(LTFSDMS0028E, fileName);
-        }
+        replNum++;
+        jobs.push_back(
+                (JobStore::job_t ) { DataBase::MIGRATION, fileName, reqNumber,
+                                targetState, replNum, pool, statbuf.st_size,
+                                fuid, statbuf.st_mtim.tv_sec,
+                                statbuf.st_mtim.tv_nsec, state, "", 0, 0 });
         TRACE(Trace::always, fileName, replNum, pool);
     }
 
@@ -490,8 +555,10 @@ void Migration::addRequest()
     for (std::string pool : pools) {
         replNum++;
 
+        time_t timeAdded = time(NULL);
+
         stmt(Migration::ADD_REQUEST) << DataBase::MIGRATION << reqNumber
-                << targetState << numReplica << replNum << pool << time(NULL)
+                << targetState << numReplica << replNum << pool << timeAdded
                 << (needsTape ? DataBase::REQ_NEW : DataBase::REQ_INPROGRESS);
 
         TRACE(Trace::normal, stmt.str());
@@ -501,6 +568,9 @@ void Migration::addRequest()
         TRACE(Trace::always, needsTape, reqNumber, pool);
 
         if (needsTape) {
+            Scheduler::queueRequest( { DataBase::MIGRATION, reqNumber,
+                    targetState, numReplica, replNum, pool, "", "", timeAdded,
+                    Scheduler::smallestMigJob(reqNumber, replNum) });
             Scheduler::invoke();
         } else {
             swq.enqueue(reqNumber,
@@ -512,32 +582,174 @@ void Migration::addRequest()
     swq.waitCompletion(reqNumber);
 }
 
+struct stat Migration::checkUnchanged(FsObj *source, std::string fileName,
+        long secs, long nsecs)
+
+{
+    struct stat statbuf;
+
+    try {
+        statbuf = source->stat();
+    } catch (const std::exception& e) {
+        TRACE(Trace::error, e.what());
+        MSG(LTFSDMS0040E, fileName);
+        THROW(Error::GENERAL_ERROR, fileName);
+    }
+
+    if (statbuf.st_mtim.tv_sec != secs || statbuf.st_mtim.tv_nsec != nsecs) {
+        TRACE(Trace::error, statbuf.st_mtim.tv_sec, secs,
+                statbuf.st_mtim.tv_nsec, nsecs);
+        MSG(LTFSDMS0041W, fileName);
+        THROW(Error::GENERAL_ERROR, fileName);
+    }
+
+    return statbuf;
+}
+
+void Migration::writeMember(FsObj *source, std::string tapeId,
+        std::string driveId, long secs, long nsecs, mig_info_t mig_info,
+        std::shared_ptr<bool> suspended, TapeContainer *container, long size)
+
+{
+    DataMover mover(inventory->getBlockSize());
+    std::shared_ptr<LTFSDMDrive> drive = inventory->getDrive(driveId);
+    long rsize;
+    long offset = 0;
+    long memberOffset;
+    long startBlock;
+    int fd;
+
+    mover.readAhead(source, 0, size, drive->pool);
+
+    std::lock_guard<std::mutex> writelock(*drive->mtx);
+
+    if (drive->getToUnblock() < DataBase::MIGRATION) {
+        TRACE(Trace::always, mig_info.fileName, tapeId);
+        std::lock_guard<std::mutex> lock(Migration::pmigmtx);
+        *suspended = true;
+        THROW(Error::OK);
+    }
+
+    fd = container->prepare(size);
+    memberOffset = container->getOffset();
+
+    try {
+        while (offset < size) {
+            if (Server::forcedTerminate)
+                THROW(Error::OK);
+
+            rsize = mover.toTape(source, offset, fd, size - offset);
+            if (rsize <= 0) {
+                TRACE(Trace::error, errno, rsize);
+                MSG(LTFSDMS0125E, mig_info.fileName,
+                        container->getTapeName().c_str());
+                THROW(Error::GENERAL_ERROR, mig_info.fileName, rsize);
+            }
+
+            offset += rsize;
+        }
+
+        checkUnchanged(source, mig_info.fileName, secs, nsecs);
+    } catch (const std::exception& e) {
+        container->discard();
+        throw;
+    }
+
+    startBlock = container->addMember(mig_info.fileName, size);
+
+    source->addTapeAttr(tapeId, startBlock, container->getId(), memberOffset);
+}
+
+void Migration::removePartialData(FsObj *source, mig_info_t mig_info)
+
+{
+    std::shared_ptr<LTFSDMCartridge> cart;
+    std::string tapeName = Server::getTapeName(source, mig_info.resumeTapeId);
+    bool mounted = false;
+
+    {
+        std::lock_guard<std::recursive_mutex> lock(LTFSDMInventory::mtx);
+        cart = inventory->getCartridge(mig_info.resumeTapeId);
+        mounted = cart != nullptr
+                && (cart->getState() == LTFSDMCartridge::TAPE_MOUNTED
+                        || cart->getState() == LTFSDMCartridge::TAPE_INUSE);
+    }
+
+    // accessing a cartridge that is not mounted would mount it
+    if (mounted && unlink(tapeName.c_str()) == 0) {
+        MSG(LTFSDMS0130I, mig_info.fileName, mig_info.resumeTapeId);
+        return;
+    }
+
+    TRACE(Trace::error, tapeName, mounted, errno);
+    MSG(LTFSDMS0131W, mig_info.fileName, mig_info.resumeTapeId);
+}
+
 unsigned long Migration::transferData(std::string tapeId, std::string driveId,
         long secs, long nsecs, Migration::mig_info_t mig_info,
-        std::shared_ptr<std::list<unsigned long>> inumList,
-        std::shared_ptr<bool> suspended)
+        std::shared_ptr<JobStore::Batch> successes,
+        std::shared_ptr<bool> suspended,
+        std::shared_ptr<TapeContainer> container)
 
 {
-    struct stat statbuf, statbuf_changed;
+    struct stat statbuf, statbuf_tape;
     std::string tapeName;
-    char buffer[Const::READ_BUFFER_SIZE];
+    DataMover mover(inventory->getBlockSize());
     long rsize;
-    long wsize;
     int fd = -1;
     long offset = 0;
+    long checked = 0;
     bool failed = false;
+    bool resume = false;
+    std::shared_ptr<LTFSDMDrive> drive = inventory->getDrive(driveId);
 
     try {
         FsObj source(mig_info.fileName);
 
-        TRACE(Trace::always, mig_info.fileName);
+        TRACE(Trace::always, mig_info.fileName, mig_info.resumeOffset,
+                mig_info.resumeTapeId);
+
+        std::unique_lock<FsObj> fsolock(source);
+
+        source.preparePremigration();
+
+        fsolock.unlock();
+
+        statbuf = checkUnchanged(&source, mig_info.fileName, secs, nsecs);
+
+        if (mig_info.resumeOffset > 0 && mig_info.resumeTapeId.size() > 0
+                && mig_info.resumeTapeId.compare(tapeId) != 0)
+            removePartialData(&source, mig_info);
+
+        if (container != nullptr
+                && (unsigned long) statbuf.st_size
+                        < TapeContainer::threshold) {
+            writeMember(&source, tapeId, driveId, secs, nsecs, mig_info,
+                    suspended, container.get(), statbuf.st_size);
+
+            mrStatus.updateSuccess(mig_info.reqNumber, mig_info.fromState,
+                    mig_info.toState);
+
+            successes->setState(std::bind(&Migration::failTransfer, mig_info),
+                    mig_info.jobId, FsObj::TRANSFERRING, mig_info.toState);
+
+            return statbuf.st_size;
+        }
 
         tapeName = Server::getTapeName(&source, tapeId);
 
         Server::createDataDir(tapeId);
 
+        /*
+         * If the data transfer of this file has been suspended before
+         * on the same cartridge the data already written is kept.
+         */
+        if (mig_info.resumeOffset > 0
+                && mig_info.resumeTapeId.compare(tapeId) == 0)
+            resume = true;
+
         fd = Server::openTapeRetry(tapeId, tapeName.c_str(),
-        O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC);
+                O_RDWR | O_CREAT | O_CLOEXEC | (resume ? 0 : O_TRUNC));
 
         if (fd == -1) {
             TRACE(Trace::error, errno);
@@ -545,75 +757,69 @@ unsigned long Migration::transferData(std::string tapeId, std::string driveId,
             THROW(Error::GENERAL_ERROR, tapeName, errno);
         }
 
-        std::unique_lock<FsObj> fsolock(source);
+        if (resume) {
+            if (fstat(fd, &statbuf_tape) == 0
+                    && (unsigned long) statbuf_tape.st_size
+                            >= mig_info.resumeOffset
+                    && lseek(fd, mig_info.resumeOffset, SEEK_SET)
+                            == (off_t) mig_info.resumeOffset) {
+                offset = mig_info.resumeOffset;
+                MSG(LTFSDMS0119I, mig_info.fileName, offset);
+            } else if (ftruncate(fd, 0) == -1) {
+                TRACE(Trace::error, errno);
+                MSG(LTFSDMS0022E, tapeName.c_str());
+                THROW(Error::GENERAL_ERROR, mig_info.fileName, errno);
+            }
+        }
 
-        source.preparePremigration();
+        checked = offset;
 
-        fsolock.unlock();
-
-        if (stat(mig_info.fileName.c_str(), &statbuf) == -1) {
-            TRACE(Trace::error, errno);
-            MSG(LTFSDMS0040E, mig_info.fileName);
-            THROW(Error::GENERAL_ERROR, mig_info.fileName, errno);
-        }
-        if (statbuf.st_mtim.tv_sec != secs
-                || statbuf.st_mtim.tv_nsec != nsecs) {
-            TRACE(Trace::error, statbuf.st_mtim.tv_sec, secs,
-                    statbuf.st_mtim.tv_nsec, nsecs);
-            MSG(LTFSDMS0041W, mig_info.fileName);
-            THROW(Error::GENERAL_ERROR, mig_info.fileName);
-        }
+        mover.readAhead(&source, offset, statbuf.st_size - offset, drive->pool);
 
         {
-            std::lock_guard<std::mutex> writelock(
-                    *inventory->getDrive(driveId)->mtx);
-
-            if (inventory->getDrive(driveId)->getToUnblock()
-                    < DataBase::MIGRATION) {
-                TRACE(Trace::always, mig_info.fileName, tapeId);
-                std::lock_guard<std::mutex> lock(Migration::pmigmtx);
-                *suspended = true;
-                THROW(Error::OK);
-            }
+            std::lock_guard<std::mutex> writelock(*drive->mtx);
 
             while (offset < statbuf.st_size) {
                 if (Server::forcedTerminate)
                     THROW(Error::OK);
 
-                rsize = source.read(offset,
-                        statbuf.st_size - offset > Const::READ_BUFFER_SIZE ?
-                                Const::READ_BUFFER_SIZE :
-                                statbuf.st_size - offset, buffer);
-                if (rsize == -1) {
-                    TRACE(Trace::error, errno);
-                    MSG(LTFSDMS0023E, mig_info.fileName);
-                    THROW(Error::GENERAL_ERROR, errno, mig_info.fileName);
+                /*
+                 * A request with a higher priority needs this drive: stop
+                 * after the current chunk and remember how much data has
+                 * been written such that the transfer can be resumed later.
+                 */
+                if (drive->getToUnblock() < DataBase::MIGRATION) {
+                    TRACE(Trace::always, mig_info.fileName, tapeId, offset);
+                    jobStore->setResumeOffset(mig_info.jobId, offset, tapeId);
+                    if (offset > 0)
+                        MSG(LTFSDMS0118I, mig_info.fileName, offset);
+                    std::lock_guard<std::mutex> lock(Migration::pmigmtx);
+                    *suspended = true;
+                    THROW(Error::OK);
                 }
 
-                wsize = write(fd, buffer, rsize);
-
-                if (wsize != rsize) {
-                    TRACE(Trace::error, errno, wsize, rsize);
-                    MSG(LTFSDMS0022E, tapeName.c_str());
-                    THROW(Error::GENERAL_ERROR, mig_info.fileName, wsize,
-                            rsize);
+                rsize = mover.toTape(&source, offset, fd,
+                        statbuf.st_size - offset);
+                if (rsize <= 0) {
+                    TRACE(Trace::error, errno, rsize);
+                    MSG(LTFSDMS0125E, mig_info.fileName, tapeName.c_str());
+                    THROW(Error::GENERAL_ERROR, mig_info.fileName, rsize);
                 }
 
                 offset += rsize;
-                if (stat(mig_info.fileName.c_str(), &statbuf_changed) == -1) {
-                    TRACE(Trace::error, errno);
-                    MSG(LTFSDMS0040E, mig_info.fileName);
-                    THROW(Error::GENERAL_ERROR, mig_info.fileName, errno);
-                }
 
-                if (statbuf_changed.st_mtim.tv_sec != secs
-                        || statbuf_changed.st_mtim.tv_nsec != nsecs) {
-                    TRACE(Trace::error, statbuf_changed.st_mtim.tv_sec, secs,
-                            statbuf_changed.st_mtim.tv_nsec, nsecs);
-                    MSG(LTFSDMS0041W, mig_info.fileName);
-                    THROW(Error::GENERAL_ERROR, mig_info.fileName);
+                /*
+                 * A modification only is detected early to stop writing
+                 * useless data. The check after the last chunk ensures
+                 * that the data on tape corresponds to the time stamp.
+                 */
+                if (offset - checked >= Const::CHANGE_CHECK_SIZE) {
+                    checkUnchanged(&source, mig_info.fileName, secs, nsecs);
+                    checked = offset;
                 }
             }
+
+            checkUnchanged(&source, mig_info.fileName, secs, nsecs);
         }
 
         if (fsetxattr(fd, Const::LTFS_ATTR.c_str(), mig_info.fileName.c_str(),
@@ -623,15 +829,19 @@ unsigned long Migration::transferData(std::string tapeId, std::string driveId,
             THROW(Error::GENERAL_ERROR, mig_info.fileName, errno);
         }
 
-        Server::createLink(tapeId, mig_info.fileName, tapeName);
+        if (Server::lazyLinks)
+            inventory->getCartridge(tapeId)->addPendingLink(mig_info.fileName,
+                    tapeName);
+        else
+            Server::createLink(tapeId, mig_info.fileName, tapeName);
 
         mrStatus.updateSuccess(mig_info.reqNumber, mig_info.fromState,
                 mig_info.toState);
 
-        source.addTapeAttr(tapeId, Server::getStartBlock(tapeName, fd));
+        source.addTapeAttr(tapeId, Server::getStartBlock(tapeName, fd), 0, 0);
 
-        std::lock_guard<std::mutex> lock(Migration::pmigmtx);
-        inumList->push_back(mig_info.inum);
+        successes->setState(std::bind(&Migration::failTransfer, mig_info),
+                mig_info.jobId, FsObj::TRANSFERRING, mig_info.toState);
     } catch (const LTFSDMException& e) {
         TRACE(Trace::error, e.what());
         if (e.getError() != Error::OK)
@@ -646,11 +856,7 @@ unsigned long Migration::transferData(std::string tapeId, std::string driveId,
         MSG(LTFSDMS0050E, mig_info.fileName);
         mrStatus.updateFailed(mig_info.reqNumber, mig_info.fromState);
 
-        SQLStatement stmt = SQLStatement(Migration::FAIL_PREMIGRATION)
-                << FsObj::FAILED << mig_info.reqNumber << mig_info.fileName
-                << mig_info.replNum;
-
-        stmt.doall();
+        jobStore->failJob(mig_info.jobId);
     }
 
     if (fd != -1)
@@ -659,9 +865,18 @@ unsigned long Migration::transferData(std::string tapeId, std::string driveId,
     return statbuf.st_size;
 }
 
+void Migration::failTransfer(Migration::mig_info_t mig_info)
+
+{
+    // the transfer already has been counted as successful
+    MSG(LTFSDMS0050E, mig_info.fileName);
+    mrStatus.updateFailed(mig_info.reqNumber, mig_info.toState);
+
+    jobStore->failJob(mig_info.jobId);
+}
+
 void Migration::changeFileState(Migration::mig_info_t mig_info,
-        std::shared_ptr<std::list<unsigned long>> inumList,
-        FsObj::file_state toState)
+        std::shared_ptr<JobStore::Batch> successes, FsObj::file_state toState)
 
 {
     try {
@@ -696,9 +911,6 @@ void Migration::changeFileState(Migration::mig_info_t mig_info,
         } else {
             source.finishPremigration();
         }
-
-        std::lock_guard<std::mutex> lock(Migration::pmigmtx);
-        inumList->push_back(mig_info.inum);
     } catch (const std::exception& e) {
         TRACE(Trace::error, e.what());
         MSG(LTFSDMS0089E, mig_info.fileName);
@@ -706,16 +918,61 @@ void Migration::changeFileState(Migration::mig_info_t mig_info,
         for (int i = 0; i < mig_info.numRepl; i++)
             mrStatus.updateFailed(mig_info.reqNumber, mig_info.fromState);
 
-        SQLStatement stmt = SQLStatement(Migration::FAIL_STUBBING)
-                << FsObj::FAILED << mig_info.reqNumber << mig_info.fileName;
-
-        stmt.doall();
+        jobStore->failReplicas(mig_info.reqNumber, mig_info.jobId);
         return;
     }
 
     for (int i = 0; i < (mig_info.numRepl ? mig_info.numRepl : 1); i++)
         mrStatus.updateSuccess(mig_info.reqNumber, mig_info.fromState,
                 mig_info.toState);
+
+    successes->setState(std::bind(&Migration::failStateChange, mig_info),
+            mig_info.jobId, FsObj::CHANGINGFSTATE, toState);
+}
+
+void Migration::failStateChange(Migration::mig_info_t mig_info)
+
+{
+    // the state change already has been counted as successful
+    MSG(LTFSDMS0089E, mig_info.fileName);
+
+    for (int i = 0; i < (mig_info.numRepl ? mig_info.numRepl : 1); i++)
+        mrStatus.updateFailed(mig_info.reqNumber, mig_info.toState);
+
+    jobStore->failReplicas(mig_info.reqNumber, mig_info.jobId);
+}
+
+int Migration::assignJobs(int replNum, std::string tapeId,
+        FsObj::file_state fromState, unsigned long freeSpace,
+        unsigned long minSize)
+
+{
+    std::shared_ptr<JobStore::Batch> assign = jobStore->createBatch();
+    std::vector<long> rowIds;
+
+    /*
+     * First fit decreasing: the largest files are placed first, smaller
+     * ones fill the space that is left. The selection stops as soon as
+     * not even the smallest file fits anymore.
+     */
+    jobStore->selectUnassigned(reqNumber, replNum, fromState,
+            [&freeSpace, minSize, &rowIds](long rowId, unsigned long size) {
+                if (freeSpace < minSize)
+                    return false;
+                if (size <= freeSpace) {
+                    freeSpace -= size;
+                    rowIds.push_back(rowId);
+                }
+                return true;
+            });
+
+    TRACE(Trace::always, tapeId, rowIds.size(), freeSpace);
+
+    for (long id : rowIds)
+        assign->assignTape(id, tapeId, fromState, FsObj::TRANSFERRING);
+    assign->flush();
+
+    return rowIds.size();
 }
 
 Migration::req_return_t Migration::processFiles(int replNum, std::string tapeId,
@@ -723,19 +980,15 @@ Migration::req_return_t Migration::processFiles(int replNum, std::string tapeId,
 
 {
     SQLStatement stmt;
-    std::string fileName;
     Migration::req_return_t retval = (Migration::req_return_t ) { false, false };
     time_t start;
-    long secs;
-    long nsecs;
-    unsigned long inum;
     time_t steptime;
-    std::shared_ptr<std::list<unsigned long>> inumList = std::make_shared<
-            std::list<unsigned long>>();
+    std::shared_ptr<JobStore::Batch> successes = jobStore->createBatch();
     std::shared_ptr<bool> suspended = std::make_shared<bool>(false);
+    std::shared_ptr<TapeContainer> container = nullptr;
     unsigned long freeSpace = 0;
     int num_found = 0;
-    int total = 0;
+    JobStore::unclaimed_t unclaimed;
     FsObj::file_state newState;
     std::shared_ptr<LTFSDMDrive> drive = nullptr;
 
@@ -748,14 +1001,10 @@ Migration::req_return_t Migration::processFiles(int replNum, std::string tapeId,
     }
 
     if (toState == FsObj::TRANSFERRED) {
-        for (std::shared_ptr<LTFSDMDrive> d : inventory->getDrives()) {
-            if (d->get_le()->get_slot()
-                    == inventory->getCartridge(tapeId)->get_le()->get_slot()) {
-                drive = d;
-                break;
-            }
-        }
+        drive = inventory->getMountingDrive(inventory->getCartridge(tapeId));
         assert(drive != nullptr);
+        if (TapeContainer::threshold > 0)
+            container = std::make_shared<TapeContainer>(tapeId);
     }
 
     newState = (
@@ -763,73 +1012,96 @@ Migration::req_return_t Migration::processFiles(int replNum, std::string tapeId,
                     FsObj::TRANSFERRING : FsObj::CHANGINGFSTATE);
 
     if (toState == FsObj::TRANSFERRED) {
+        std::lock_guard<std::mutex> lock(Migration::sessmtx);
+
         freeSpace =
                 1024 * 1024
                         * inventory->getCartridge(tapeId)->get_le()->get_remaining_cap();
-        stmt(Migration::SET_TRANSFERRING) << newState << tapeId << reqNumber
-                << fromState << replNum << (unsigned long) &freeSpace
-                << (unsigned long) &num_found << (unsigned long) &total;
-    } else {
-        stmt(Migration::SET_CHANGE_STATE) << newState << reqNumber << fromState
-                << tapeId << replNum;
-    }
-    TRACE(Trace::normal, stmt.str());
-    steptime = time(NULL);
-    stmt.doall();
 
-    TRACE(Trace::always, time(NULL) - steptime, num_found, total);
-    if (total > num_found)
-        retval.remaining = true;
+        /*
+         * Several sessions on different cartridges can process the same
+         * migration request in parallel. Each session only takes its share
+         * of the remaining files (see SchedulerPolicy::migrationShare).
+         */
+        unclaimed = jobStore->unclaimed(reqNumber, replNum, fromState);
 
-    stmt(Migration::SELECT_JOBS) << reqNumber << newState << tapeId;
-    TRACE(Trace::normal, stmt.str());
-    stmt.prepare();
-    start = time(NULL);
-    while (stmt.step(&fileName, &secs, &nsecs, &inum)) {
-        if (Server::terminate == true)
-            break;
+        freeSpace = SchedulerPolicy::migrationShare(unclaimed.size,
+                unclaimed.maxSize, inventory->getDrives().size(), freeSpace);
 
-        try {
-            Migration::mig_info_t mig_info = { fileName, reqNumber, numReplica,
-                    replNum, inum, "", fromState, toState };
+        steptime = time(NULL);
+        num_found = assignJobs(replNum, tapeId, fromState, freeSpace,
+                unclaimed.minSize);
+        TRACE(Trace::always, time(NULL) - steptime, num_found, unclaimed.num);
 
-            TRACE(Trace::always, fileName, reqNumber);
+        if (unclaimed.num > num_found) {
+            retval.remaining = true;
+            Scheduler::sessionStarted(reqNumber, replNum);
+            Scheduler::invoke();
+        } else {
+            // all files are assigned to sessions: nothing left to schedule
+            stmt(Migration::UPDATE_REQUEST) << DataBase::REQ_INPROGRESS
+                    << reqNumber << replNum << "";
+            stmt.doall();
+            Scheduler::completeRequest(reqNumber, replNum, "");
+        }
+    } else {
+        jobStore->changeState( { reqNumber }, replNum, tapeId, fromState,
+                newState);
+    }
 
-            if (toState == FsObj::TRANSFERRED) {
-                if (drive->getToUnblock() < DataBase::MIGRATION) {
-                    retval.suspended = true;
-                    break;
+    start = time(NULL);
+    jobStore->selectMigJobs(reqNumber, tapeId, newState,
+            [&](const JobStore::mig_job_t& job) {
+                if (Server::terminate == true)
+                    return false;
+
+                try {
+                    Migration::mig_info_t mig_info = { job.fileName, reqNumber,
+                            numReplica, replNum, job.inum, "", fromState,
+                            toState, job.resumeOffset, job.resumeTapeId,
+                            job.jobId };
+
+                    TRACE(Trace::always, job.fileName, reqNumber);
+
+                    if (toState == FsObj::TRANSFERRED) {
+                        if (drive->getToUnblock() < DataBase::MIGRATION) {
+                            retval.suspended = true;
+                            return false;
+                        }
+                        TRACE(Trace::full, job.mtimeSec, job.mtimeNsec);
+                        drive->wqp->enqueue(reqNumber, tapeId,
+                                drive->get_le()->GetObjectID(), job.mtimeSec,
+                                job.mtimeNsec, mig_info, successes, suspended,
+                                container);
+                    } else {
+                        Server::wqs->enqueue(reqNumber, mig_info, successes,
+                                toState);
+                    }
+                } catch (const std::exception& e) {
+                    TRACE(Trace::error, e.what());
+                    return true;
                 }
-                TRACE(Trace::full, secs, nsecs);
-                drive->wqp->enqueue(reqNumber, tapeId,
-                        drive->get_le()->GetObjectID(), secs, nsecs, mig_info,
-                        inumList, suspended);
-            } else {
-                Server::wqs->enqueue(reqNumber, mig_info, inumList, toState);
-            }
-        } catch (const std::exception& e) {
-            TRACE(Trace::error, e.what());
-            continue;
-        }
 
-        if (time(NULL) - start < 10)
-            continue;
+                if (time(NULL) - start < 10)
+                    return true;
 
-        start = time(NULL);
+                start = time(NULL);
 
-        std::lock_guard<std::mutex> lock(Scheduler::updmtx);
-        Scheduler::updReq[reqNumber] = true;
-        Scheduler::updcond.notify_all();
-    }
+                std::lock_guard<std::mutex> lock(Scheduler::updmtx);
+                Scheduler::updReq[reqNumber] = true;
+                Scheduler::updcond.notify_all();
+                return true;
+            });
     {
         std::lock_guard<std::mutex> lock(Scheduler::updmtx);
         Scheduler::updReq[reqNumber] = true;
         Scheduler::updcond.notify_all();
     }
-    stmt.finalize();
 
     if (toState == FsObj::TRANSFERRED) {
         drive->wqp->waitCompletion(reqNumber);
+        if (container != nullptr)
+            container->finish();
     } else {
         Server::wqs->waitCompletion(reqNumber);
     }
@@ -837,18 +1109,11 @@ Migration::req_return_t Migration::processFiles(int replNum, std::string tapeId,
     if (*suspended == true)
         retval.suspended = true;
 
-    stmt(Migration::SET_JOB_SUCCESS) << toState << reqNumber << newState
-            << tapeId << genInumString(*inumList);
-    TRACE(Trace::normal, stmt.str());
-    steptime = time(NULL);
-    stmt.doall();
-    TRACE(Trace::always, time(NULL) - steptime);
+    successes->flush();
 
-    stmt(Migration::RESET_JOB_STATE) << fromState << reqNumber << newState
-            << tapeId;
-    TRACE(Trace::normal, stmt.str());
     steptime = time(NULL);
-    stmt.doall();
+    jobStore->changeState( { reqNumber }, Const::UNSET, tapeId, newState,
+            fromState);
     TRACE(Trace::always, time(NULL) - steptime);
 
     return retval;
@@ -885,6 +1150,8 @@ void Migration::execRequest(int replNum, std::string driveId, std::string pool,
         retval = processFiles(replNum, tapeId, FsObj::RESIDENT,
                 FsObj::TRANSFERRED);
 
+        Server::createLinks(tapeId);
+
         try {
             if ((rc = inventory->getCartridge(tapeId)->get_le()->Sync()) != 0)
                 THROW(Error::GENERAL_ERROR, rc);
@@ -892,12 +1159,8 @@ void Migration::execRequest(int replNum, std::string driveId, std::string pool,
             TRACE(Trace::error, errno);
             MSG(LTFSDMS0024E, tapeId);
 
-            stmt(Migration::FAIL_PREMIGRATED) << FsObj::FAILED << reqNumber
-                    << FsObj::PREMIGRATED << tapeId << replNum;
-
-            TRACE(Trace::error, stmt.str());
-
-            stmt.doall();
+            jobStore->changeState( { reqNumber }, replNum, tapeId,
+                    FsObj::PREMIGRATED, FsObj::FAILED);
 
             std::unique_lock<std::mutex> lock(Scheduler::updmtx);
             TRACE(Trace::error, reqNumber);
@@ -923,16 +1186,21 @@ void Migration::execRequest(int replNum, std::string driveId, std::string pool,
         Scheduler::invoke();
     }
 
+    /*
+     * A session that has been resumed after a restart (see
+     * Migration::resumeRequests) does not need a tape for the jobs
+     * already transferred to its cartridge.
+     */
     if (!failed) {
         if (targetState == FsObj::MIGRATED) {
-            if (needsTape)
+            if (tapeId.compare("") != 0)
                 processFiles(replNum, tapeId, FsObj::TRANSFERRED,
                         FsObj::MIGRATED);
             else
                 processFiles(replNum, tapeId, FsObj::PREMIGRATED,
                         FsObj::MIGRATED);
         } else {
-            if (needsTape)
+            if (tapeId.compare("") != 0)
                 processFiles(replNum, tapeId, FsObj::TRANSFERRED,
                         FsObj::PREMIGRATED);
         }
@@ -940,20 +1208,42 @@ void Migration::execRequest(int replNum, std::string driveId, std::string pool,
 
     std::unique_lock<std::mutex> updlock(Scheduler::updmtx);
 
-    if (retval.suspended)
-        stmt(Migration::UPDATE_REQUEST) << DataBase::REQ_NEW << reqNumber
-                << replNum;
-    else if (retval.remaining)
-        stmt(Migration::UPDATE_REQUEST_RESET_TAPE) << DataBase::REQ_NEW
-                << reqNumber << replNum;
-    else
-        stmt(Migration::UPDATE_REQUEST) << DataBase::REQ_COMPLETED << reqNumber
-                << replNum;
+    stmt(Migration::UPDATE_REQUEST) << DataBase::REQ_COMPLETED << reqNumber
+            << replNum << tapeId;
 
     TRACE(Trace::normal, stmt.str());
 
     stmt.doall();
 
+    /*
+     * The session on this cartridge is finished. If there are still files
+     * that have not been processed by any session (the cartridge is full,
+     * the session only took its share, or it has been suspended) the
+     * request needs to be scheduled again. Otherwise the request for the
+     * pool is completed once all sessions are finished.
+     */
+    if (needsTape) {
+        std::lock_guard<std::mutex> lock(Migration::sessmtx);
+        int unclaimed = jobStore->unclaimed(reqNumber, replNum,
+                FsObj::RESIDENT).num;
+
+        TRACE(Trace::always, reqNumber, replNum, tapeId, unclaimed,
+                retval.suspended, retval.remaining);
+
+        if (unclaimed > 0) {
+            stmt(Migration::UPDATE_REQUEST) << DataBase::REQ_NEW << reqNumber
+                    << replNum << "";
+            stmt.doall();
+            Scheduler::requeueRequest(reqNumber, replNum, tapeId, true);
+        } else {
+            stmt(Migration::UPDATE_REQUEST) << DataBase::REQ_COMPLETED
+                    << reqNumber << replNum << "";
+            stmt.doall();
+            Scheduler::completeRequest(reqNumber, replNum, tapeId);
+            Scheduler::completeRequest(reqNumber, replNum, "");
+        }
+    }
+
     Scheduler::updReq[reqNumber] = true;
     Scheduler::updcond.notify_all();
 
@@ -964,3 +1254,99 @@ void Migration::execRequest(int replNum, std::string driveId, std::string pool,
     if (retval.suspended || retval.remaining)
         Scheduler::invoke();
 }
+
+int Migration::resumeRequests(SubServer& subs)
+
+{
+    SQLStatement stmt;
+    Scheduler::request_t req;
+    std::list<Scheduler::request_t> reqs;
+    std::stringstream thrdinfo;
+    int unclaimed;
+    int resumed = 0;
+
+    // the state of files with an unfinished state change is unchanged
+    stmt(Migration::RESUME_UNASSIGNED_JOBS) << FsObj::PREMIGRATED
+            << DataBase::MIGRATION << FsObj::CHANGINGFSTATE;
+    stmt.doall();
+
+    stmt(Migration::RESUME_JOBS) << FsObj::TRANSFERRED << DataBase::MIGRATION
+            << FsObj::CHANGINGFSTATE;
+    stmt.doall();
+
+    // partially written data is reused if the same cartridge is selected
+    stmt(Migration::RESUME_TRANSFERS) << FsObj::RESIDENT << DataBase::MIGRATION
+            << FsObj::TRANSFERRING;
+    stmt.doall();
+
+    stmt(Migration::DELETE_SESSIONS) << DataBase::MIGRATION
+            << FsObj::TRANSFERRED;
+    stmt.doall();
+
+    req = (Scheduler::request_t ) { DataBase::MIGRATION, 0, 0, 0, 0, "", "",
+                    "", 0, 0 };
+    stmt(Migration::RESUME_REQUESTS) << DataBase::MIGRATION;
+    stmt.prepare();
+    while (stmt.step(&req.reqNum, &req.tgtState, &req.numRepl, &req.replNum,
+            &req.pool, &req.tapeId, &req.timeAdded))
+        reqs.push_back(req);
+    stmt.finalize();
+
+    for (Scheduler::request_t req : reqs) {
+        TRACE(Trace::always, req.reqNum, req.replNum, req.pool, req.tapeId);
+
+        thrdinfo.str("");
+        thrdinfo << "M(" << req.reqNum << "," << req.replNum << ","
+                << req.pool << ")";
+
+        // a session with files left that need to change their state
+        if (req.tapeId.compare("") != 0) {
+            stmt(Migration::UPDATE_REQUEST) << DataBase::REQ_INPROGRESS
+                    << req.reqNum << req.replNum << req.tapeId;
+            stmt.doall();
+            subs.enqueue(thrdinfo.str(), &Migration::execRequest,
+                    Migration(getpid(), req.reqNum, { }, req.numRepl,
+                            req.tgtState), req.replNum, "", req.pool,
+                    req.tapeId, false);
+            resumed++;
+            continue;
+        }
+
+        unclaimed = jobStore->unclaimed(req.reqNum, req.replNum,
+                FsObj::RESIDENT).num;
+
+        if (unclaimed > 0) {
+            stmt(Migration::UPDATE_REQUEST) << DataBase::REQ_NEW << req.reqNum
+                    << req.replNum << "";
+            stmt.doall();
+            req.minFileSize = Scheduler::smallestMigJob(req.reqNum,
+                    req.replNum);
+            Scheduler::queueRequest(req);
+            resumed++;
+            continue;
+        }
+
+        unclaimed = 0;
+        if (req.tgtState == FsObj::MIGRATED)
+            unclaimed = jobStore->unclaimed(req.reqNum, req.replNum,
+                    FsObj::PREMIGRATED).num;
+
+        if (unclaimed > 0) {
+            // premigrated files only: no tape is needed
+            stmt(Migration::UPDATE_REQUEST) << DataBase::REQ_INPROGRESS
+                    << req.reqNum << req.replNum << "";
+            stmt.doall();
+            subs.enqueue(thrdinfo.str(), &Migration::execRequest,
+                    Migration(getpid(), req.reqNum, { }, req.numRepl,
+                            req.tgtState), req.replNum, "", req.pool, "",
+                    false);
+            resumed++;
+        } else {
+            stmt(Migration::UPDATE_REQUEST) << DataBase::REQ_COMPLETED
+                    << req.reqNum << req.replNum << "";
+            stmt.doall();
+        }
+    }
+
+    return resumed;
+}
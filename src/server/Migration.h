@@ -18,6 +18,7 @@
 
 class Migration: public FileOperation
 {
+    friend class DataBase;
 private:
     unsigned long pid;
     int reqNumber;
@@ -35,22 +36,21 @@ private:
 
     FsObj::file_state checkState(std::string fileName, FsObj *fso);
 
-    static const std::string ADD_JOB;
     static const std::string ADD_REQUEST;
-    static const std::string FAIL_PREMIGRATION;
-    static const std::string FAIL_STUBBING;
-    static const std::string SET_TRANSFERRING;
-    static const std::string SET_CHANGE_STATE;
-    static const std::string SELECT_JOBS;
-    static const std::string SET_JOB_SUCCESS;
-    static const std::string RESET_JOB_STATE;
-    static const std::string FAIL_PREMIGRATED;
     static const std::string UPDATE_REQUEST;
-    static const std::string UPDATE_REQUEST_RESET_TAPE;
+    static const std::string RESUME_JOBS;
+    static const std::string RESUME_UNASSIGNED_JOBS;
+    static const std::string RESUME_TRANSFERS;
+    static const std::string DELETE_SESSIONS;
+    static const std::string RESUME_REQUESTS;
 
     static ThreadPool<Migration, int, std::string, std::string, std::string,
             bool> swq;
+    static std::mutex sessmtx;
 
+    int assignJobs(int replNum, std::string tapeId,
+            FsObj::file_state fromState, unsigned long freeSpace,
+            unsigned long minSize);
     req_return_t processFiles(int replNum, std::string tapeId,
             FsObj::file_state fromState, FsObj::file_state toState);
 public:
@@ -64,16 +64,29 @@ public:
         std::string poolName;
         FsObj::file_state fromState;
         FsObj::file_state toState;
+        unsigned long resumeOffset;
+        std::string resumeTapeId;
+        long jobId;
     };
     static std::mutex pmigmtx;
 
+    static struct stat checkUnchanged(FsObj *source, std::string fileName,
+            long secs, long nsecs);
+    static void removePartialData(FsObj *source, mig_info_t mig_info);
+    static void writeMember(FsObj *source, std::string tapeId,
+            std::string driveId, long secs, long nsecs, mig_info_t mig_info,
+            std::shared_ptr<bool> suspended, TapeContainer *container,
+            long size);
     static unsigned long transferData(std::string tapeId, std::string driveId,
             long secs, long nsecs, mig_info_t miginfo,
-            std::shared_ptr<std::list<unsigned long>> inumList,
-            std::shared_ptr<bool>);
+            std::shared_ptr<JobStore::Batch> successes,
+            std::shared_ptr<bool> suspended,
+            std::shared_ptr<TapeContainer> container);
+    static void failTransfer(mig_info_t mig_info);
     static void changeFileState(mig_info_t mig_info,
-            std::shared_ptr<std::list<unsigned long>> inumList,
+            std::shared_ptr<JobStore::Batch> successes,
             FsObj::file_state toState);
+    static void failStateChange(mig_info_t mig_info);
 
     Migration(unsigned long _pid, long _reqNumber, std::set<std::string> _pools,
             int _numReplica, int _targetState) :
@@ -85,4 +98,5 @@ public:
     void addRequest();
     void execRequest(int replNum, std::string driveId, std::string pool,
             std::string tapeId, bool needsTape);
+    static int resumeRequests(SubServer& subs);
 };
@@ -0,0 +1,308 @@
+/*******************************************************************************
+ * Copyright 2018 IBM Corp. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *******************************************************************************/
+#include "ServerIncludes.h"
+
+/** @page recall_session Recall Session
+
+    # RecallSession
+
+    Selective recall requests and transparent recall requests are added
+    to the scheduler's ready queue per cartridge. Selective recall requests
+    are created per client command, transparent recall requests per
+    cartridge (see TransRecall::run). If files of several of these requests
+    reside on the same cartridge the requests would be processed one after
+    the other, each of them within a separate pass over the tape.
+
+    If the Scheduler schedules a selective recall request or a transparent
+    recall request for a cartridge a RecallSession is started instead
+    (RecallSession::execRequest). The recall session takes over all
+    other recall requests of the ready queue that are waiting for the
+    same cartridge (Scheduler::claimRecalls) and processes the jobs of all
+    of these requests within a single sweep ordered by the starting block
+    of the data files on tape:
+    @snippet server/SQLStatements.cc recall_session_sql_qry
+
+    The result of each job is attributed to the request it belongs to:
+
+    - For selective recall jobs the progress information of the
+      corresponding request is updated (@ref mrStatus "mrStatus") and the
+      client waiting for that request is notified (Scheduler::updReq).
+      Jobs that have been successful are changed to the target state,
+      failed jobs to FsObj::FAILED.
+    - Transparent recall jobs are removed from the job store and the
+      corresponding recall events are responded (Connector::respondRecallEvent).
+
+    If a transparent recall request needs the drive
+    (LTFSDMDrive::getToUnblock) the remaining selective recall jobs are
+    skipped and the corresponding requests are suspended. The transparent
+    recall jobs that already are part of the sweep are still processed.
+
+    At the end of the sweep the state of each request is updated
+    separately (RecallSession::finishRequest):
+
+    - A selective recall request that has been suspended is changed to
+      DataBase::REQ_NEW and added to the ready queue again
+      (Scheduler::requeueRequest). Otherwise it is changed to
+      DataBase::REQ_COMPLETED.
+    - A transparent recall request is added to the ready queue again if
+      further transparent recall events arrived for the same cartridge
+      in the meantime. Otherwise it is removed from the REQUEST_QUEUE table.
+
+    Selective recall requests for files in premigrated state only do not
+    need a cartridge and are processed by SelRecall::execRequest
+    directly.
+ */
+
+void RecallSession::addRequest(DataBase::operation op, int reqNum)
+
+{
+    SQLStatement stmt;
+
+    TRACE(Trace::always, op, reqNum, tapeId);
+
+    stmt(RecallSession::UPDATE_REQUEST) << DataBase::REQ_INPROGRESS << reqNum
+            << tapeId;
+    TRACE(Trace::normal, stmt.str());
+    stmt.doall();
+
+    requests[reqNum] = (recreq_t ) { op, false };
+
+    if (op == DataBase::SELRECALL)
+        mrStatus.add(reqNum);
+}
+
+std::set<int> RecallSession::getReqNums(DataBase::operation op)
+
+{
+    std::set<int> reqNums;
+
+    for (std::pair<const int, recreq_t>& req : requests)
+        if (op == DataBase::NOOP || req.second.op == op)
+            reqNums.insert(req.first);
+
+    return reqNums;
+}
+
+void RecallSession::updateStatus()
+
+{
+    std::lock_guard<std::mutex> lock(Scheduler::updmtx);
+
+    for (std::pair<const int, recreq_t>& req : requests)
+        if (req.second.op == DataBase::SELRECALL)
+            Scheduler::updReq[req.first] = true;
+
+    Scheduler::updcond.notify_all();
+}
+
+void RecallSession::processFiles()
+
+{
+    std::shared_ptr<LTFSDMDrive> drive;
+    struct respinfo_t
+    {
+        Connector::rec_info_t recinfo;bool succeeded;
+    };
+    std::list<respinfo_t> resplist;
+    std::shared_ptr<JobStore::Batch> successes = jobStore->createBatch();
+    std::set<int> reqNums = getReqNums(DataBase::NOOP);
+    int numFiles = 0;
+    time_t start;
+
+    {
+        std::lock_guard<std::recursive_mutex> lock(LTFSDMInventory::mtx);
+        drive = inventory->getDrive(driveId);
+    }
+    assert(drive != nullptr);
+
+    updateStatus();
+
+    jobStore->changeState(reqNums, Const::UNSET, tapeId, FsObj::MIGRATED,
+            FsObj::RECALLING_MIG);
+    jobStore->changeState(reqNums, Const::UNSET, tapeId, FsObj::PREMIGRATED,
+            FsObj::RECALLING_PREMIG);
+
+    start = time(NULL);
+    jobStore->selectRecallJobs(reqNums, tapeId,
+            [&](const JobStore::rec_job_t& job) {
+                recreq_t& recreq = requests[job.reqNum];
+                Connector::rec_info_t recinfo;
+                FsObj::file_state state;
+                bool succeeded;
+
+                numFiles++;
+
+                if (job.state == FsObj::RECALLING_MIG)
+                    state = FsObj::MIGRATED;
+                else
+                    state = FsObj::PREMIGRATED;
+
+                TRACE(Trace::always, job.op, job.reqNum, job.fileName,
+                        job.fuid.inum, state, job.targetState);
+
+                if (job.op == DataBase::TRARECALL) {
+                    recinfo.conn_info = (struct conn_info_t *) job.connInfo;
+                    recinfo.toresident = (job.targetState == FsObj::RESIDENT);
+                    recinfo.fuid = job.fuid;
+                    recinfo.filename = job.fileName;
+
+                    try {
+                        TransRecall::recall(recinfo, tapeId, state,
+                                job.targetState);
+                        succeeded = true;
+                    } catch (const std::exception& e) {
+                        TRACE(Trace::error, e.what());
+                        succeeded = false;
+                    }
+
+                    TRACE(Trace::always, succeeded);
+                    resplist.push_back((respinfo_t ) { recinfo, succeeded });
+                    return true;
+                }
+
+                if (Server::terminate == true || state == job.targetState)
+                    return true;
+
+                if (drive->getToUnblock() == DataBase::TRARECALL) {
+                    TRACE(Trace::always, job.reqNum, tapeId);
+                    recreq.suspended = true;
+                    return true;
+                }
+
+                try {
+                    SelRecall::recall(job.fileName, tapeId, state,
+                            job.targetState);
+                    mrStatus.updateSuccess(job.reqNum, state, job.targetState);
+                    successes->setRecalled(
+                            std::bind(&RecallSession::failRecall, job.reqNum,
+                                    job.jobId, job.targetState), job.jobId,
+                            job.targetState);
+                } catch (const std::exception& e) {
+                    TRACE(Trace::error, e.what());
+                    mrStatus.updateFailed(job.reqNum, state);
+                    TRACE(Trace::error, job.fileName, job.reqNum, tapeId);
+                    jobStore->failJob(job.jobId);
+                }
+
+                if (time(NULL) - start < 10)
+                    return true;
+
+                start = time(NULL);
+
+                updateStatus();
+                return true;
+            });
+    TRACE(Trace::always, numFiles);
+
+    updateStatus();
+
+    successes->flush();
+
+    jobStore->deleteRecalled(getReqNums(DataBase::TRARECALL), tapeId);
+
+    jobStore->changeState(reqNums, Const::UNSET, tapeId,
+            FsObj::RECALLING_MIG, FsObj::MIGRATED);
+    jobStore->changeState(reqNums, Const::UNSET, tapeId,
+            FsObj::RECALLING_PREMIG, FsObj::PREMIGRATED);
+
+    for (respinfo_t respinfo : resplist)
+        Connector::respondRecallEvent(respinfo.recinfo, respinfo.succeeded);
+}
+
+void RecallSession::failRecall(int reqNum, long jobId,
+        FsObj::file_state toState)
+
+{
+    // the recall already has been counted as successful
+    mrStatus.updateFailed(reqNum, toState);
+    jobStore->failJob(jobId);
+}
+
+void RecallSession::finishRequest(int reqNum, recreq_t& recreq)
+
+{
+    SQLStatement stmt;
+    int remaining;
+    bool requeue;
+
+    TRACE(Trace::always, recreq.op, reqNum, recreq.suspended);
+
+    if (recreq.op == DataBase::SELRECALL) {
+        std::lock_guard<std::mutex> updlock(Scheduler::updmtx);
+
+        requeue = recreq.suspended;
+        stmt(RecallSession::UPDATE_REQUEST)
+                << (requeue ? DataBase::REQ_NEW : DataBase::REQ_COMPLETED)
+                << reqNum << tapeId;
+        TRACE(Trace::normal, stmt.str());
+        stmt.doall();
+
+        if (requeue)
+            Scheduler::requeueRequest(reqNum, Const::UNSET, tapeId, false);
+        else
+            Scheduler::completeRequest(reqNum, Const::UNSET, tapeId);
+
+        Scheduler::updReq[reqNum] = true;
+        Scheduler::updcond.notify_all();
+        return;
+    }
+
+    remaining = jobStore->countJobs(reqNum, tapeId, Const::UNSET);
+
+    requeue = (remaining > 0);
+    if (requeue)
+        stmt(RecallSession::UPDATE_REQUEST) << DataBase::REQ_NEW << reqNum
+                << tapeId;
+    else
+        stmt(RecallSession::DELETE_REQUEST) << reqNum << tapeId;
+    TRACE(Trace::normal, stmt.str());
+    stmt.doall();
+
+    if (requeue)
+        Scheduler::requeueRequest(reqNum, Const::UNSET, tapeId, false);
+    else
+        Scheduler::completeRequest(reqNum, Const::UNSET, tapeId);
+}
+
+void RecallSession::execRequest(DataBase::operation op, int reqNum)
+
+{
+    TRACE(Trace::always, op, reqNum, driveId, tapeId);
+
+    addRequest(op, reqNum);
+
+    for (Scheduler::request_t req : Scheduler::claimRecalls(tapeId, driveId))
+        addRequest(req.op, req.reqNum);
+
+    processFiles();
+
+    {
+        std::lock_guard<std::recursive_mutex> lock(LTFSDMInventory::mtx);
+        if (inventory->getCartridge(tapeId)->getState()
+                == LTFSDMCartridge::TAPE_INUSE)
+            inventory->getCartridge(tapeId)->setState(
+                    LTFSDMCartridge::TAPE_MOUNTED);
+
+        inventory->getDrive(driveId)->setFree();
+        inventory->getDrive(driveId)->clearToUnblock();
+    }
+
+    for (std::pair<const int, recreq_t>& req : requests)
+        finishRequest(req.first, req.second);
+
+    Scheduler::invoke();
+}
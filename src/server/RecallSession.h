@@ -0,0 +1,47 @@
+/*******************************************************************************
+ * Copyright 2018 IBM Corp. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *******************************************************************************/
+#pragma once
+
+class RecallSession: public FileOperation
+{
+    friend class DataBase;
+private:
+    struct recreq_t
+    {
+        DataBase::operation op;
+        bool suspended;
+    };
+    std::string driveId;
+    std::string tapeId;
+    std::map<int, recreq_t> requests;
+
+    static const std::string UPDATE_REQUEST;
+    static const std::string DELETE_REQUEST;
+
+    void addRequest(DataBase::operation op, int reqNum);
+    std::set<int> getReqNums(DataBase::operation op);
+    void updateStatus();
+    void processFiles();
+    void finishRequest(int reqNum, recreq_t& recreq);
+    static void failRecall(int reqNum, long jobId, FsObj::file_state toState);
+public:
+    RecallSession(std::string _driveId, std::string _tapeId) :
+            driveId(_driveId), tapeId(_tapeId)
+    {
+    }
+    void execRequest(DataBase::operation op, int reqNum);
+};
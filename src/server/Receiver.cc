@@ -60,7 +60,7 @@
 
 #include "ServerIncludes.h"
 
-std::atomic<long> globalReqNumber;
+std::atomic<long> globalReqNumber(0);
 
 void Receiver::run(long key, std::shared_ptr<Connector> connector)
 
@@ -73,8 +73,6 @@ void Receiver::run(long key, std::shared_ptr<Connector> connector)
 
     TRACE(Trace::full, __PRETTY_FUNCTION__);
 
-    globalReqNumber = 0;
-
     try {
         command.listen();
     } catch (const std::exception& e) {
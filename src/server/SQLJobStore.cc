@@ -0,0 +1,407 @@
+/*******************************************************************************
+ * Copyright 2018 IBM Corp. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *******************************************************************************/
+#include "ServerIncludes.h"
+
+/*
+ * The jobs are kept within the JOB_QUEUE table (see @ref sqlite). The
+ * statements are the ones that have been executed by the different
+ * request types before the job store has been introduced.
+ */
+
+void SQLJobStore::SQLBatch::setState(std::function<void()> failed, long jobId,
+        FsObj::file_state from, FsObj::file_state to)
+
+{
+    states.add(failed, to, jobId, from);
+}
+
+void SQLJobStore::SQLBatch::setRecalled(std::function<void()> failed,
+        long jobId, FsObj::file_state to)
+
+{
+    recalled.add(failed, to, jobId, FsObj::RECALLING_MIG,
+            FsObj::RECALLING_PREMIG);
+}
+
+void SQLJobStore::SQLBatch::assignTape(long jobId, std::string tapeId,
+        FsObj::file_state from, FsObj::file_state to)
+
+{
+    assigned.add(nullptr, to, tapeId, jobId, from);
+}
+
+void SQLJobStore::SQLBatch::flush()
+
+{
+    states.flush();
+    recalled.flush();
+    assigned.flush();
+}
+
+std::string SQLJobStore::genReqString(const std::set<int>& reqNums)
+
+{
+    std::list<unsigned long> reqList;
+
+    for (int reqNum : reqNums)
+        reqList.push_back(reqNum);
+
+    return FileOperation::genInumString(reqList);
+}
+
+void SQLJobStore::addJob(const job_t& job)
+
+{
+    switch (job.op) {
+        case DataBase::MIGRATION:
+            SQLCachedStatement(SQLJobStore::ADD_MIG_JOB).exec(job.op,
+                    job.fileName, job.reqNum, job.targetState, job.fileSize,
+                    job.fuid.fsid_h, job.fuid.fsid_l, job.fuid.igen,
+                    job.fuid.inum, job.mtimeSec, job.mtimeNsec, time(NULL),
+                    job.state, job.replNum, job.pool);
+            break;
+        case DataBase::SELRECALL:
+            SQLCachedStatement(SQLJobStore::ADD_SELRECALL_JOB).exec(job.op,
+                    job.fileName, job.reqNum, job.targetState, job.fileSize,
+                    job.fuid.fsid_h, job.fuid.fsid_l, job.fuid.igen,
+                    job.fuid.inum, job.mtimeSec, job.mtimeNsec, time(NULL),
+                    job.state, job.tapeId, job.startBlock);
+            break;
+        case DataBase::TRARECALL:
+            // the file name is NULL if it is not known
+            SQLCachedStatement(SQLJobStore::ADD_TRARECALL_JOB).exec(job.op,
+                    (job.fileName.compare("") != 0 ?
+                            job.fileName.c_str() : nullptr), job.reqNum,
+                    job.targetState, job.replNum, job.fileSize,
+                    job.fuid.fsid_h, job.fuid.fsid_l, job.fuid.igen,
+                    job.fuid.inum, job.mtimeSec, job.mtimeNsec, time(NULL),
+                    job.state, job.tapeId, job.startBlock, job.connInfo);
+            break;
+        default:
+            TRACE(Trace::error, job.op);
+            THROW(Error::GENERAL_ERROR, job.op);
+    }
+}
+
+std::shared_ptr<JobStore::Batch> SQLJobStore::createBatch()
+
+{
+    return std::make_shared<SQLJobStore::SQLBatch>();
+}
+
+void SQLJobStore::failJob(long jobId)
+
+{
+    SQLCachedStatement(SQLJobStore::FAIL_JOB).exec(FsObj::FAILED, jobId);
+}
+
+void SQLJobStore::failReplicas(int reqNum, long jobId)
+
+{
+    SQLCachedStatement(SQLJobStore::FAIL_REPLICAS).exec(FsObj::FAILED, reqNum,
+            jobId);
+}
+
+void SQLJobStore::setResumeOffset(long jobId, unsigned long offset,
+        std::string tapeId)
+
+{
+    SQLCachedStatement(SQLJobStore::SET_RESUME_OFFSET).exec(offset, tapeId,
+            jobId);
+}
+
+void SQLJobStore::changeState(const std::set<int>& reqNums, int replNum,
+        std::string tapeId, FsObj::file_state from, FsObj::file_state to)
+
+{
+    SQLStatement stmt;
+
+    if (replNum == Const::UNSET)
+        stmt(SQLJobStore::CHANGE_STATE) << to << genReqString(reqNums) << from
+                << tapeId;
+    else
+        stmt(SQLJobStore::CHANGE_REPL_STATE) << to << genReqString(reqNums)
+                << from << tapeId << replNum;
+    TRACE(Trace::normal, stmt.str());
+    stmt.doall();
+}
+
+JobStore::unclaimed_t SQLJobStore::unclaimed(int reqNum, int replNum,
+        FsObj::file_state state)
+
+{
+    SQLStatement stmt;
+    unclaimed_t unclaimed = (unclaimed_t ) { 0, 0, 0, 0 };
+
+    stmt(SQLJobStore::UNCLAIMED_JOBS) << reqNum << state << replNum;
+    stmt.prepare();
+    while (stmt.step(&unclaimed.num, &unclaimed.size, &unclaimed.maxSize,
+            &unclaimed.minSize)) {
+    }
+    stmt.finalize();
+
+    return unclaimed;
+}
+
+void SQLJobStore::selectUnassigned(int reqNum, int replNum,
+        FsObj::file_state state,
+        std::function<bool(long jobId, unsigned long size)> process)
+
+{
+    SQLStatement stmt;
+    long jobId;
+    unsigned long size;
+
+    stmt(SQLJobStore::SELECT_UNASSIGNED) << reqNum << state << replNum;
+    TRACE(Trace::normal, stmt.str());
+    stmt.prepare();
+    while (stmt.step(&jobId, &size))
+        if (process(jobId, size) == false)
+            break;
+    stmt.finalize();
+}
+
+void SQLJobStore::selectMigJobs(int reqNum, std::string tapeId,
+        FsObj::file_state state, std::function<bool(const mig_job_t&)> process)
+
+{
+    SQLStatement stmt;
+    mig_job_t job;
+
+    stmt(SQLJobStore::SELECT_MIG_JOBS) << reqNum << state << tapeId;
+    TRACE(Trace::normal, stmt.str());
+    stmt.prepare();
+    while (stmt.step(&job.jobId, &job.fileName, &job.mtimeSec, &job.mtimeNsec,
+            &job.inum, &job.resumeOffset, &job.resumeTapeId))
+        if (process(job) == false)
+            break;
+    stmt.finalize();
+}
+
+void SQLJobStore::selectRecallJobs(const std::set<int>& reqNums,
+        std::string tapeId, std::function<bool(const rec_job_t&)> process)
+
+{
+    SQLStatement stmt;
+    rec_job_t job;
+
+    stmt(SQLJobStore::SELECT_RECALL_JOBS) << genReqString(reqNums)
+            << FsObj::RECALLING_MIG << FsObj::RECALLING_PREMIG << tapeId;
+    TRACE(Trace::normal, stmt.str());
+    stmt.prepare();
+    while (stmt.step(&job.op, &job.reqNum, &job.jobId, &job.fuid.fsid_h,
+            &job.fuid.fsid_l, &job.fuid.igen, &job.fuid.inum, &job.fileName,
+            &job.state, &job.targetState, &job.connInfo))
+        if (process(job) == false)
+            break;
+    stmt.finalize();
+}
+
+void SQLJobStore::selectTransRecalls(
+        std::function<bool(const rec_job_t&)> process)
+
+{
+    SQLStatement stmt;
+    rec_job_t job;
+
+    job.op = DataBase::TRARECALL;
+    stmt(SQLJobStore::SELECT_TRANS_RECALLS) << DataBase::TRARECALL;
+    TRACE(Trace::normal, stmt.str());
+    stmt.prepare();
+    while (stmt.step(&job.reqNum, &job.jobId, &job.fuid.fsid_h,
+            &job.fuid.fsid_l, &job.fuid.igen, &job.fuid.inum, &job.fileName,
+            &job.state, &job.targetState, &job.connInfo))
+        if (process(job) == false)
+            break;
+    stmt.finalize();
+}
+
+void SQLJobStore::info(const info_filter_t& filter,
+        std::function<bool(const info_t&)> process)
+
+{
+    SQLReadStatement stmt;
+    std::list<std::string> conditions;
+    std::list<unsigned long> values;
+    const char *group = nullptr;
+    info_t info;
+
+    if (filter.reqNum != Const::UNSET)
+        conditions.push_back(
+                MessageParser::genCondition(MessageParser::FILTER_REQ_NUM,
+                        std::to_string(filter.reqNum)));
+
+    if (filter.byOperation) {
+        values.assign(filter.operations.begin(), filter.operations.end());
+        conditions.push_back(
+                MessageParser::genCondition(MessageParser::FILTER_OPERATION,
+                        FileOperation::genInumString(values)));
+    }
+
+    if (filter.byState) {
+        values.assign(filter.states.begin(), filter.states.end());
+        conditions.push_back(
+                MessageParser::genCondition(SQLJobStore::FILTER_FILE_STATE,
+                        FileOperation::genInumString(values)));
+    }
+
+    if (filter.tapeId.size() > 0)
+        conditions.push_back(
+                MessageParser::genCondition(MessageParser::FILTER_TAPE_ID,
+                        filter.tapeId));
+
+    if (filter.pool.size() > 0)
+        conditions.push_back(
+                MessageParser::genCondition(MessageParser::FILTER_TAPE_POOL,
+                        filter.pool));
+
+    if (filter.pathPrefix.size() > 0)
+        conditions.push_back(
+                MessageParser::genCondition(SQLJobStore::FILTER_PATH_PREFIX,
+                        filter.pathPrefix));
+
+    switch (filter.groupBy) {
+        case JobStore::GROUP_STATE:
+            group = "FILE_STATE";
+            break;
+        case JobStore::GROUP_TAPE:
+            group = "TAPE_ID";
+            break;
+        case JobStore::GROUP_POOL:
+            group = "TAPE_POOL";
+            break;
+        default:
+            break;
+    }
+
+    // passed as C strings since the conditions already are escaped
+    if (group == nullptr)
+        stmt(SQLJobStore::INFO_JOBS)
+                << MessageParser::genWhere(conditions).c_str()
+                << MessageParser::genPage("JOB_ID", filter.limit,
+                        filter.offset).c_str();
+    else
+        // the file name is only needed to match the path prefix
+        stmt(SQLJobStore::INFO_JOBS_GROUPED) << group
+                << (filter.pathPrefix.size() > 0 ? "JOB_LIST" : "JOB_QUEUE")
+                << MessageParser::genWhere(conditions).c_str()
+                << MessageParser::genPage(group, filter.limit,
+                        filter.offset).c_str();
+    TRACE(Trace::normal, stmt.str());
+
+    stmt.prepare();
+
+    while (true) {
+        if (group == nullptr) {
+            if (!stmt.step(&info.op, &info.fileName, &info.reqNum, &info.pool,
+                    &info.fileSize, &info.tapeId, &info.state))
+                break;
+            info.count = 1;
+        } else {
+            // the grouped column is returned within the corresponding field
+            info.op = DataBase::NOOP;
+            info.fileName = "";
+            info.reqNum = filter.reqNum;
+            info.state = static_cast<FsObj::file_state>(Const::UNSET);
+            info.tapeId = "";
+            info.pool = "";
+            if (filter.groupBy == JobStore::GROUP_STATE) {
+                if (!stmt.step(&info.state, &info.count, &info.fileSize))
+                    break;
+            } else if (filter.groupBy == JobStore::GROUP_TAPE) {
+                if (!stmt.step(&info.tapeId, &info.count, &info.fileSize))
+                    break;
+            } else if (!stmt.step(&info.pool, &info.count, &info.fileSize)) {
+                break;
+            }
+        }
+
+        if (process(info) == false)
+            break;
+    }
+    stmt.finalize();
+}
+
+std::set<std::string> SQLJobStore::getTapes(int reqNum)
+
+{
+    SQLStatement stmt = SQLStatement(SQLJobStore::GET_TAPES) << reqNum;
+    std::set<std::string> tapes;
+    std::string tapeId;
+
+    stmt.prepare();
+    while (stmt.step(&tapeId))
+        tapes.insert(tapeId);
+    stmt.finalize();
+
+    return tapes;
+}
+
+int SQLJobStore::countJobs(int reqNum, std::string tapeId, int state)
+
+{
+    SQLStatement stmt;
+    int num = 0;
+
+    if (state == Const::UNSET)
+        stmt(SQLJobStore::COUNT_ALL_JOBS) << reqNum << tapeId;
+    else
+        stmt(SQLJobStore::COUNT_JOBS) << reqNum << tapeId << state;
+    TRACE(Trace::normal, stmt.str());
+    stmt.prepare();
+    while (stmt.step(&num)) {
+    }
+    stmt.finalize();
+
+    return num;
+}
+
+std::map<FsObj::file_state, int> SQLJobStore::countStates(int reqNum)
+
+{
+    SQLStatement stmt = SQLStatement(SQLJobStore::COUNT_STATES) << reqNum;
+    std::map<FsObj::file_state, int> states;
+    FsObj::file_state state;
+    int num;
+
+    stmt.prepare();
+    while (stmt.step(&state, &num))
+        states[state] = num;
+    stmt.finalize();
+
+    return states;
+}
+
+void SQLJobStore::deleteRecalled(const std::set<int>& reqNums,
+        std::string tapeId)
+
+{
+    SQLStatement stmt = SQLStatement(SQLJobStore::DELETE_RECALLED)
+            << genReqString(reqNums) << FsObj::RECALLING_MIG
+            << FsObj::RECALLING_PREMIG << tapeId;
+
+    TRACE(Trace::normal, stmt.str());
+    stmt.doall();
+}
+
+void SQLJobStore::deleteJobs(int reqNum)
+
+{
+    SQLStatement stmt = SQLStatement(SQLJobStore::DELETE_JOBS) << reqNum;
+
+    stmt.doall();
+}
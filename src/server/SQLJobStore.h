@@ -0,0 +1,100 @@
+/*******************************************************************************
+ * Copyright 2018 IBM Corp. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *******************************************************************************/
+#pragma once
+
+class SQLJobStore: public JobStore
+{
+    friend class DataBase;
+    friend class InsertBenchmark;
+private:
+    class SQLBatch: public JobStore::Batch
+    {
+    private:
+        SQLBatchStatement states;
+        SQLBatchStatement recalled;
+        SQLBatchStatement assigned;
+    public:
+        SQLBatch() :
+                states(SQLJobStore::SET_STATE), recalled(
+                        SQLJobStore::SET_RECALLED), assigned(
+                        SQLJobStore::ASSIGN_TAPE)
+        {
+        }
+        void setState(std::function<void()> failed, long jobId,
+                FsObj::file_state from, FsObj::file_state to);
+        void setRecalled(std::function<void()> failed, long jobId,
+                FsObj::file_state to);
+        void assignTape(long jobId, std::string tapeId,
+                FsObj::file_state from, FsObj::file_state to);
+        void flush();
+    };
+
+    static const std::string ADD_MIG_JOB;
+    static const std::string ADD_SELRECALL_JOB;
+    static const std::string ADD_TRARECALL_JOB;
+    static const std::string FAIL_JOB;
+    static const std::string FAIL_REPLICAS;
+    static const std::string SET_RESUME_OFFSET;
+    static const std::string SET_STATE;
+    static const std::string SET_RECALLED;
+    static const std::string ASSIGN_TAPE;
+    static const std::string CHANGE_STATE;
+    static const std::string CHANGE_REPL_STATE;
+    static const std::string UNCLAIMED_JOBS;
+    static const std::string SELECT_UNASSIGNED;
+    static const std::string SELECT_MIG_JOBS;
+    static const std::string SELECT_RECALL_JOBS;
+    static const std::string SELECT_TRANS_RECALLS;
+    static const std::string INFO_JOBS;
+    static const std::string INFO_JOBS_GROUPED;
+    static const std::string FILTER_FILE_STATE;
+    static const std::string FILTER_PATH_PREFIX;
+    static const std::string GET_TAPES;
+    static const std::string COUNT_JOBS;
+    static const std::string COUNT_ALL_JOBS;
+    static const std::string COUNT_STATES;
+    static const std::string DELETE_RECALLED;
+    static const std::string DELETE_JOBS;
+
+    static std::string genReqString(const std::set<int>& reqNums);
+public:
+    SQLJobStore()
+    {
+    }
+    void addJob(const job_t& job);
+    std::shared_ptr<Batch> createBatch();
+    void failJob(long jobId);
+    void failReplicas(int reqNum, long jobId);
+    void setResumeOffset(long jobId, unsigned long offset, std::string tapeId);
+    void changeState(const std::set<int>& reqNums, int replNum,
+            std::string tapeId, FsObj::file_state from, FsObj::file_state to);
+    unclaimed_t unclaimed(int reqNum, int replNum, FsObj::file_state state);
+    void selectUnassigned(int reqNum, int replNum, FsObj::file_state state,
+            std::function<bool(long jobId, unsigned long size)> process);
+    void selectMigJobs(int reqNum, std::string tapeId, FsObj::file_state state,
+            std::function<bool(const mig_job_t&)> process);
+    void selectRecallJobs(const std::set<int>& reqNums, std::string tapeId,
+            std::function<bool(const rec_job_t&)> process);
+    void selectTransRecalls(std::function<bool(const rec_job_t&)> process);
+    void info(const info_filter_t& filter,
+            std::function<bool(const info_t&)> process);
+    std::set<std::string> getTapes(int reqNum);
+    int countJobs(int reqNum, std::string tapeId, int state);
+    std::map<FsObj::file_state, int> countStates(int reqNum);
+    void deleteRecalled(const std::set<int>& reqNums, std::string tapeId);
+    void deleteJobs(int reqNum);
+};
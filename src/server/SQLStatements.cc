@@ -43,7 +43,8 @@
     column | data type | details
     ---|---|---
     OPERATION | INT | operation: see DataBase::operation
-    FILE_NAME | CHAR(4096) | file name
+    DIR_ID | INT | directory of the file: see JOB_DIRS
+    NAME | VARCHAR | file name without the directory
     REQ_NUM | INT | for each new request incremented by one
     TARGET_STATE | INT | target state for migration and recall: FsObj::state
     REPL_NUM | INT | 0, for migration 0,1,2 depending of the number of tape storage pools
@@ -60,6 +61,29 @@
     FILE_STATE | INT | file state: see FsObj::file_state
     START_BLOCK | INT | starting block of the data on tape of a (pre)migrated file
     CONN_INFO | BIGINT | address of connector specific information
+    RESUME_OFFSET | BIGINT | number of bytes already written to tape if the data transfer of a file has been suspended
+    RESUME_TAPE_ID | CHAR(9) | id of the cartridge the partial data of a suspended data transfer has been written to
+
+    ## JOB_DIRS
+
+    column | data type | details
+    ---|---|---
+    DIR_ID | INTEGER PRIMARY KEY | id of the directory
+    PATH | VARCHAR | directory name including the trailing slash
+
+    The directory names are stored only once: for a migration to three
+    tape storage pools of many files within the same directory each job
+    only keeps the name of the file within that directory. Jobs are added
+    to and selected from the view JOB_LIST that provides the full file
+    name (FILE_NAME) and the ROWID of the job (JOB_ID):
+
+    @snippet server/SQLStatements.cc job_list
+
+    An insert into JOB_LIST splits the file name, adds the directory if
+    it does not exist, and adds the job to the JOB_QUEUE table. A directory
+    is removed with its last job. Both happen within the statement that
+    adds or removes the job. The file name of a transparent recall job
+    is NULL if it is not known, in this case DIR_ID is NULL as well.
 
     ## REQUEST_QUEUE
 
@@ -76,14 +100,173 @@
     TIME_ADDED | INT | time the request has been added (need to check if really used)
     STATE | INT | request state, see DataBase::req_state
 
+    ## Cached statements
+
+    Most statements are executed by the SQLStatement class: the values are
+    inserted into the statement text by boost::format and the statement is
+    prepared, executed, and finalized each time. Statements that are executed
+    once per file (e.g. SQLJobStore::ADD_MIG_JOB or SQLJobStore::FAIL_JOB)
+    are executed by the SQLCachedStatement class instead:
+
+    @code
+    SQLCachedStatement(SQLJobStore::FAIL_JOB).exec(FsObj::FAILED, jobId);
+    @endcode
+
+    These statements are prepared only once (DataBase::getStatement) and
+    kept thereafter for later use (DataBase::putStatement). The format
+    placeholders <TT>%n%</TT> and <TT>'%n%'</TT> are replaced by the
+    parameters <TT>?n</TT> when the statement is prepared and the values are
+    bound by sqlite3_bind_* functions. The type of each value is checked at
+    compile time: there is no SQLCachedStatement::bindValue method for
+    other types. Strings are bound as they are while the SQLStatement class
+    writes single quotes twice (SQLStatement::escape); in both cases the
+    text is stored unchanged and read back without conversion. A C string
+    that is a null pointer is bound as NULL.
+
+    If several threads execute the same statement at the same time a
+    separate copy is prepared for each of them.
+
+    ## Indexes
+
+    Besides the indexes of the unique constraints there are two indexes
+    on the JOB_QUEUE table. The first one is used by the statements that
+    select the jobs of a request for a cartridge, the second one by the
+    statements that select the jobs of a request for a replica:
+
+    @snippet server/SQLStatements.cc job_queue_indexes
+
+    The order of the result of SQLJobStore::SELECT_RECALL_JOBS by
+    START_BLOCK is only determined for the jobs of a single cartridge.
+    Statements that update a single job use the JOB_ID that has been
+    selected together with the file name (e.g. SQLJobStore::SET_STATE).
+    SQLJobStore::FAIL_REPLICAS changes the jobs of all replicas of a file
+    and uses the unary operator <TT>+</TT> for the request number
+    (<TT>+REQ_NUM=%2%</TT>) so that the unique index on the file name is
+    used rather than one of the indexes above.
+
+    The test test/test13.py creates the tables and indexes in an in-memory
+    database, determines the query plan of each statement of this file and
+    fails if one of them performs a full table scan. Only the statements
+    that list all requests or jobs, SQLJobStore::SELECT_TRANS_RECALLS that
+    is executed at shutdown only, and the statements that resume the
+    requests at startup are excluded there. New statements therefore are
+    checked without further changes. In addition, after the tables are
+    created DataBase::checkQueryPlans traces the query plan of each
+    statement of DataBase::INDEXED_STATEMENTS with the SQLite library the
+    backend is running with.
+
+    ## Transactions
+
+    Without an explicit transaction each statement is committed
+    separately. To add the jobs of many files at once an SQLTransaction
+    object can be used: a transaction begins with its creation and is
+    committed by SQLTransaction::commit or when the object is destroyed.
+    There is only a single database connection for writing and therefore
+    only one transaction at a time. An SQLTransaction object holds the
+    recursive mutex DataBase::trans_mutex until the transaction ends and
+    each statement that changes the database (sqlite3_stmt_readonly
+    returns false) takes the same mutex while it is executed. Changes of
+    other threads therefore wait for the end of the transaction and never
+    become part of it. A statement that fails, e.g. with
+    SQLITE_CONSTRAINT_UNIQUE, only reverts its own changes. The whole
+    transaction is rolled back (SQLTransaction::rollback) if the commit
+    fails or if the object is destroyed while an exception is propagated.
+    Otherwise the connection would remain within the transaction and all
+    further changes would be lost. Since only the changes of the thread
+    that owns the transaction are within it a rollback cannot revert the
+    changes of other threads. A transaction should be kept short since
+    all other threads that change the database are blocked meanwhile.
+
+    ## Read-only connection
+
+    The commands <TT>ltfsdm info requests</TT> and <TT>ltfsdm info jobs</TT>
+    send one message per row while the statement is executed and a slow
+    client would keep the statement open for a long time. These statements
+    are executed by an SQLReadStatement on a separate read-only connection
+    (DataBase::getReadDB). If the database is stored within a file it is
+    kept in WAL mode and the read-only connection reads a consistent
+    snapshot without blocking the writers. Within memory (option
+    <TT>-m</TT>) both connections share the cache and the read-only
+    connection reads uncommitted changes. All other statements, including
+    the ones that determine the progress of a request (Status::add,
+    FileOperation::queryResult), use the main connection. They need to
+    see the changes of a transaction that has not been committed yet.
+
+    ## Batches
+
+    The state of a job that has been processed successfully is changed by
+    an SQLBatchStatement (within SQLJobStore::SQLBatch, see
+    @ref job_store). SQLBatchStatement::add only keeps the values of
+    the statement. The collected statements are executed within a single
+    transaction if Const::DB_BATCH_SIZE of them are pending, if the last
+    execution is more than Const::DB_BATCH_INTERVAL seconds ago, or by
+    SQLBatchStatement::flush. This way the progress is visible within the
+    JOB_QUEUE table while a request is processed and the memory for the
+    pending statements is limited. Each of these statements changes a
+    single job identified by its JOB_ID. If the backend terminates
+    unexpectedly the pending changes are lost.
+
+    Many threads add to the same batch, e.g. the stubbing threads of a
+    migration request (Migration::changeFileState). The pending statements
+    are therefore kept in Const::DB_BATCH_SHARDS separate lists selected by
+    the thread id. The thread that exceeds the limits executes the batch
+    while the other threads continue to add statements. If a batch is
+    already executed by another thread the limits are checked again with
+    the next statement being added.
+
+    Together with the values of a statement SQLBatchStatement::add takes
+    a function that is called if the statement cannot be executed (e.g.
+    Migration::failTransfer or SelRecall::failRecall). The transaction
+    of a batch holds DataBase::trans_mutex like any other SQLTransaction:
+    changes of other threads wait until the batch has been committed or
+    rolled back and a failed batch therefore only reverts its own
+    statements. If a statement fails or the transaction cannot be
+    committed the statement is executed a second time outside of a
+    transaction. If this also fails
+    the function marks the job as failed and corrects the status of the
+    request that already counted the job as successful. The number of
+    these jobs is reported by message LTFSDMS0132E.
+
+    ## Persistent job store
+
+    If the backend is started with the option <TT>-j &lt;file&gt;</TT>
+    both tables are kept within that file. The database is opened in
+    WAL mode with <TT>synchronous=NORMAL</TT>: a commit only appends to
+    the write-ahead log and the log is synced at checkpoints. A committed
+    transaction therefore survives a crash of the backend but may be
+    lost if the system crashes.
+
+    At startup the requests of the previous run are resumed
+    (Server::resumeRequests):
+
+    - The request number continues after the highest one stored.
+    - Transparent recall requests, tape mover and tape handler requests
+      are removed. Transparent recalls are started again by the connector.
+    - Jobs in an intermediate state are reset: Migration::resumeRequests
+      changes FsObj::TRANSFERRING to FsObj::RESIDENT (the resume offset is
+      kept), FsObj::CHANGINGFSTATE to FsObj::TRANSFERRED or, if no
+      cartridge has been assigned, to FsObj::PREMIGRATED.
+      SelRecall::resumeRequests changes FsObj::RECALLING_MIG and
+      FsObj::RECALLING_PREMIG back to the original state.
+    - A request that still has jobs to be processed on a cartridge is
+      added to the ready queue of the scheduler. Jobs that only need a
+      state change are processed immediately without a cartridge.
+      Otherwise the request is completed.
+    - Completed requests and jobs without a request are removed.
+
+    The number of resumed requests is reported by message LTFSDMS0123I.
+    Without the option the database file is created in the temporary
+    directory and removed at startup.
+
  */
 
 /* ======== DataBase ======== */
 
 const std::string DataBase::CREATE_JOB_QUEUE =
-        "CREATE TABLE JOB_QUEUE("
+        "CREATE TABLE IF NOT EXISTS JOB_QUEUE("
                 " OPERATION INT NOT NULL,"
-                " FILE_NAME CHAR(4096),"
+                " DIR_ID INT,"
+                " NAME VARCHAR,"
                 " REQ_NUM INT NOT NULL,"
                 " TARGET_STATE INT NOT NULL,"
                 " REPL_NUM INT,"
@@ -100,11 +283,13 @@ const std::string DataBase::CREATE_JOB_QUEUE =
                 " FILE_STATE INT NOT NULL,"
                 " START_BLOCK INT,"
                 " CONN_INFO BIGINT,"
-                " CONSTRAINT JOB_QUEUE_UNIQUE_FILE_NAME UNIQUE (FILE_NAME, REPL_NUM),"
+                " RESUME_OFFSET BIGINT DEFAULT 0,"
+                " RESUME_TAPE_ID CHAR(9),"
+                " CONSTRAINT JOB_QUEUE_UNIQUE_FILE_NAME UNIQUE (DIR_ID, NAME, REPL_NUM),"
                 " CONSTRAINT JOB_QUEUE_UNIQUE_UID UNIQUE (FS_ID_H, FS_ID_L, I_GEN, I_NUM, REPL_NUM))";
 
 const std::string DataBase::CREATE_REQUEST_QUEUE =
-        "CREATE TABLE REQUEST_QUEUE("
+        "CREATE TABLE IF NOT EXISTS REQUEST_QUEUE("
                 " OPERATION INT NOT NULL,"
                 " REQ_NUM INT NOT NULL,"
                 " TARGET_STATE INT,"
@@ -117,46 +302,113 @@ const std::string DataBase::CREATE_REQUEST_QUEUE =
                 " STATE INT NOT NULL,"
                 " CONSTRAINT REQUEST_QUEUE_UNIQUE UNIQUE(REQ_NUM, REPL_NUM, TAPE_POOL, TAPE_ID))";
 
-/* ======== Scheduler ======== */
+const std::string DataBase::CREATE_JOB_DIRS =
+        "CREATE TABLE IF NOT EXISTS JOB_DIRS("
+                " DIR_ID INTEGER PRIMARY KEY,"
+                " PATH VARCHAR NOT NULL,"
+                " CONSTRAINT JOB_DIRS_UNIQUE_PATH UNIQUE (PATH))";
+
+//! [job_list]
+const std::string DataBase::CREATE_JOB_LIST =
+        "CREATE VIEW IF NOT EXISTS JOB_LIST AS"
+                " SELECT JOB_QUEUE.ROWID AS JOB_ID, JOB_QUEUE.*,"
+                " JOB_DIRS.PATH || JOB_QUEUE.NAME AS FILE_NAME"
+                " FROM JOB_QUEUE LEFT JOIN JOB_DIRS"
+                " ON JOB_DIRS.DIR_ID=JOB_QUEUE.DIR_ID";
+
+const std::string DataBase::CREATE_JOB_LIST_INSERT =
+        "CREATE TRIGGER IF NOT EXISTS JOB_LIST_INSERT"
+                " INSTEAD OF INSERT ON JOB_LIST"
+                " BEGIN"
+                " INSERT OR IGNORE INTO JOB_DIRS (PATH)"
+                " SELECT RTRIM(NEW.FILE_NAME, REPLACE(NEW.FILE_NAME, '/', ''))"
+                " WHERE NEW.FILE_NAME IS NOT NULL;"
+                " INSERT INTO JOB_QUEUE (OPERATION, DIR_ID, NAME, REQ_NUM,"
+                " TARGET_STATE, REPL_NUM, TAPE_POOL, FILE_SIZE, FS_ID_H,"
+                " FS_ID_L, I_GEN, I_NUM, MTIME_SEC, MTIME_NSEC, LAST_UPD,"
+                " TAPE_ID, FILE_STATE, START_BLOCK, CONN_INFO)"
+                " VALUES (NEW.OPERATION,"
+                " (SELECT DIR_ID FROM JOB_DIRS WHERE PATH="
+                "RTRIM(NEW.FILE_NAME, REPLACE(NEW.FILE_NAME, '/', ''))),"
+                " SUBSTR(NEW.FILE_NAME, LENGTH("
+                "RTRIM(NEW.FILE_NAME, REPLACE(NEW.FILE_NAME, '/', ''))) + 1),"
+                " NEW.REQ_NUM, NEW.TARGET_STATE, NEW.REPL_NUM, NEW.TAPE_POOL,"
+                " NEW.FILE_SIZE, NEW.FS_ID_H, NEW.FS_ID_L, NEW.I_GEN,"
+                " NEW.I_NUM, NEW.MTIME_SEC, NEW.MTIME_NSEC, NEW.LAST_UPD,"
+                " NEW.TAPE_ID, NEW.FILE_STATE, NEW.START_BLOCK, NEW.CONN_INFO);"
+                " END";
+
+const std::string DataBase::CREATE_JOB_QUEUE_DELETE =
+        "CREATE TRIGGER IF NOT EXISTS JOB_QUEUE_DELETE"
+                " AFTER DELETE ON JOB_QUEUE"
+                " WHEN OLD.DIR_ID IS NOT NULL AND NOT EXISTS"
+                " (SELECT 1 FROM JOB_QUEUE WHERE DIR_ID=OLD.DIR_ID)"
+                " BEGIN"
+                " DELETE FROM JOB_DIRS WHERE DIR_ID=OLD.DIR_ID;"
+                " END";
+//! [job_list]
+
+//! [job_queue_indexes]
+const std::string DataBase::CREATE_JOB_QUEUE_TAPE_INDEX =
+        "CREATE INDEX IF NOT EXISTS JOB_QUEUE_TAPE_INDEX"
+                " ON JOB_QUEUE (REQ_NUM, TAPE_ID, FILE_STATE, START_BLOCK)";
+
+const std::string DataBase::CREATE_JOB_QUEUE_REPL_INDEX =
+        "CREATE INDEX IF NOT EXISTS JOB_QUEUE_REPL_INDEX"
+                " ON JOB_QUEUE (REQ_NUM, REPL_NUM, FILE_STATE)";
+//! [job_queue_indexes]
+
+const std::string DataBase::QUERY_PLAN = "EXPLAIN QUERY PLAN %1%";
+
+const std::string DataBase::JOURNAL_MODE_WAL = "PRAGMA journal_mode=WAL";
+
+const std::string DataBase::SYNCHRONOUS_NORMAL = "PRAGMA synchronous=NORMAL";
+
+const std::string DataBase::READ_UNCOMMITTED = "PRAGMA read_uncommitted=1";
+
+const std::string DataBase::BEGIN_TRANSACTION = "BEGIN TRANSACTION";
+
+const std::string DataBase::COMMIT_TRANSACTION = "COMMIT TRANSACTION";
+
+const std::string DataBase::ROLLBACK_TRANSACTION = "ROLLBACK TRANSACTION";
+
+/* ======== Server ======== */
+
+const std::string Server::MAX_REQ_NUM =
+        "SELECT MAX(IFNULL((SELECT MAX(REQ_NUM) FROM REQUEST_QUEUE), 0),"
+                " IFNULL((SELECT MAX(REQ_NUM) FROM JOB_QUEUE), 0))";
+
+const std::string Server::DELETE_REQUESTS =
+        "DELETE FROM REQUEST_QUEUE WHERE OPERATION<>%1%"
+                " AND OPERATION<>%2%";
+
+const std::string Server::DELETE_COMPLETED_REQUESTS =
+        "DELETE FROM REQUEST_QUEUE WHERE STATE=%1%";
+
+const std::string Server::DELETE_JOBS =
+        "DELETE FROM JOB_QUEUE WHERE REQ_NUM NOT IN"
+                " (SELECT REQ_NUM FROM REQUEST_QUEUE)";
 
-const std::string Scheduler::SELECT_REQUEST =
-        "SELECT OPERATION, REQ_NUM, TARGET_STATE, NUM_REPL,"
-                " REPL_NUM, TAPE_POOL, TAPE_ID, DRIVE_ID"
-                " FROM REQUEST_QUEUE WHERE STATE=%1%"
-                " ORDER BY OPERATION,TIME_ADDED ASC";
+/* ======== Scheduler ======== */
 
 const std::string Scheduler::UPDATE_REQUEST =
         "UPDATE REQUEST_QUEUE SET STATE=%1%"
                 " WHERE REQ_NUM=%2%";
 
-const std::string Scheduler::UPDATE_MIG_REQUEST =
-        "UPDATE REQUEST_QUEUE SET STATE=%1%,TAPE_ID='%2%'"
-                " WHERE REQ_NUM=%3%"
-                " AND REPL_NUM=%4%"
-                " AND TAPE_POOL='%5%'";
+const std::string Scheduler::ADD_MIG_SESSION =
+        "INSERT OR REPLACE INTO REQUEST_QUEUE (OPERATION, REQ_NUM, TARGET_STATE,"
+                " NUM_REPL, REPL_NUM, TAPE_POOL, TAPE_ID, DRIVE_ID, TIME_ADDED, STATE)"
+                " VALUES (" /* OPERATION */"%1%, " /* REQ_NUM */"%2%, " /* TARGET_STATE */"%3%, "
+                /* NUM_REPL */"%4%, " /* REPL_NUM */"%5%, " /* TAPE_POOL */"'%6%', "
+                /* TAPE_ID */"'%7%', " /* DRIVE_ID */"'%8%', " /* TIME_ADDED */"%9%, " /* STATE */"%10%)";
 
 const std::string Scheduler::UPDATE_REC_REQUEST =
         "UPDATE REQUEST_QUEUE SET STATE=%1%"
                 " WHERE REQ_NUM=%2%"
                 " AND TAPE_ID='%3%'";
 
-const std::string Scheduler::SMALLEST_MIG_JOB =
-        "SELECT MIN(FILE_SIZE) FROM JOB_QUEUE WHERE"
-                " REQ_NUM=%1%"
-                " AND FILE_STATE=%2%"
-                " AND REPL_NUM=%3%";
-
 /* ======== Migration ======== */
 
-const std::string Migration::ADD_JOB =
-        "INSERT INTO JOB_QUEUE (OPERATION, FILE_NAME, REQ_NUM, TARGET_STATE, REPL_NUM, TAPE_POOL,"
-                " FILE_SIZE, FS_ID_H, FS_ID_L, I_GEN, I_NUM, MTIME_SEC, MTIME_NSEC, LAST_UPD, TAPE_ID, FILE_STATE)"
-                " VALUES (" /* OPERATION */"%1%, " /* FILE_NAME */"'%2%', " /* REQ_NUM */"%3%, "
-                /* TARGET_STATE */"%4%, " /* REPL_NUM */"?, " /* TAPE_POOL */"?, "
-                /* FILE_SIZE */"%5%, " /* FS_ID_H */"%6%, " /* FS_ID_L */"%7%, " /* I_GEN */"%8%,"
-                /* I_NUM */"%9%, "/* MTIME_SEC */"%10%, " /* MTIME_NSEC */"%11%, " /* LAST_UPD */"%12%, "
-                /* TAPE_ID */"'', " /* FILE_STATE */"%13%)";
-
 const std::string Migration::ADD_REQUEST =
         "INSERT INTO REQUEST_QUEUE (OPERATION, REQ_NUM, TARGET_STATE,"
                 " NUM_REPL, REPL_NUM, TAPE_POOL, TAPE_ID, TIME_ADDED, STATE)"
@@ -164,134 +416,67 @@ const std::string Migration::ADD_REQUEST =
                 /* NUM_REPL */"%4%, " /* REPL_NUM */"%5%, " /* TAPE_POOL */"'%6%', "
                 /* TAPE_ID */"'', " /* TIME_ADDED */"%7%, " /* STATE */"%8%);";
 
-const std::string Migration::FAIL_PREMIGRATION =
-        "UPDATE JOB_QUEUE SET FILE_STATE=%1%"
-                " WHERE REQ_NUM=%2%"
-                " AND FILE_NAME='%3%'"
-                " AND REPL_NUM=%4%";
-
-const std::string Migration::FAIL_STUBBING =
-        "UPDATE JOB_QUEUE SET FILE_STATE=%1%"
-                " WHERE REQ_NUM=%2%"
-                " AND FILE_NAME='%3%'";
-
-const std::string Migration::SET_TRANSFERRING =
-        "UPDATE JOB_QUEUE SET FILE_STATE=%1%,"
-                " TAPE_ID='%2%'"
-                " WHERE REQ_NUM=%3%"
-                " AND FILE_STATE=%4%"
-                " AND REPL_NUM=%5%"
-                " AND FITS(I_NUM, FILE_SIZE, %6%, %7%, %8%)=1";
-
-const std::string Migration::SET_CHANGE_STATE =
-        "UPDATE JOB_QUEUE SET FILE_STATE=%1%"
+const std::string Migration::UPDATE_REQUEST =
+        "UPDATE REQUEST_QUEUE SET STATE=%1%"
                 " WHERE REQ_NUM=%2%"
-                " AND FILE_STATE=%3%"
-                " AND TAPE_ID='%4%'"
-                " AND REPL_NUM=%5%";
-
-const std::string Migration::SELECT_JOBS =
-        "SELECT FILE_NAME, MTIME_SEC, MTIME_NSEC, I_NUM FROM JOB_QUEUE WHERE"
-                " REQ_NUM=%1%"
-                " AND FILE_STATE=%2%"
-                " AND TAPE_ID='%3%'";
+                " AND REPL_NUM=%3%"
+                " AND TAPE_ID='%4%'";
 
-const std::string Migration::SET_JOB_SUCCESS =
+const std::string Migration::RESUME_JOBS =
         "UPDATE JOB_QUEUE SET FILE_STATE=%1%"
-                " WHERE REQ_NUM=%2%"
-                " AND FILE_STATE=%3%"
-                " AND TAPE_ID='%4%'"
-                " AND I_NUM IN (%5%)";
+                " WHERE OPERATION=%2%"
+                " AND FILE_STATE=%3%";
 
-const std::string Migration::RESET_JOB_STATE =
+const std::string Migration::RESUME_UNASSIGNED_JOBS =
         "UPDATE JOB_QUEUE SET FILE_STATE=%1%"
-                " WHERE REQ_NUM=%2%"
+                " WHERE OPERATION=%2%"
                 " AND FILE_STATE=%3%"
-                " AND TAPE_ID='%4%'";
+                " AND TAPE_ID=''";
 
-const std::string Migration::FAIL_PREMIGRATED =
-        "UPDATE JOB_QUEUE SET FILE_STATE=%1%"
-                " WHERE REQ_NUM=%2%"
-                " AND FILE_STATE=%3%"
-                " AND TAPE_ID='%4%'"
-                " AND REPL_NUM=%5%";
-
-const std::string Migration::UPDATE_REQUEST =
-        "UPDATE REQUEST_QUEUE SET STATE=%1%"
-                " WHERE REQ_NUM=%2%"
-                " AND REPL_NUM=%3%";
-
-const std::string Migration::UPDATE_REQUEST_RESET_TAPE =
-        "UPDATE REQUEST_QUEUE SET STATE=%1%, TAPE_ID=''"
-                " WHERE REQ_NUM=%2%"
-                " AND REPL_NUM=%3%";
+const std::string Migration::RESUME_TRANSFERS =
+        "UPDATE JOB_QUEUE SET FILE_STATE=%1%,"
+                " TAPE_ID=''"
+                " WHERE OPERATION=%2%"
+                " AND FILE_STATE=%3%";
+
+const std::string Migration::DELETE_SESSIONS =
+        "DELETE FROM REQUEST_QUEUE WHERE OPERATION=%1%"
+                " AND TAPE_ID<>''"
+                " AND NOT EXISTS (SELECT 1 FROM JOB_QUEUE"
+                " WHERE JOB_QUEUE.REQ_NUM=REQUEST_QUEUE.REQ_NUM"
+                " AND JOB_QUEUE.REPL_NUM=REQUEST_QUEUE.REPL_NUM"
+                " AND JOB_QUEUE.TAPE_ID=REQUEST_QUEUE.TAPE_ID"
+                " AND JOB_QUEUE.FILE_STATE=%2%)";
+
+const std::string Migration::RESUME_REQUESTS =
+        "SELECT REQ_NUM, TARGET_STATE, NUM_REPL, REPL_NUM, TAPE_POOL,"
+                " TAPE_ID, TIME_ADDED FROM REQUEST_QUEUE"
+                " WHERE OPERATION=%1%";
 
 /* ======== SelRecall ======== */
 
-const std::string SelRecall::ADD_JOB =
-        "INSERT INTO JOB_QUEUE (OPERATION, FILE_NAME, REQ_NUM, TARGET_STATE, FILE_SIZE, FS_ID_H, FS_ID_L, I_GEN,"
-                " I_NUM, MTIME_SEC, MTIME_NSEC, LAST_UPD, FILE_STATE, TAPE_ID, START_BLOCK)"
-                " VALUES (" /* OPERATION */"%1%, " /* FILE_NAME */"'%2%', " /* REQ_NUM */"%3%, "
-                /* TARGET_STATE */"%4%, " /* FILE_SIZE */"%5%, " /* FS_ID_H */"%6%, " /* FS_ID_L */"%7%, "
-                /* I_GEN */"%8%, " /* I_NUM */"%9%, " /* MTIME_SEC */"%10%, " /* MTIME_NSEC */"%11%, "
-                /* LAST_UPD */"%12%, " /* FILE_STATE */"%13%, " /* TAPE_ID */"'%14%', " /* START_BLOCK */"%15%)";
-
-const std::string SelRecall::GET_TAPES =
-        "SELECT TAPE_ID FROM JOB_QUEUE WHERE REQ_NUM=%1%"
-                " GROUP BY TAPE_ID";
-
 const std::string SelRecall::ADD_REQUEST =
         "INSERT INTO REQUEST_QUEUE (OPERATION, REQ_NUM, TARGET_STATE, TAPE_ID, TIME_ADDED, STATE)"
                 " VALUES (" /* OPERATION */"%1%, " /* REQ_NUM */"%2%, " /* TARGET_STATE */"%3%, "
                 /* TAPE_ID */"'%4%', " /* TIME_ADDED */"%5%, " /* STATE */"%6%)";
 
-const std::string SelRecall::SET_RECALLING =
-        "UPDATE JOB_QUEUE SET FILE_STATE=%1%"
-                " WHERE REQ_NUM=%2%"
-                " AND FILE_STATE=%3%"
-                " AND TAPE_ID='%4%'";
-
-//! [sel_recall_sql_qry]
-const std::string SelRecall::SELECT_JOBS =
-        "SELECT FILE_NAME, FILE_STATE, I_NUM FROM JOB_QUEUE WHERE REQ_NUM=%1%"
-                " AND TAPE_ID='%2%'"
-                " AND (FILE_STATE=%3% OR FILE_STATE=%4%)"
-                " ORDER BY START_BLOCK";
-//! [sel_recall_sql_qry]
-
-const std::string SelRecall::FAIL_JOB = "UPDATE JOB_QUEUE SET FILE_STATE = %1%"
-        " WHERE FILE_NAME='%2%'"
-        " AND REQ_NUM=%3%"
-        " AND TAPE_ID='%4%'";
-
-const std::string SelRecall::SET_JOB_SUCCESS =
-        "UPDATE JOB_QUEUE SET FILE_STATE = %1%"
-                " WHERE REQ_NUM=%2%"
-                " AND TAPE_ID='%3%'"
-                " AND (FILE_STATE=%4% OR FILE_STATE=%5%)"
-                " AND I_NUM IN (%6%)";
-
-const std::string SelRecall::RESET_JOB_STATE =
-        "UPDATE JOB_QUEUE SET FILE_STATE = %1%"
-                " WHERE REQ_NUM=%2%"
-                " AND TAPE_ID='%3%'"
-                " AND FILE_STATE=%4%";
-
 const std::string SelRecall::UPDATE_REQUEST =
         "UPDATE REQUEST_QUEUE SET STATE=%1%"
                 " WHERE REQ_NUM=%2%"
                 " AND TAPE_ID='%3%';";
 
-/* ======== TransRecall ======== */
+const std::string SelRecall::RESUME_JOBS =
+        "UPDATE JOB_QUEUE SET FILE_STATE=%1%"
+                " WHERE OPERATION=%2%"
+                " AND FILE_STATE=%3%";
 
-const std::string TransRecall::ADD_JOB =
-        "INSERT INTO JOB_QUEUE (OPERATION, FILE_NAME, REQ_NUM, TARGET_STATE, REPL_NUM, FILE_SIZE, FS_ID_H, FS_ID_L, I_GEN,"
-                " I_NUM, MTIME_SEC, MTIME_NSEC, LAST_UPD, FILE_STATE, TAPE_ID, START_BLOCK, CONN_INFO)"
-                " VALUES (" /* OPERATION */"%1%, " /* FILE_NAME */"%2%, " /* REQ_NUM */"%3%, "
-                /* TARGET_STATE */"%4%, " /* REPL_NUM */"%5%, " /* FILE_SIZE */"%6%, " /* FS_ID */"%7%, " /* FS_ID */"%8%, "
-                /* I_GEN */"%9%, " /* I_NUM */"%10%, " /* MTIME_SEC */"%11%, " /* MTIME_NSEC */"%12%, "
-                /* LAST_UPD */"%13%, " /* FILE_STATE */"%14%, " /* TAPE_ID */"'%15%', " /* START_BLOCK */"%16%, "
-                /* CONN_INFO */"%17%)";
+const std::string SelRecall::RESUME_REQUESTS =
+        "SELECT REQ_NUM, TARGET_STATE, TAPE_ID, TIME_ADDED FROM REQUEST_QUEUE"
+                " WHERE OPERATION=%1%"
+                " AND STATE<>%2%"
+                " AND TAPE_ID<>'%3%'";
+
+/* ======== TransRecall ======== */
 
 const std::string TransRecall::CHECK_REQUEST_EXISTS =
         "SELECT STATE FROM REQUEST_QUEUE WHERE REQ_NUM=%1%";
@@ -305,34 +490,14 @@ const std::string TransRecall::ADD_REQUEST =
                 " VALUES (" /* OPERATION */"%1%, " /* REQ_NUMR */"%2%, " /* TARGET_STATE */"'%3%', "
                 /* TAPE_ID */"'%4%', " /* TIME_ADDED */"%5%, " /* STATE */"%6%)";
 
-const std::string TransRecall::REMAINING_JOBS =
-        "SELECT FS_ID_H, FS_ID_L, I_GEN, I_NUM, FILE_NAME, CONN_INFO  FROM JOB_QUEUE"
-                " WHERE OPERATION=%1%";
+/* ======== RecallSession ======== */
 
-const std::string TransRecall::SET_RECALLING =
-        "UPDATE JOB_QUEUE SET FILE_STATE=%1%"
+const std::string RecallSession::UPDATE_REQUEST =
+        "UPDATE REQUEST_QUEUE SET STATE=%1%"
                 " WHERE REQ_NUM=%2%"
-                " AND FILE_STATE=%3%"
-                " AND TAPE_ID='%4%'";
-
-//! [trans_recall_sql_qry]
-const std::string TransRecall::SELECT_JOBS =
-        "SELECT FS_ID_H, FS_ID_L, I_GEN, I_NUM, FILE_NAME, FILE_STATE, TARGET_STATE, CONN_INFO  FROM JOB_QUEUE"
-                " WHERE REQ_NUM=%1%"
-                " AND (FILE_STATE=%2% OR FILE_STATE=%3%)"
-                " AND TAPE_ID='%4%' ORDER BY START_BLOCK";
-//! [trans_recall_sql_qry]
-
-const std::string TransRecall::DELETE_JOBS = "DELETE FROM JOB_QUEUE"
-        " WHERE REQ_NUM=%1%"
-        " AND (FILE_STATE=%2% OR FILE_STATE=%3%)"
-        " AND TAPE_ID='%4%'";
-
-const std::string TransRecall::COUNT_REMAINING_JOBS =
-        "SELECT COUNT(*) FROM JOB_QUEUE WHERE REQ_NUM=%1%"
-                " AND TAPE_ID='%2%'";
+                " AND TAPE_ID='%3%'";
 
-const std::string TransRecall::DELETE_REQUEST =
+const std::string RecallSession::DELETE_REQUEST =
         "DELETE FROM REQUEST_QUEUE WHERE REQ_NUM=%1%"
                 " AND TAPE_ID='%2%'";
 
@@ -341,9 +506,6 @@ const std::string TransRecall::DELETE_REQUEST =
 const std::string FileOperation::REQUEST_STATE =
         "SELECT STATE FROM REQUEST_QUEUE WHERE REQ_NUM=%1%";
 
-const std::string FileOperation::DELETE_JOBS =
-        "DELETE FROM JOB_QUEUE WHERE REQ_NUM=%1%";
-
 const std::string FileOperation::DELETE_REQUESTS =
         "DELETE FROM REQUEST_QUEUE WHERE REQ_NUM=%1%";
 
@@ -352,30 +514,169 @@ const std::string FileOperation::DELETE_REQUESTS =
 const std::string MessageParser::ALL_REQUESTS =
         "SELECT STATE FROM REQUEST_QUEUE";
 
-const std::string MessageParser::INFO_ALL_REQUESTS =
+const std::string MessageParser::INFO_REQUESTS =
         "SELECT OPERATION, REQ_NUM, TAPE_ID, TARGET_STATE, STATE, TAPE_POOL"
-                " FROM REQUEST_QUEUE";
+                " FROM REQUEST_QUEUE%1%%2%";
 
-const std::string MessageParser::INFO_ONE_REQUEST =
-        "SELECT OPERATION, REQ_NUM, TAPE_ID, TARGET_STATE, STATE, TAPE_POOL"
-                " FROM REQUEST_QUEUE"
-                " WHERE REQ_NUM=%1%";
+const std::string MessageParser::FILTER_REQ_NUM = "REQ_NUM=%1%";
 
-const std::string MessageParser::INFO_ALL_JOBS =
-        "SELECT OPERATION, FILE_NAME, REQ_NUM, TAPE_POOL,"
-                " FILE_SIZE, TAPE_ID, FILE_STATE FROM JOB_QUEUE";
+const std::string MessageParser::FILTER_OPERATION = "OPERATION IN (%1%)";
 
-const std::string MessageParser::INFO_SEL_JOBS =
+const std::string MessageParser::FILTER_REQ_STATE = "STATE IN (%1%)";
+
+const std::string MessageParser::FILTER_TAPE_ID = "TAPE_ID='%1%'";
+
+const std::string MessageParser::FILTER_TAPE_POOL = "TAPE_POOL='%1%'";
+
+const std::string MessageParser::PAGE = " ORDER BY %1% LIMIT %2% OFFSET %3%";
+
+/* ======== SQLJobStore ======== */
+
+const std::string SQLJobStore::ADD_MIG_JOB =
+        "INSERT INTO JOB_LIST (OPERATION, FILE_NAME, REQ_NUM, TARGET_STATE, REPL_NUM, TAPE_POOL,"
+                " FILE_SIZE, FS_ID_H, FS_ID_L, I_GEN, I_NUM, MTIME_SEC, MTIME_NSEC, LAST_UPD, TAPE_ID, FILE_STATE)"
+                " VALUES (" /* OPERATION */"%1%, " /* FILE_NAME */"'%2%', " /* REQ_NUM */"%3%, "
+                /* TARGET_STATE */"%4%, " /* REPL_NUM */"%14%, " /* TAPE_POOL */"'%15%', "
+                /* FILE_SIZE */"%5%, " /* FS_ID_H */"%6%, " /* FS_ID_L */"%7%, " /* I_GEN */"%8%,"
+                /* I_NUM */"%9%, "/* MTIME_SEC */"%10%, " /* MTIME_NSEC */"%11%, " /* LAST_UPD */"%12%, "
+                /* TAPE_ID */"'', " /* FILE_STATE */"%13%)";
+
+const std::string SQLJobStore::ADD_SELRECALL_JOB =
+        "INSERT INTO JOB_LIST (OPERATION, FILE_NAME, REQ_NUM, TARGET_STATE, FILE_SIZE, FS_ID_H, FS_ID_L, I_GEN,"
+                " I_NUM, MTIME_SEC, MTIME_NSEC, LAST_UPD, FILE_STATE, TAPE_ID, START_BLOCK)"
+                " VALUES (" /* OPERATION */"%1%, " /* FILE_NAME */"'%2%', " /* REQ_NUM */"%3%, "
+                /* TARGET_STATE */"%4%, " /* FILE_SIZE */"%5%, " /* FS_ID_H */"%6%, " /* FS_ID_L */"%7%, "
+                /* I_GEN */"%8%, " /* I_NUM */"%9%, " /* MTIME_SEC */"%10%, " /* MTIME_NSEC */"%11%, "
+                /* LAST_UPD */"%12%, " /* FILE_STATE */"%13%, " /* TAPE_ID */"'%14%', " /* START_BLOCK */"%15%)";
+
+const std::string SQLJobStore::ADD_TRARECALL_JOB =
+        "INSERT INTO JOB_LIST (OPERATION, FILE_NAME, REQ_NUM, TARGET_STATE, REPL_NUM, FILE_SIZE, FS_ID_H, FS_ID_L, I_GEN,"
+                " I_NUM, MTIME_SEC, MTIME_NSEC, LAST_UPD, FILE_STATE, TAPE_ID, START_BLOCK, CONN_INFO)"
+                " VALUES (" /* OPERATION */"%1%, " /* FILE_NAME */"%2%, " /* REQ_NUM */"%3%, "
+                /* TARGET_STATE */"%4%, " /* REPL_NUM */"%5%, " /* FILE_SIZE */"%6%, " /* FS_ID */"%7%, " /* FS_ID */"%8%, "
+                /* I_GEN */"%9%, " /* I_NUM */"%10%, " /* MTIME_SEC */"%11%, " /* MTIME_NSEC */"%12%, "
+                /* LAST_UPD */"%13%, " /* FILE_STATE */"%14%, " /* TAPE_ID */"'%15%', " /* START_BLOCK */"%16%, "
+                /* CONN_INFO */"%17%)";
+
+const std::string SQLJobStore::FAIL_JOB =
+        "UPDATE JOB_QUEUE SET FILE_STATE=%1%"
+                " WHERE ROWID=%2%";
+
+const std::string SQLJobStore::FAIL_REPLICAS =
+        "UPDATE JOB_QUEUE SET FILE_STATE=%1%"
+                " WHERE +REQ_NUM=%2%"
+                " AND DIR_ID=(SELECT DIR_ID FROM JOB_QUEUE WHERE ROWID=%3%)"
+                " AND NAME=(SELECT NAME FROM JOB_QUEUE WHERE ROWID=%3%)";
+
+const std::string SQLJobStore::SET_RESUME_OFFSET =
+        "UPDATE JOB_QUEUE SET RESUME_OFFSET=%1%,"
+                " RESUME_TAPE_ID='%2%'"
+                " WHERE ROWID=%3%";
+
+const std::string SQLJobStore::SET_STATE =
+        "UPDATE JOB_QUEUE SET FILE_STATE=%1%"
+                " WHERE ROWID=%2%"
+                " AND FILE_STATE=%3%";
+
+const std::string SQLJobStore::SET_RECALLED =
+        "UPDATE JOB_QUEUE SET FILE_STATE = %1%"
+                " WHERE ROWID=%2%"
+                " AND (FILE_STATE=%3% OR FILE_STATE=%4%)";
+
+const std::string SQLJobStore::ASSIGN_TAPE =
+        "UPDATE JOB_QUEUE SET FILE_STATE=%1%,"
+                " TAPE_ID='%2%'"
+                " WHERE ROWID=%3%"
+                " AND FILE_STATE=%4%";
+
+const std::string SQLJobStore::CHANGE_STATE =
+        "UPDATE JOB_QUEUE SET FILE_STATE=%1%"
+                " WHERE REQ_NUM IN (%2%)"
+                " AND FILE_STATE=%3%"
+                " AND TAPE_ID='%4%'";
+
+const std::string SQLJobStore::CHANGE_REPL_STATE =
+        "UPDATE JOB_QUEUE SET FILE_STATE=%1%"
+                " WHERE REQ_NUM IN (%2%)"
+                " AND FILE_STATE=%3%"
+                " AND TAPE_ID='%4%'"
+                " AND REPL_NUM=%5%";
+
+const std::string SQLJobStore::UNCLAIMED_JOBS =
+        "SELECT COUNT(*), SUM(FILE_SIZE), MAX(FILE_SIZE), MIN(FILE_SIZE)"
+                " FROM JOB_QUEUE WHERE"
+                " REQ_NUM=%1%"
+                " AND FILE_STATE=%2%"
+                " AND REPL_NUM=%3%";
+
+//! [migration_placement]
+const std::string SQLJobStore::SELECT_UNASSIGNED =
+        "SELECT ROWID, FILE_SIZE FROM JOB_QUEUE WHERE"
+                " REQ_NUM=%1%"
+                " AND FILE_STATE=%2%"
+                " AND REPL_NUM=%3%"
+                " ORDER BY FILE_SIZE DESC";
+//! [migration_placement]
+
+const std::string SQLJobStore::SELECT_MIG_JOBS =
+        "SELECT JOB_ID, FILE_NAME, MTIME_SEC, MTIME_NSEC, I_NUM, RESUME_OFFSET,"
+                " IFNULL(RESUME_TAPE_ID, '') FROM JOB_LIST WHERE"
+                " REQ_NUM=%1%"
+                " AND FILE_STATE=%2%"
+                " AND TAPE_ID='%3%'";
+
+//! [recall_session_sql_qry]
+const std::string SQLJobStore::SELECT_RECALL_JOBS =
+        "SELECT OPERATION, REQ_NUM, JOB_ID, FS_ID_H, FS_ID_L, I_GEN, I_NUM,"
+                " FILE_NAME, FILE_STATE, TARGET_STATE, CONN_INFO FROM JOB_LIST"
+                " WHERE REQ_NUM IN (%1%)"
+                " AND (FILE_STATE=%2% OR FILE_STATE=%3%)"
+                " AND TAPE_ID='%4%' ORDER BY START_BLOCK";
+//! [recall_session_sql_qry]
+
+const std::string SQLJobStore::SELECT_TRANS_RECALLS =
+        "SELECT REQ_NUM, JOB_ID, FS_ID_H, FS_ID_L, I_GEN, I_NUM, FILE_NAME,"
+                " FILE_STATE, TARGET_STATE, CONN_INFO FROM JOB_LIST"
+                " WHERE OPERATION=%1%";
+
+const std::string SQLJobStore::INFO_JOBS =
         "SELECT OPERATION, FILE_NAME, REQ_NUM, TAPE_POOL,"
-                " FILE_SIZE, TAPE_ID, FILE_STATE FROM JOB_QUEUE"
-                " WHERE REQ_NUM=%1%";
+                " FILE_SIZE, TAPE_ID, FILE_STATE FROM JOB_LIST%1%%2%";
+
+const std::string SQLJobStore::INFO_JOBS_GROUPED =
+        "SELECT %1%, COUNT(*), SUM(FILE_SIZE) FROM %2%%3%"
+                " GROUP BY %1%%4%";
+
+const std::string SQLJobStore::FILTER_FILE_STATE = "FILE_STATE IN (%1%)";
+
+const std::string SQLJobStore::FILTER_PATH_PREFIX =
+        "SUBSTR(FILE_NAME, 1, LENGTH('%1%'))='%1%'";
+
+const std::string SQLJobStore::GET_TAPES =
+        "SELECT TAPE_ID FROM JOB_QUEUE WHERE REQ_NUM=%1%"
+                " GROUP BY TAPE_ID";
+
+const std::string SQLJobStore::COUNT_JOBS =
+        "SELECT COUNT(*) FROM JOB_QUEUE WHERE REQ_NUM=%1%"
+                " AND TAPE_ID='%2%'"
+                " AND FILE_STATE=%3%";
 
-/* ======== Status ======== */
+const std::string SQLJobStore::COUNT_ALL_JOBS =
+        "SELECT COUNT(*) FROM JOB_QUEUE WHERE REQ_NUM=%1%"
+                " AND TAPE_ID='%2%'";
 
-const std::string Status::STATUS =
+const std::string SQLJobStore::COUNT_STATES =
         "SELECT FILE_STATE, COUNT(*) FROM JOB_QUEUE WHERE REQ_NUM=%1%"
                 " GROUP BY FILE_STATE";
 
+const std::string SQLJobStore::DELETE_RECALLED = "DELETE FROM JOB_QUEUE"
+        " WHERE REQ_NUM IN (%1%)"
+        " AND (FILE_STATE=%2% OR FILE_STATE=%3%)"
+        " AND TAPE_ID='%4%'";
+
+const std::string SQLJobStore::DELETE_JOBS =
+        "DELETE FROM JOB_QUEUE WHERE REQ_NUM=%1%";
+
 /* ======== Mount ======== */
 
 const std::string TapeMover::ADD_REQUEST =
@@ -396,3 +697,37 @@ const std::string TapeHandler::ADD_REQUEST =
 const std::string TapeHandler::DELETE_REQUEST =
         "DELETE FROM REQUEST_QUEUE WHERE REQ_NUM=%1%";
 
+/* ======== statements that need to use an index ======== */
+
+const std::list<std::pair<std::string, const std::string*>> DataBase::INDEXED_STATEMENTS =
+        {
+                { "Scheduler::UPDATE_REQUEST", &Scheduler::UPDATE_REQUEST },
+                { "Scheduler::UPDATE_REC_REQUEST", &Scheduler::UPDATE_REC_REQUEST },
+                { "Migration::UPDATE_REQUEST", &Migration::UPDATE_REQUEST },
+                { "SelRecall::UPDATE_REQUEST", &SelRecall::UPDATE_REQUEST },
+                { "TransRecall::CHECK_REQUEST_EXISTS", &TransRecall::CHECK_REQUEST_EXISTS },
+                { "TransRecall::CHANGE_REQUEST_TO_NEW", &TransRecall::CHANGE_REQUEST_TO_NEW },
+                { "RecallSession::UPDATE_REQUEST", &RecallSession::UPDATE_REQUEST },
+                { "RecallSession::DELETE_REQUEST", &RecallSession::DELETE_REQUEST },
+                { "FileOperation::REQUEST_STATE", &FileOperation::REQUEST_STATE },
+                { "FileOperation::DELETE_REQUESTS", &FileOperation::DELETE_REQUESTS },
+                { "SQLJobStore::FAIL_JOB", &SQLJobStore::FAIL_JOB },
+                { "SQLJobStore::FAIL_REPLICAS", &SQLJobStore::FAIL_REPLICAS },
+                { "SQLJobStore::SET_RESUME_OFFSET", &SQLJobStore::SET_RESUME_OFFSET },
+                { "SQLJobStore::SET_STATE", &SQLJobStore::SET_STATE },
+                { "SQLJobStore::SET_RECALLED", &SQLJobStore::SET_RECALLED },
+                { "SQLJobStore::ASSIGN_TAPE", &SQLJobStore::ASSIGN_TAPE },
+                { "SQLJobStore::CHANGE_STATE", &SQLJobStore::CHANGE_STATE },
+                { "SQLJobStore::CHANGE_REPL_STATE", &SQLJobStore::CHANGE_REPL_STATE },
+                { "SQLJobStore::UNCLAIMED_JOBS", &SQLJobStore::UNCLAIMED_JOBS },
+                { "SQLJobStore::SELECT_UNASSIGNED", &SQLJobStore::SELECT_UNASSIGNED },
+                { "SQLJobStore::SELECT_MIG_JOBS", &SQLJobStore::SELECT_MIG_JOBS },
+                { "SQLJobStore::SELECT_RECALL_JOBS", &SQLJobStore::SELECT_RECALL_JOBS },
+                { "SQLJobStore::GET_TAPES", &SQLJobStore::GET_TAPES },
+                { "SQLJobStore::COUNT_JOBS", &SQLJobStore::COUNT_JOBS },
+                { "SQLJobStore::COUNT_ALL_JOBS", &SQLJobStore::COUNT_ALL_JOBS },
+                { "SQLJobStore::COUNT_STATES", &SQLJobStore::COUNT_STATES },
+                { "SQLJobStore::DELETE_RECALLED", &SQLJobStore::DELETE_RECALLED },
+                { "SQLJobStore::DELETE_JOBS", &SQLJobStore::DELETE_JOBS },
+                { "TapeMover::DELETE_REQUEST", &TapeMover::DELETE_REQUEST },
+                { "TapeHandler::DELETE_REQUEST", &TapeHandler::DELETE_REQUEST } };
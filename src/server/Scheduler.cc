@@ -38,6 +38,38 @@
     Within the outer while loop of Scheduler::runthe condition Scheduler::cond
     is waiting for a lock on the Scheduler::mtx mutex.
 
+    Requests that are ready to be scheduled are kept in memory within the
+    ready queue Scheduler::readyQueue. It is ordered by the operation type
+    (see DataBase::operation), the service class of transparent recalls
+    (see @ref transparent_recall) and the time a request has been added. The
+    REQUEST_QUEUE table remains the persistent record of all requests
+    but it is not queried by the scheduler. The following methods are used
+    to maintain the ready queue:
+
+    method | description
+    ---|---
+    Scheduler::queueRequest | adds a request to the ready queue if it is not already waiting
+    Scheduler::requeueRequest | moves a suspended or only partially processed request back to the ready queue
+    Scheduler::completeRequest | removes a request that has been finished
+    Scheduler::sessionStarted | allows a further session of a migration request for a pool
+
+    A request is added by Migration::addRequest, SelRecall::addRequest,
+    TransRecall::addJob, TapeMover::addRequest, and TapeHandler::addRequest.
+    Once a request has been scheduled it is removed from the ready queue
+    and kept within Scheduler::inProgress until it is either finished or
+    needs to be scheduled again. For migration requests the size of the
+    smallest file to migrate is determined when the request is queued
+    and not each time the scheduler is woken up.
+
+    A migration request for a pool stays within the ready queue while it
+    has files that are not assigned to any cartridge. After a session
+    has been started for it the request is kept within
+    Scheduler::starting and skipped by Scheduler::nextRequest until the
+    session has assigned its share of the files
+    (Scheduler::sessionStarted) or is finished. Otherwise a further pass
+    of the scheduler would mount another cartridge of the pool for files
+    the first session is about to take.
+
     The scheduler also initiates mount and unmounts of cartridges. E.g. if there
     is a new request to migrate data but all available drives are empty the
     scheduler initiates a tape mount for a corresponding cartridge.
@@ -52,12 +84,14 @@
     - a tape unmount is completed (see @ref LTFSDMInventory::unmount): drive
       can be used to mount a cartridge
 
-    After that Scheduler::resAvail checks if there is a resource available
-    to schedule a request or to mount, move, or unmount cartridges
-    (Scheduler::resAvailTapeMove). For recall, format, or check operations a
-    specific cartridge needs to be considered (Scheduler::tapeResAvail). For
-    migration it needs to be a cartridge from a corresponding tape storage pool
-    where at least one file will fit on it (Scheduler::poolResAvail).
+    After that a scheduling pass is performed (SchedulerPolicy::schedule).
+    For each request of the ready queue SchedulerPolicy::resAvail checks if
+    there is a resource available to schedule a request or to mount, move,
+    or unmount cartridges (SchedulerPolicy::tapeMoveResAvail). For recall,
+    format, or check operations a specific cartridge needs to be considered
+    (SchedulerPolicy::tapeResAvail). For migration it needs to be a cartridge
+    from a corresponding tape storage pool where at least one file will fit
+    on it (SchedulerPolicy::poolResAvail).
 
     @dot
     digraph scheduler {
@@ -68,9 +102,9 @@
         node [shape=record, width=2, fontname="courier", fontsize=11, fillcolor=white, style=filled];
         wait [label="wait for a new request or a free resource"];
         subgraph cluster_res_avail {
-            res_avail [fontname="courier bold", fontcolor=dodgerblue4, label="Scheduler::resAvail", URL="@ref Scheduler::resAvail"];
-            tape_res_avail [fontname="courier bold", fontcolor=dodgerblue4, label="Scheduler::tapeResAvail", URL="@ref Scheduler::tapeResAvail"];
-            pool_res_avail [fontname="courier bold", fontcolor=dodgerblue4, label="Scheduler::poolResAvail", URL="@ref Scheduler::poolResAvail"];
+            res_avail [fontname="courier bold", fontcolor=dodgerblue4, label="SchedulerPolicy::resAvail", URL="@ref SchedulerPolicy::resAvail"];
+            tape_res_avail [fontname="courier bold", fontcolor=dodgerblue4, label="SchedulerPolicy::tapeResAvail", URL="@ref SchedulerPolicy::tapeResAvail"];
+            pool_res_avail [fontname="courier bold", fontcolor=dodgerblue4, label="SchedulerPolicy::poolResAvail", URL="@ref SchedulerPolicy::poolResAvail"];
         }
         schedule_mig [label="schedule migration"];
         schedule_rec [label="{<srec> schedule selective recall|<trec> schedule transparent recall}"];
@@ -82,34 +116,42 @@
     }
     @enddot
 
-    ## Scheduler::tapeResAvail
+    ## SchedulerPolicy::tapeResAvail
 
     A tape resource is checked for availability in the following way (return
     statements are performed in respect to the condition):
 
     -# If the corresponding cartridge is moving: <b>return false</b>.
-    -# If the corresponding cartridge is mounted (but not in use) it can be
-       used for the current request: <b>return true</b>.
+    -# If the corresponding cartridge is in use by an operation with a lower
+       priority (e.g. a migration and the current request is an interactive
+       recall) <b>suspend that operation</b> and <b>return false</b>.
+    -# If the corresponding cartridge is mounted (but not in use) and its
+       drive is not reserved to move a cartridge for another request it can
+       be used for the current request: <b>return true</b>.
     -# If there is a free (not in use) drive: <b>mount tape</b> and <b>return false</b>.
+    -# If a tape move already is in progress for the current request:
+       <b>return false</b>.
     -# If there is a drive that has cartridge mounted that is not in use:
        <b>unmount tape</b> and <b>return false</b>.
     -# Next it is checked if a operation with a lower priority can be
        suspended. E.g. the cartridge is used for migration recall requests
        have a higher priority and can led the migration request to suspend
        processing. If an operation already has been suspended
-       (LTFSDMCartridge::isRequested is true): <b>return false.</b>
+       (LTFSDMCartridge::isRequested is true): <b>return false.</b> The
+       flag is reset as soon as the cartridge gets a drive.
     -# Now try to <b>suspend an operation</b>.
     -# <b>return false</b>
 
 
-    ## Scheduler::poolResAvail
+    ## SchedulerPolicy::poolResAvail
 
     A tape storage pool is checked for availability in the following way
     (return statements are performed in respect to the condition):
 
     -# If a cartridge of the specified tape storage pool is mounted but not in
-       use and the remaining space is larger than the smallest file to migrate:
-       <b>return true</b>.
+       use, its drive is not reserved to move a cartridge for another
+       request, and the remaining space is larger than the smallest file to
+       migrate: <b>return true</b>.
     -# If there is no cartridge that is not mounted there is no need to look
        for a cartridge from another pool to unmount: <b>return false</b>.
     -# Check if there is an empty drive to mount a tape which is part of the
@@ -120,469 +162,836 @@
        is mounted but not in use. <b>Unmount tape</b> and <b>return false</b>.
     -# <b>return false</b>
 
+    ## Minimizing tape mounts
+
+    Tape mounts and unmounts take one to two minutes each. If the backend
+    is started with the option <TT>-t &lt;seconds&gt;</TT> a minimum dwell
+    time for mounted cartridges is set (Scheduler::minDwellTime) and the
+    scheduler tries to reduce the number of tape mounts:
+
+    - Within each scheduling pass all requests are considered first that
+      can be processed on cartridges that are already mounted. Thereafter
+      the remaining requests are processed that may require a mount or an
+      unmount. All queued requests for a mounted cartridge are therefore
+      processed before that cartridge is released. Requests on mounted
+      cartridges are only considered first if their priority (operation
+      and service class, SchedulerPolicy::priority) is not lower than the
+      one of the first request within the ready queue that waits for a
+      drive. Otherwise e.g. a migration that has been suspended for a
+      recall would continue on its cartridge before the recall got a drive.
+    - If a cartridge needs to be unmounted to free a drive
+      (SchedulerPolicy::selectUnmount) a cartridge that still has pending work
+      within the ready queue with at least the priority of the waiting
+      request is not unmounted before the minimum dwell time has passed.
+      Among the remaining cartridges the one with the lowest estimated cost
+      is selected: the time to unmount it plus the time to mount it again
+      for each of its pending requests (see Const::UNMOUNT_TIME_ESTIMATE and
+      Const::MOUNT_TIME_ESTIMATE).
+
+    Without this option the first idle mounted cartridge is unmounted.
+
+    ## Drive limits
+
+    For each tape storage pool and operation (migration or recall) a minimum
+    number of reserved drives and a maximum number of drives can be set by
+    the @ref ltfsdm_pool_limit "ltfsdm pool limit" command. The limits are
+    stored within the configuration (Configuration::poolSetLimits). Before
+    SchedulerPolicy::resAvail is called for a migration, selective recall, or
+    transparent recall request SchedulerPolicy::driveLimitReached checks if
+    the request can use a further drive. The number of drives in use per
+    pool and operation is determined from the requests that are in progress
+    (Scheduler::inProgress). The pool of a recall request is the pool of its
+    cartridge. A request is not scheduled if
+
+    - the maximum number of drives (if not 0) for its pool and operation
+      already is in use or
+    - using a further drive would leave less drives free than are reserved
+      for other pools and operations but currently not in use.
+
+    E.g. with a minimum of one drive for recalls from a pool a migration
+    to any pool never takes the last free drive. Tape mount, unmount,
+    format, and check operations are not limited.
+
+    ## Pre-mounting cartridges
+
+    If the backend is started with the -p option (Scheduler::premountHot)
+    cartridges that have been used for recalls frequently are mounted in
+    advance. For each cartridge a recall score is maintained: a file that
+    is added to a selective or transparent recall request increases the
+    score by one (LTFSDMInventory::addRecall) unless the previous increase
+    is less than Const::BULK_RECALL_WINDOW seconds ago. The score halves every
+    Const::RECALL_HISTORY_HALF_LIFE seconds (LTFSDMInventory::getRecallScore).
+    A burst of recalls or a large selective recall therefore counts like a
+    single access and only cartridges that are accessed repeatedly become
+    hot.
+    At the end of each scheduling pass SchedulerPolicy::premount looks for the
+    unmounted cartridge with the highest score. If the ready queue is
+    empty, no other cartridge is pre-mounted at that time, and the score is
+    at least Const::PREMOUNT_MIN_SCORE:
+
+    - the cartridge is mounted on a drive without a cartridge or
+    - if there is no such drive the mounted cartridge with the lowest
+      score that is not in use and that is mounted longer than the minimum
+      dwell time is unmounted if its score is less than the one of the
+      hottest cartridge by the factor Const::PREMOUNT_SCORE_RATIO. The
+      hottest cartridge is mounted within the next pass.
+
+    The drive is reserved by the move request number
+    SchedulerPolicy::PREMOUNT_REQNUM until the mount or unmount is completed. A
+    pre-mounted cartridge is treated like any other mounted cartridge: it
+    can be unmounted again as soon as a request needs the drive for
+    another cartridge. With the -p option SchedulerPolicy::selectUnmount
+    unmounts the cartridge with the lowest recall score among those with
+    the same estimated cost such that hot cartridges stay mounted.
+
+    ## Scheduling policy
+
+    The scheduling pass itself does not depend on the inventory or on the
+    data base. It is implemented by SchedulerPolicy: the order of the ready
+    queue (SchedulerPolicy::queueKey), the aging of bulk recalls
+    (SchedulerPolicy::ageRequests), the two phases of the pass, the
+    resource checks, the drive limits, the selection of the cartridge to
+    unmount, the suspension of operations, pre-mounting, and the share of
+    a migration session (SchedulerPolicy::migrationShare). The Scheduler
+    provides the ready queue, the drives, and the cartridges of the
+    inventory by the SchedulerPolicy::Resources interface and carries out
+    the tape moves and the dispatching of requests. The same code is
+    linked into the simulator (see @ref simulator) which implements this
+    interface for a simulated library.
+
     ## Schedule request
 
-    If Scheduler::resAvail is true a request can be scheduled. Depending on
-    the operation type  a new thread is created (Scheduler::subs,
-    SubServer::enqueue) to execute:
+    If SchedulerPolicy::resAvail is true a request can be scheduled
+    (Scheduler::dispatch). Depending on the operation type a new thread is
+    created (Scheduler::subs, SubServer::enqueue) to execute:
 
     operation type | executed method
     ---|---
     DataBase::MIGRATION | Migration::execRequest
-    DataBase::SELRECALL | SelRecall::execRequest
-    DataBase::TRARECALL | TransRecall::execRequest
+    DataBase::SELRECALL | RecallSession::execRequest
+    DataBase::TRARECALL | RecallSession::execRequest
+
+    A recall session also takes over all other selective and transparent
+    recall requests of the ready queue for the same cartridge
+    (Scheduler::claimRecalls, see @ref recall_session).
 
  */
 
 std::mutex Scheduler::mtx;
 std::condition_variable Scheduler::cond;
+bool Scheduler::invoked = false;
 std::mutex Scheduler::updmtx;
 std::condition_variable Scheduler::updcond;
 std::map<int, std::atomic<bool>> Scheduler::updReq;
+std::mutex Scheduler::queuemtx;
+std::set<Scheduler::request_t, Scheduler::queue_order> Scheduler::readyQueue;
+std::map<Scheduler::reqkey_t, Scheduler::request_t> Scheduler::queued;
+std::map<Scheduler::reqkey_t, Scheduler::request_t> Scheduler::inProgress;
+std::set<Scheduler::reqkey_t> Scheduler::starting;
+std::map<std::string, std::map<SchedulerPolicy::priority_t, int>> Scheduler::pendingTape;
+std::map<std::string, std::map<SchedulerPolicy::priority_t, int>> Scheduler::pendingPool;
+std::atomic<int> Scheduler::minDwellTime(0);
+std::atomic<int> Scheduler::recallLatency(0);
+std::atomic<bool> Scheduler::premountHot(false);
+
+static_assert(SchedulerPolicy::MOUNT == (int) DataBase::MOUNT
+        && SchedulerPolicy::MOVE == (int) DataBase::MOVE
+        && SchedulerPolicy::TRARECALL == (int) DataBase::TRARECALL
+        && SchedulerPolicy::SELRECALL == (int) DataBase::SELRECALL
+        && SchedulerPolicy::MIGRATION == (int) DataBase::MIGRATION
+        && SchedulerPolicy::FORMAT == (int) DataBase::FORMAT
+        && SchedulerPolicy::CHECK == (int) DataBase::CHECK
+        && SchedulerPolicy::UNMOUNT == (int) DataBase::UNMOUNT
+        && SchedulerPolicy::NOOP == (int) DataBase::NOOP,
+        "SchedulerPolicy::operation differs from DataBase::operation");
+static_assert(SchedulerPolicy::INTERACTIVE == (int) TransRecall::INTERACTIVE
+        && SchedulerPolicy::BULK == (int) TransRecall::BULK,
+        "SchedulerPolicy::recall_class differs from TransRecall::recall_class");
+static_assert(SchedulerPolicy::MIGRATION_DRIVES
+        == (int) Configuration::MIGRATION_DRIVES
+        && SchedulerPolicy::RECALL_DRIVES == (int) Configuration::RECALL_DRIVES,
+        "SchedulerPolicy::drive_op differs from Configuration::drive_op");
+
+bool Scheduler::queue_order::operator()(const request_t& a,
+        const request_t& b) const
 
-void Scheduler::makeUse(std::string driveId, std::string tapeId)
+{
+    return SchedulerPolicy::queueKey(a.op, a.recClass, a.aged, a.timeAdded,
+            a.reqNum, a.replNum, a.tapeId)
+            < SchedulerPolicy::queueKey(b.op, b.recClass, b.aged, b.timeAdded,
+                    b.reqNum, b.replNum, b.tapeId);
+}
+
+SchedulerPolicy::request_t Scheduler::policyRequest(const request_t& req)
+
+{
+    return (SchedulerPolicy::request_t ) { req.op, req.reqNum, req.replNum,
+                    req.pool, req.tapeId, req.driveId,
+                    (double) req.timeAdded, req.minFileSize, req.recClass,
+                    req.aged };
+}
+
+SchedulerPolicy::config_t Scheduler::policyConfig()
+
+{
+    SchedulerPolicy::config_t conf;
+
+    conf.minDwellTime = minDwellTime;
+    conf.recallLatency = recallLatency;
+    conf.premountHot = premountHot;
+
+    for (std::pair<const Configuration::limitkey_t,
+            Configuration::drive_limits>& limit : Server::conf.getDriveLimits())
+        conf.limits[limit.first] = (SchedulerPolicy::drive_limits ) {
+                        limit.second.minDrives, limit.second.maxDrives };
+
+    return conf;
+}
+
+std::list<std::string> Scheduler::getDriveIds()
+
+{
+    std::list<std::string> driveIds;
+
+    for (std::shared_ptr<LTFSDMDrive> drive : inventory->getDriveList())
+        driveIds.push_back(drive->get_le()->GetObjectID());
+
+    return driveIds;
+}
+
+bool Scheduler::driveIsBusy(std::string driveId)
+
+{
+    return inventory->getDrive(driveId)->isBusy();
+}
+
+int Scheduler::getMoveReqNum(std::string driveId)
+
+{
+    return inventory->getDrive(driveId)->getMoveReqNum();
+}
+
+std::string Scheduler::getMoveReqPool(std::string driveId)
+
+{
+    return inventory->getDrive(driveId)->getMoveReqPool();
+}
+
+std::string Scheduler::getMountedCartridge(std::string driveId)
+
+{
+    std::shared_ptr<LTFSDMCartridge> cart = inventory->getMountedCartridge(
+            inventory->getDrive(driveId));
+
+    if (cart == nullptr || cart->getState() != LTFSDMCartridge::TAPE_MOUNTED)
+        return "";
+
+    return cart->get_le()->GetObjectID();
+}
+
+int Scheduler::getToUnblock(std::string driveId)
+
+{
+    return inventory->getDrive(driveId)->getToUnblock();
+}
+
+void Scheduler::setToUnblock(std::string driveId, int op)
 
 {
-    std::shared_ptr<LTFSDMCartridge> cart = inventory->getCartridge(tapeId);
     std::shared_ptr<LTFSDMDrive> drive = inventory->getDrive(driveId);
 
-    TRACE(Trace::always, driveId, tapeId);
-    drive->setBusy();
-    cart->setState(LTFSDMCartridge::TAPE_INUSE);
+    TRACE(Trace::always, op, drive->getToUnblock(), driveId);
+    drive->setToUnblock(static_cast<DataBase::operation>(op));
 }
 
-bool Scheduler::driveIsUsable(std::shared_ptr<LTFSDMDrive> drive)
+std::list<std::string> Scheduler::getCartridgeIds()
 
 {
-    int rn = drive->getMoveReqNum();
-    std::string p = drive->getMoveReqPool();
+    std::list<std::string> tapeIds;
 
-    if (drive->isBusy() == true)
-        return false;
+    for (std::shared_ptr<LTFSDMCartridge> cart : inventory->getCartridgeList())
+        tapeIds.push_back(cart->get_le()->GetObjectID());
 
-    if (rn != Const::UNSET && !(rn == reqNum && p.compare(pool) == 0))
-        return false;
+    return tapeIds;
+}
 
-    return true;
+SchedulerPolicy::cart_state Scheduler::getCartridgeState(std::string tapeId)
+
+{
+    std::shared_ptr<LTFSDMCartridge> cart = inventory->getCartridge(tapeId);
+
+    if (cart == nullptr)
+        return SchedulerPolicy::CART_UNKNOWN;
+
+    switch (cart->getState()) {
+        case LTFSDMCartridge::TAPE_INUSE:
+            return SchedulerPolicy::CART_INUSE;
+        case LTFSDMCartridge::TAPE_MOUNTED:
+            return SchedulerPolicy::CART_MOUNTED;
+        case LTFSDMCartridge::TAPE_MOVING:
+            return SchedulerPolicy::CART_MOVING;
+        case LTFSDMCartridge::TAPE_UNMOUNTED:
+            return SchedulerPolicy::CART_UNMOUNTED;
+        default:
+            return SchedulerPolicy::CART_UNKNOWN;
+    }
 }
 
-void Scheduler::moveTape(std::string driveId, std::string tapeId,
-        TapeMover::operation top)
+std::string Scheduler::getMountingDrive(std::string tapeId)
 
 {
     std::shared_ptr<LTFSDMCartridge> cart = inventory->getCartridge(tapeId);
-    std::shared_ptr<LTFSDMDrive> drive = inventory->getDrive(driveId);
+    std::shared_ptr<LTFSDMDrive> drive;
+
+    if (cart == nullptr
+            || (drive = inventory->getMountingDrive(cart)) == nullptr)
+        return "";
+
+    return drive->get_le()->GetObjectID();
+}
+
+double Scheduler::getMountTime(std::string tapeId)
+
+{
+    return inventory->getCartridge(tapeId)->getMountTime();
+}
+
+unsigned long Scheduler::getRemainingCap(std::string tapeId)
+
+{
+    std::shared_ptr<LTFSDMCartridge> cart = inventory->getCartridge(tapeId);
+
+    if (cart == nullptr)
+        return 0;
+
+    return 1024 * 1024 * cart->get_le()->get_remaining_cap();
+}
+
+std::string Scheduler::getPool(std::string tapeId)
+
+{
+    std::shared_ptr<LTFSDMCartridge> cart = inventory->getCartridge(tapeId);
+
+    if (cart == nullptr)
+        return "";
+
+    return cart->getPool();
+}
+
+std::set<std::string> Scheduler::getPoolCartridges(std::string pool)
+
+{
+    std::set<std::string> cartnames = Server::conf.getPool(pool);
+    std::set<std::string>::iterator it;
+
+    for (it = cartnames.begin(); it != cartnames.end();) {
+        if (inventory->getCartridge(*it) == nullptr) {
+            MSG(LTFSDMX0034E, *it);
+            Server::conf.poolRemove(pool, *it);
+            it = cartnames.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    return cartnames;
+}
+
+bool Scheduler::isRequested(std::string tapeId)
+
+{
+    return inventory->getCartridge(tapeId)->isRequested();
+}
+
+void Scheduler::setRequested(std::string tapeId, bool requested)
+
+{
+    if (requested)
+        inventory->getCartridge(tapeId)->setRequested();
+    else
+        inventory->getCartridge(tapeId)->unsetRequested();
+}
+
+double Scheduler::getRecallScore(std::string tapeId)
+
+{
+    return inventory->getRecallScore(tapeId);
+}
+
+std::map<std::string, SchedulerPolicy::limitkey_t> Scheduler::getUsedDrives()
+
+{
+    std::lock_guard<std::mutex> lock(Scheduler::queuemtx);
+    std::map<std::string, SchedulerPolicy::limitkey_t> usedDrives;
+    SchedulerPolicy::limitkey_t key;
+
+    for (std::pair<const reqkey_t, request_t>& running : inProgress)
+        if (running.second.driveId.compare("") != 0
+                && SchedulerPolicy::limitKey(*this, running.second.op,
+                        running.second.pool, running.second.tapeId, &key)
+                        == true)
+            usedDrives[running.second.driveId] = key;
+
+    return usedDrives;
+}
+
+void Scheduler::moveTape(const SchedulerPolicy::request_t& req,
+        std::string driveId, std::string tapeId, SchedulerPolicy::operation top)
+
+{
     std::string opstr;
 
     // already a mount, move, or unmount request
-    if (op == DataBase::MOUNT || op == DataBase::MOVE
-            || op == DataBase::UNMOUNT)
+    if (req.op == DataBase::MOUNT || req.op == DataBase::MOVE
+            || req.op == DataBase::UNMOUNT)
         return;
 
-    if (inventory->requestExists(reqNum, pool) == true)
+    if (inventory->requestExists(req.reqNum, req.pool) == true)
         return;
 
     switch (top) {
-        case TapeMover::MOUNT:
+        case SchedulerPolicy::MOUNT:
             opstr = "mnt.";
-            MSG(LTFSDMS0111I, reqNum, tapeId);
+            MSG(LTFSDMS0111I, req.reqNum, tapeId);
             break;
-        case TapeMover::MOVE:
+        case SchedulerPolicy::MOVE:
             opstr = "mov.";
-            MSG(LTFSDMS0112I, reqNum, tapeId);
+            MSG(LTFSDMS0112I, req.reqNum, tapeId);
             break;
         default:
             opstr = "umn.";
-            MSG(LTFSDMS0113I, reqNum, tapeId);
+            MSG(LTFSDMS0113I, req.reqNum, tapeId);
             break;
     }
 
     TRACE(Trace::always, driveId, tapeId);
-    //Scheduler::makeUse(driveId, tapeId);
-    drive->setMoveReq(reqNum, pool);
-    //drive->setBusy();
+    inventory->getDrive(driveId)->setMoveReq(req.reqNum, req.pool);
 
     subs.enqueue(std::string(opstr) + tapeId, &TapeMover::addRequest,
-            TapeMover(driveId, tapeId, top));
+            TapeMover(driveId, tapeId, static_cast<TapeMover::operation>(top)));
 }
 
-bool Scheduler::poolResAvail(unsigned long minFileSize)
+void Scheduler::premountTape(std::string driveId, std::string tapeId,
+        SchedulerPolicy::operation top)
 
 {
-    bool found;
-    bool unmountedExists = false;
+    TRACE(Trace::always, driveId, tapeId, top);
 
-    assert(pool.compare("") != 0);
+    inventory->getDrive(driveId)->setMoveReq(SchedulerPolicy::PREMOUNT_REQNUM,
+            "");
 
-    for (std::string cartname : Server::conf.getPool(pool)) {
-        std::shared_ptr<LTFSDMCartridge> cart;
-        if ((cart = inventory->getCartridge(cartname)) == nullptr) {
-            MSG(LTFSDMX0034E, cartname);
-            Server::conf.poolRemove(pool, cartname);
-        }
-        if (cart->getState() == LTFSDMCartridge::TAPE_MOUNTED) {
-            tapeId = cart->get_le()->GetObjectID();
-            found = false;
-            for (std::shared_ptr<LTFSDMDrive> drive : inventory->getDrives()) {
-                if (drive->get_le()->get_slot() == cart->get_le()->get_slot()
-                        && 1024 * 1024 * cart->get_le()->get_remaining_cap()
-                                >= minFileSize) {
-                    assert(drive->isBusy() == false);
-                    TRACE(Trace::always, drive->get_le()->GetObjectID());
-                    driveId = drive->get_le()->GetObjectID();
-                    Scheduler::makeUse(driveId, tapeId);
-                    found = true;
-                    break;
-                }
-            }
-            assert(
-                    found == true || 1024*1024*cart->get_le()->get_remaining_cap() < minFileSize);
-            if (found == true)
-                return true;
-        } else if (cart->getState() == LTFSDMCartridge::TAPE_UNMOUNTED)
-            unmountedExists = true;
+    if (top == SchedulerPolicy::MOUNT) {
+        MSG(LTFSDMS0120I, tapeId);
+        subs.enqueue(std::string("pmnt.") + tapeId, &TapeMover::addRequest,
+                TapeMover(driveId, tapeId, TapeMover::MOUNT));
+    } else {
+        subs.enqueue(std::string("pumn.") + tapeId, &TapeMover::addRequest,
+                TapeMover(driveId, tapeId, TapeMover::UNMOUNT));
     }
+}
 
-    if (unmountedExists == false)
-        return false;
+unsigned long Scheduler::smallestMigJob(int reqNum, int replNum)
 
-    // check if there is an empty drive to mount a tape
-    for (std::shared_ptr<LTFSDMDrive> drive : inventory->getDrives()) {
-        if (driveIsUsable(drive) == false)
-            continue;
-        found = false;
-        // check if there is a cartridge mounted in that drive:
-        for (std::shared_ptr<LTFSDMCartridge> card : inventory->getCartridges()) {
-            if (drive->get_le()->get_slot() == card->get_le()->get_slot()
-                    && card->getState() == LTFSDMCartridge::TAPE_MOUNTED) {
-                found = true;
-                break;
-            }
-        }
-        if (found == false) {
-            std::shared_ptr<LTFSDMCartridge> cart;
-            for (std::string cartname : Server::conf.getPool(pool)) {
-                if ((cart = inventory->getCartridge(cartname)) == nullptr) {
-                    MSG(LTFSDMX0034E, cartname);
-                    Server::conf.poolRemove(pool, cartname);
-                }
-                if (cart->getState() == LTFSDMCartridge::TAPE_UNMOUNTED
-                        && 1024 * 1024 * cart->get_le()->get_remaining_cap()
-                                >= minFileSize) {
-                    Scheduler::moveTape(drive->get_le()->GetObjectID(),
-                            cartname, Scheduler::mountTarget);
-                    return false;
-                }
-            }
+{
+    return jobStore->unclaimed(reqNum, replNum, FsObj::RESIDENT).minSize;
+}
 
-        }
-    }
+void Scheduler::invoke()
 
-    /** @todo: check if the following needs to be moved before the
-     for loop that is checking for a tape to mount
-     */
-    for (std::shared_ptr<LTFSDMDrive> drive : inventory->getDrives())
-        if (drive->getMoveReqNum() == reqNum
-                && drive->getMoveReqPool().compare(pool) == 0)
-            return false;
-
-    // check if there is a tape to unmount
-    for (std::shared_ptr<LTFSDMDrive> drive : inventory->getDrives()) {
-        if (driveIsUsable(drive) == false)
-            continue;
-        for (std::shared_ptr<LTFSDMCartridge> cart : inventory->getCartridges()) {
-            if ((drive->get_le()->get_slot() == cart->get_le()->get_slot())
-                    && (cart->getState() == LTFSDMCartridge::TAPE_MOUNTED)) {
-                Scheduler::moveTape(drive->get_le()->GetObjectID(),
-                        cart->get_le()->GetObjectID(), TapeMover::UNMOUNT);
-                return false;
-            }
-        }
-    }
+{
+    assert(
+            LTFSDMInventory::mtx.native_handle()->__data.__owner != syscall(__NR_gettid));
 
-    return false;
+    TRACE(Trace::always, "invoke scheduler");
+
+    std::unique_lock<std::mutex> lock(Scheduler::mtx);
+    Scheduler::invoked = true;
+    Scheduler::cond.notify_one();
 }
 
-bool Scheduler::tapeResAvail()
+void Scheduler::queueRequest(request_t req)
 
 {
-    bool found;
+    std::lock_guard<std::mutex> lock(Scheduler::queuemtx);
+    reqkey_t key = std::make_tuple(req.reqNum, req.replNum, req.tapeId);
+    std::map<reqkey_t, request_t>::iterator it;
 
-    assert(tapeId.compare("") != 0);
+    TRACE(Trace::normal, req.op, req.reqNum, req.replNum, req.tapeId);
 
-    if (inventory->getCartridge(tapeId)->getState()
-            == LTFSDMCartridge::TAPE_MOVING
-            || inventory->getCartridge(tapeId)->getState()
-                    == LTFSDMCartridge::TAPE_INUSE) {
-        TRACE(Trace::always, op);
-        return false;
-    }
+    starting.erase(key);
 
-    if (inventory->getCartridge(tapeId)->getState()
-            == LTFSDMCartridge::TAPE_MOUNTED) {
-        found = false;
-        for (std::shared_ptr<LTFSDMDrive> drive : inventory->getDrives()) {
-            if (drive->get_le()->get_slot()
-                    == inventory->getCartridge(tapeId)->get_le()->get_slot()) {
-                assert(drive->isBusy() == false);
-                TRACE(Trace::always, drive->get_le()->GetObjectID());
-                driveId = drive->get_le()->GetObjectID();
-                Scheduler::makeUse(driveId, tapeId);
-                found = true;
-                break;
-            }
-        }
-        assert(found == true);
-        return true;
+    // already waiting: keep its position but update the smallest file size
+    if ((it = queued.find(key)) != queued.end()) {
+        readyQueue.erase(it->second);
+        it->second.minFileSize = req.minFileSize;
+        readyQueue.insert(it->second);
+        return;
     }
 
-    // looking for a free drive
-    for (std::shared_ptr<LTFSDMDrive> drive : inventory->getDrives()) {
-        if (driveIsUsable(drive) == false)
-            continue;
-        found = false;
-        for (std::shared_ptr<LTFSDMCartridge> card : inventory->getCartridges()) {
-            if ((drive->get_le()->get_slot() == card->get_le()->get_slot())
-                    && (card->getState() == LTFSDMCartridge::TAPE_MOUNTED)) {
-                found = true;
-                break;
-            }
-        }
-        if (found == false) {
-            if (inventory->getCartridge(tapeId)->getState()
-                    == LTFSDMCartridge::TAPE_UNMOUNTED) {
-                Scheduler::moveTape(drive->get_le()->GetObjectID(), tapeId,
-                        Scheduler::mountTarget);
-                return false;
-            }
-        }
-    }
+    queued[key] = req;
+    readyQueue.insert(req);
+    countPending(req, 1);
+}
 
-    // looking for a tape to unmount
-    for (std::shared_ptr<LTFSDMDrive> drive : inventory->getDrives()) {
-        if (driveIsUsable(drive) == false)
-            continue;
-        for (std::shared_ptr<LTFSDMCartridge> cart : inventory->getCartridges()) {
-            if ((drive->get_le()->get_slot() == cart->get_le()->get_slot())
-                    && (cart->getState() == LTFSDMCartridge::TAPE_MOUNTED)) {
-                Scheduler::moveTape(drive->get_le()->GetObjectID(),
-                        cart->get_le()->GetObjectID(), TapeMover::UNMOUNT);
-                inventory->getCartridge(tapeId)->unsetRequested();
-                return false;
-            }
+void Scheduler::requeueRequest(int reqNum, int replNum, std::string tapeId,
+        bool resetTape)
+
+{
+    std::map<reqkey_t, request_t>::iterator it;
+    request_t req;
+
+    {
+        std::lock_guard<std::mutex> lock(Scheduler::queuemtx);
+
+        if ((it = inProgress.find(std::make_tuple(reqNum, replNum, tapeId)))
+                == inProgress.end()) {
+            TRACE(Trace::error, reqNum, replNum, tapeId);
+            return;
         }
+        req = it->second;
+        inProgress.erase(it);
     }
 
-    if (inventory->getCartridge(tapeId)->isRequested())
-        return false;
+    req.driveId = "";
 
-    // suspend an operation
-    for (std::shared_ptr<LTFSDMDrive> drive : inventory->getDrives()) {
-        if (op < drive->getToUnblock()) {
-            TRACE(Trace::always, op, drive->getToUnblock(),
-                    drive->get_le()->GetObjectID());
-            drive->setToUnblock(op);
-            inventory->getCartridge(tapeId)->setRequested();
-            break;
-        }
+    // new recall events for this tape have to wait again
+    if (req.op == DataBase::TRARECALL) {
+        req.timeAdded = time(NULL);
+        req.aged = false;
+    }
+
+    if (resetTape) {
+        req.tapeId = "";
+        req.minFileSize = smallestMigJob(req.reqNum, req.replNum);
     }
 
-    return false;
+    Scheduler::queueRequest(req);
 }
 
-bool Scheduler::resAvailTapeMove()
+void Scheduler::completeRequest(int reqNum, int replNum, std::string tapeId)
 
 {
-    std::shared_ptr<LTFSDMDrive> drive = inventory->getDrive(driveId);
-    std::shared_ptr<LTFSDMCartridge> cart = inventory->getCartridge(tapeId);
+    std::lock_guard<std::mutex> lock(Scheduler::queuemtx);
+    reqkey_t key = std::make_tuple(reqNum, replNum, tapeId);
+    std::map<reqkey_t, request_t>::iterator it;
 
-    TRACE(Trace::always, drive->get_le()->get_slot(),
-            cart->get_le()->get_slot());
+    TRACE(Trace::normal, reqNum, replNum, tapeId);
 
-    if (drive->isBusy() == true)
-        return false;
+    inProgress.erase(key);
+    starting.erase(key);
 
-    if (op == DataBase::MOUNT || op == DataBase::MOVE) {
-        for (std::shared_ptr<LTFSDMCartridge> c : inventory->getCartridges()) {
-            if ((drive->get_le()->get_slot() == c->get_le()->get_slot())
-                    && (c->getState() == LTFSDMCartridge::TAPE_MOUNTED)) {
-                return false;
-            }
-        }
-    } else {
-        if (drive->get_le()->get_slot() != cart->get_le()->get_slot()
-                || (cart->getState() != LTFSDMCartridge::TAPE_MOUNTED))
-            return false;
+    if ((it = queued.find(key)) != queued.end()) {
+        countPending(it->second, -1);
+        readyQueue.erase(it->second);
+        queued.erase(it);
     }
+}
 
-    Scheduler::makeUse(driveId, tapeId);
+void Scheduler::sessionStarted(int reqNum, int replNum)
 
-    return true;
+{
+    unsigned long minFileSize = smallestMigJob(reqNum, replNum);
+    std::lock_guard<std::mutex> lock(Scheduler::queuemtx);
+    reqkey_t key = std::make_tuple(reqNum, replNum, std::string(""));
+    std::map<reqkey_t, request_t>::iterator it;
+
+    TRACE(Trace::normal, reqNum, replNum, minFileSize);
+
+    starting.erase(key);
+
+    // the files assigned by the session are not considered anymore
+    if ((it = queued.find(key)) != queued.end()) {
+        readyQueue.erase(it->second);
+        it->second.minFileSize = minFileSize;
+        readyQueue.insert(it->second);
+    }
 }
 
-bool Scheduler::resAvail(unsigned long minFileSize)
+std::list<Scheduler::request_t> Scheduler::claimRecalls(std::string tapeId,
+        std::string driveId)
 
 {
-    if (op == DataBase::MOUNT || op == DataBase::MOVE
-            || op == DataBase::UNMOUNT)
-        return resAvailTapeMove();
-    else if (op == DataBase::MIGRATION && tapeId.compare("") == 0)
-        return poolResAvail(minFileSize);
-    else
-        return tapeResAvail();
+    std::lock_guard<std::mutex> lock(Scheduler::queuemtx);
+    std::set<request_t, queue_order>::iterator it = readyQueue.begin();
+    std::list<request_t> claimed;
+    reqkey_t key;
+
+    while (it != readyQueue.end()) {
+        if ((it->op != DataBase::SELRECALL && it->op != DataBase::TRARECALL)
+                || it->tapeId.compare(tapeId) != 0) {
+            ++it;
+            continue;
+        }
+        request_t req = *it;
+        TRACE(Trace::normal, req.op, req.reqNum, tapeId);
+        key = std::make_tuple(req.reqNum, req.replNum, req.tapeId);
+        countPending(req, -1);
+        queued.erase(key);
+        it = readyQueue.erase(it);
+        req.driveId = driveId;
+        inProgress[key] = req;
+        claimed.push_back(req);
+    }
+
+    return claimed;
 }
 
-unsigned long Scheduler::smallestMigJob(int reqNum, int replNum)
+void Scheduler::setAged(const SchedulerPolicy::request_t& preq)
 
 {
-    unsigned long min;
+    std::lock_guard<std::mutex> lock(Scheduler::queuemtx);
+    std::map<reqkey_t, request_t>::iterator it;
+
+    if ((it = queued.find(
+            std::make_tuple(preq.reqNum, preq.replNum, preq.tapeId)))
+            == queued.end())
+        return;
 
-    SQLStatement stmt = SQLStatement(Scheduler::SMALLEST_MIG_JOB) << reqNum
-            << FsObj::RESIDENT << replNum;
-    stmt.prepare();
-    stmt.step(&min);
-    stmt.finalize();
+    TRACE(Trace::always, preq.reqNum, preq.tapeId,
+            time(NULL) - it->second.timeAdded);
 
-    return min;
+    readyQueue.erase(it->second);
+    countPending(it->second, -1);
+    it->second.aged = true;
+    readyQueue.insert(it->second);
+    countPending(it->second, 1);
 }
 
-void Scheduler::invoke()
+bool Scheduler::nextRequest(SchedulerPolicy::request_t *req, bool first)
 
 {
-    assert(
-            LTFSDMInventory::mtx.native_handle()->__data.__owner != syscall(__NR_gettid));
+    std::lock_guard<std::mutex> lock(Scheduler::queuemtx);
+    std::set<request_t, queue_order>::iterator it;
+    request_t last;
+
+    /*
+     * The ready queue may change while the scheduler is processing a
+     * request. Therefore the position is determined by the last request
+     * that has been processed rather than by an iterator.
+     */
+    if (first) {
+        it = readyQueue.begin();
+    } else {
+        last.op = static_cast<DataBase::operation>(req->op);
+        last.reqNum = req->reqNum;
+        last.replNum = req->replNum;
+        last.tapeId = req->tapeId;
+        last.timeAdded = req->timeAdded;
+        last.recClass = req->recClass;
+        last.aged = req->aged;
+        it = readyQueue.upper_bound(last);
+    }
 
-    TRACE(Trace::always, "invoke scheduler");
+    while (it != readyQueue.end()
+            && starting.count(std::make_tuple(it->reqNum, it->replNum,
+                    it->tapeId)) > 0)
+        ++it;
 
-    std::unique_lock<std::mutex> lock(Scheduler::mtx);
-    Scheduler::cond.notify_one();
+    if (it == readyQueue.end())
+        return false;
+
+    *req = policyRequest(*it);
+
+    return true;
 }
 
-void Scheduler::run(long key)
+void Scheduler::dispatch(const SchedulerPolicy::request_t& preq,
+        std::string driveId, std::string tapeId)
 
 {
-    TRACE(Trace::normal, __PRETTY_FUNCTION__);
-
-    SQLStatement selstmt;
+    reqkey_t key = std::make_tuple(preq.reqNum, preq.replNum, preq.tapeId);
+    std::map<reqkey_t, request_t>::iterator it;
+    std::stringstream thrdinfo;
     SQLStatement updstmt;
-    std::stringstream ssql;
-    std::unique_lock<std::mutex> lock(mtx);
-    unsigned long minFileSize;
+    request_t req;
 
-    while (true) {
-        cond.wait(lock);
-        if (Server::terminate == true) {
-            TRACE(Trace::always, (bool) Server::terminate);
-            lock.unlock();
-            break;
+    {
+        std::lock_guard<std::mutex> lock(Scheduler::queuemtx);
+
+        if ((it = queued.find(key)) == queued.end()) {
+            TRACE(Trace::error, preq.reqNum, preq.replNum, preq.tapeId);
+            return;
+        }
+        req = it->second;
+
+        /*
+         * A migration request for a pool stays within the ready queue. It
+         * can be scheduled a further time on another cartridge of that pool
+         * as long as there are files left that are not processed by any
+         * session. This is not done before the new session has assigned its
+         * share of files.
+         */
+        if (req.op == DataBase::MIGRATION && req.tapeId.compare("") == 0) {
+            starting.insert(key);
+        } else {
+            countPending(it->second, -1);
+            readyQueue.erase(it->second);
+            queued.erase(it);
         }
 
-        selstmt(Scheduler::SELECT_REQUEST) << DataBase::REQ_NEW;
+        req.tapeId = tapeId;
+        req.driveId = driveId;
+        inProgress[std::make_tuple(req.reqNum, req.replNum, req.tapeId)] = req;
+    }
 
-        selstmt.prepare();
-        while (selstmt.step(&op, &reqNum, &tgtState, &numRepl, &replNum, &pool,
-                &tapeId, &driveId)) {
-            std::lock_guard<std::recursive_mutex> lock(LTFSDMInventory::mtx);
+    TRACE(Trace::always, req.op, req.reqNum, req.replNum, tapeId, driveId,
+            SchedulerPolicy::serviceClass(req.recClass, req.aged));
+
+    inventory->getDrive(driveId)->setBusy();
+    inventory->getCartridge(tapeId)->setState(LTFSDMCartridge::TAPE_INUSE);
+
+    switch (req.op) {
+        case DataBase::MOUNT:
+        case DataBase::MOVE:
+        case DataBase::UNMOUNT:
+            updstmt(Scheduler::UPDATE_REQUEST) << DataBase::REQ_INPROGRESS
+                    << req.reqNum;
+            updstmt.doall();
 
-            TRACE(Trace::always, op, reqNum, replNum, tapeId, driveId);
+            switch (req.op) {
+                case DataBase::MOUNT:
+                    thrdinfo << "MNT(" << tapeId << ")";
+                    break;
+                case DataBase::MOVE:
+                    thrdinfo << "MOV(" << tapeId << ")";
+                    break;
+                default:
+                    thrdinfo << "UMN(" << tapeId << ")";
+            }
 
-            if (op == DataBase::MIGRATION)
-                minFileSize = smallestMigJob(reqNum, replNum);
+            subs.enqueue(thrdinfo.str(), &TapeMover::execRequest,
+                    TapeMover(driveId, tapeId, req.reqNum,
+                            static_cast<TapeMover::operation>(req.op)));
+            break;
+        case DataBase::FORMAT:
+        case DataBase::CHECK:
+            updstmt(Scheduler::UPDATE_REQUEST) << DataBase::REQ_INPROGRESS
+                    << req.reqNum;
+            updstmt.doall();
+
+            if (req.op == DataBase::FORMAT)
+                thrdinfo << "FMT(" << tapeId << ")";
             else
-                minFileSize = 0;
+                thrdinfo << "CHK(" << tapeId << ")";
 
-            if (op == DataBase::FORMAT || op == DataBase::CHECK)
-                mountTarget = TapeMover::MOVE;
+            subs.enqueue(thrdinfo.str(), &TapeHandler::execRequest,
+                    TapeHandler(req.pool, driveId, tapeId, req.reqNum,
+                            req.op == DataBase::FORMAT ?
+                                    TapeHandler::FORMAT : TapeHandler::CHECK));
+            break;
+        case DataBase::MIGRATION:
+            updstmt(Scheduler::ADD_MIG_SESSION) << DataBase::MIGRATION
+                    << req.reqNum << req.tgtState << req.numRepl << req.replNum
+                    << req.pool << tapeId << driveId << time(NULL)
+                    << DataBase::REQ_INPROGRESS;
+            updstmt.doall();
+
+            thrdinfo << "M(" << req.reqNum << "," << req.replNum << ","
+                    << req.pool << ")";
+
+            subs.enqueue(thrdinfo.str(), &Migration::execRequest,
+                    Migration(getpid(), req.reqNum, { }, req.numRepl,
+                            req.tgtState), req.replNum, driveId, req.pool,
+                    tapeId, true /* needsTape */);
+            break;
+        case DataBase::SELRECALL:
+        case DataBase::TRARECALL:
+            updstmt(Scheduler::UPDATE_REC_REQUEST) << DataBase::REQ_INPROGRESS
+                    << req.reqNum << tapeId;
+            updstmt.doall();
+
+            if (req.op == DataBase::SELRECALL)
+                thrdinfo << "SR(" << req.reqNum << ")";
             else
-                mountTarget = TapeMover::MOUNT;
+                thrdinfo << "TR(" << req.reqNum << ")";
+            subs.enqueue(thrdinfo.str(), &RecallSession::execRequest,
+                    RecallSession(driveId, tapeId), req.op, req.reqNum);
+            break;
+        default:
+            TRACE(Trace::error, req.op);
+    }
+}
 
-            if (resAvail(minFileSize) == false)
-                continue;
+void Scheduler::countPending(const request_t& req, int diff)
 
-            TRACE(Trace::always, reqNum, tgtState, numRepl, replNum, pool, op);
+{
+    std::map<std::string, std::map<SchedulerPolicy::priority_t, int>> *pending;
+    SchedulerPolicy::priority_t prio;
+    std::string name;
 
-            std::stringstream thrdinfo;
+    if (req.op == DataBase::MOUNT || req.op == DataBase::MOVE
+            || req.op == DataBase::UNMOUNT)
+        return;
 
-            switch (op) {
-                case DataBase::MOUNT:
-                case DataBase::MOVE:
-                case DataBase::UNMOUNT:
-                    updstmt(Scheduler::UPDATE_REQUEST)
-                            << DataBase::REQ_INPROGRESS << reqNum;
-                    updstmt.doall();
-
-                    switch (op) {
-                        case DataBase::MOUNT:
-                            thrdinfo << "MNT(" << tapeId << ")";
-                            break;
-                        case DataBase::MOVE:
-                            thrdinfo << "MOV(" << tapeId << ")";
-                            break;
-                        default:
-                            thrdinfo << "UMN(" << tapeId << ")";
-                    }
-
-                    subs.enqueue(thrdinfo.str(), &TapeMover::execRequest,
-                            TapeMover(driveId, tapeId, reqNum,
-                                    static_cast<TapeMover::operation>(op)));
-                    break;
-                case DataBase::FORMAT:
-                case DataBase::CHECK:
-                    updstmt(Scheduler::UPDATE_REQUEST)
-                            << DataBase::REQ_INPROGRESS << reqNum;
-                    updstmt.doall();
-
-                    if (op == DataBase::FORMAT)
-                        thrdinfo << "FMT(" << tapeId << ")";
-                    else
-                        thrdinfo << "CHK(" << tapeId << ")";
-
-                    subs.enqueue(thrdinfo.str(), &TapeHandler::execRequest,
-                            TapeHandler(pool, driveId, tapeId, reqNum,
-                                    op == DataBase::FORMAT ?
-                                            TapeHandler::FORMAT :
-                                            TapeHandler::CHECK));
-                    break;
+    if (req.tapeId.compare("") != 0) {
+        pending = &pendingTape;
+        name = req.tapeId;
+    } else {
+        pending = &pendingPool;
+        name = req.pool;
+    }
 
-                case DataBase::MIGRATION:
-                    updstmt(Scheduler::UPDATE_MIG_REQUEST)
-                            << DataBase::REQ_INPROGRESS << tapeId << reqNum
-                            << replNum << pool;
-                    updstmt.doall();
+    prio = SchedulerPolicy::priority(req.op, req.recClass, req.aged);
 
-                    thrdinfo << "M(" << reqNum << "," << replNum << "," << pool
-                            << ")";
+    if (((*pending)[name][prio] += diff) <= 0) {
+        (*pending)[name].erase(prio);
+        if ((*pending)[name].empty())
+            pending->erase(name);
+    }
+}
 
-                    subs.enqueue(thrdinfo.str(), &Migration::execRequest,
-                            Migration(getpid(), reqNum, { }, numRepl, tgtState),
-                            replNum, driveId, pool, tapeId,
-                            true /* needsTape */);
-                    break;
-                case DataBase::SELRECALL:
-                    updstmt(Scheduler::UPDATE_REC_REQUEST)
-                            << DataBase::REQ_INPROGRESS << reqNum << tapeId;
-                    updstmt.doall();
-
-                    thrdinfo << "SR(" << reqNum << ")";
-                    subs.enqueue(thrdinfo.str(), &SelRecall::execRequest,
-                            SelRecall(getpid(), reqNum, tgtState), driveId,
-                            tapeId,
-                            true /* needsTape */);
-                    break;
-                case DataBase::TRARECALL:
-                    updstmt(Scheduler::UPDATE_REC_REQUEST)
-                            << DataBase::REQ_INPROGRESS << reqNum << tapeId;
-                    updstmt.doall();
-
-                    thrdinfo << "TR(" << reqNum << ")";
-                    subs.enqueue(thrdinfo.str(), &TransRecall::execRequest,
-                            TransRecall(), reqNum, driveId, tapeId);
-                    break;
-                default:
-                    TRACE(Trace::error, op);
-            }
+int Scheduler::pendingWork(std::string tapeId,
+        SchedulerPolicy::priority_t minPriority)
+
+{
+    std::lock_guard<std::mutex> lock(Scheduler::queuemtx);
+    std::map<std::string, std::map<SchedulerPolicy::priority_t, int>>::iterator it;
+    std::string pool = getPool(tapeId);
+    int pending = 0;
+
+    if ((it = pendingTape.find(tapeId)) != pendingTape.end())
+        for (std::pair<SchedulerPolicy::priority_t, int> count : it->second)
+            if (count.first <= minPriority)
+                pending += count.second;
+
+    if (pool.compare("") != 0
+            && (it = pendingPool.find(pool)) != pendingPool.end())
+        for (std::pair<SchedulerPolicy::priority_t, int> count : it->second)
+            if (count.first <= minPriority)
+                pending += count.second;
+
+    return pending;
+}
+
+void Scheduler::run(long key)
+
+{
+    TRACE(Trace::normal, __PRETTY_FUNCTION__);
+
+    std::unique_lock<std::mutex> lock(mtx);
+
+    while (true) {
+        /*
+         * A notification is remembered by Scheduler::invoked. Requests that
+         * are added before this thread waits for the first time (e.g. the
+         * ones resumed at startup) are not missed.
+         */
+        if (recallLatency > 0)
+            cond.wait_for(lock, std::chrono::seconds(recallLatency),
+                    [] () {return invoked;});
+        else
+            cond.wait(lock, [] () {return invoked;});
+        invoked = false;
+        if (Server::terminate == true) {
+            TRACE(Trace::always, (bool) Server::terminate);
+            lock.unlock();
+            break;
+        }
+
+        {
+            std::lock_guard<std::recursive_mutex> lock(LTFSDMInventory::mtx);
+            SchedulerPolicy::schedule(*this, policyConfig(), time(NULL));
         }
-        selstmt.finalize();
     }
     MSG(LTFSDMS0081I);
     subs.waitAllRemaining();
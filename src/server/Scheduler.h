@@ -16,50 +16,101 @@
  *******************************************************************************/
 #pragma once
 
-class Scheduler
+class Scheduler: public SchedulerPolicy::Resources
 
 {
+    friend class DataBase;
+public:
+    struct request_t
+    {
+        DataBase::operation op;
+        int reqNum;
+        int tgtState;
+        int numRepl;
+        int replNum;
+        std::string pool;
+        std::string tapeId;
+        std::string driveId;
+        time_t timeAdded;
+        unsigned long minFileSize;
+        int recClass;
+        bool aged;
+    };
 private:
-    DataBase::operation op;
-    int reqNum;
-    int numRepl;
-    int replNum;
-    int tgtState;
-    TapeMover::operation mountTarget;
-    std::string tapeId;
-    std::string driveId;
-    std::string pool;
+    struct queue_order
+    {
+        bool operator()(const request_t& a, const request_t& b) const;
+    };
+    typedef std::tuple<int, int, std::string> reqkey_t;
+
     SubServer subs;
     static std::mutex mtx;
     static std::condition_variable cond;
+    static bool invoked;
+    static std::mutex queuemtx;
+    static std::set<request_t, queue_order> readyQueue;
+    static std::map<reqkey_t, request_t> queued;
+    static std::map<reqkey_t, request_t> inProgress;
+    static std::set<reqkey_t> starting;
+    static std::map<std::string, std::map<SchedulerPolicy::priority_t, int>> pendingTape;
+    static std::map<std::string, std::map<SchedulerPolicy::priority_t, int>> pendingPool;
+
+    static SchedulerPolicy::request_t policyRequest(const request_t& req);
+    static void countPending(const request_t& req, int diff);
+    SchedulerPolicy::config_t policyConfig();
 
-    void makeUse(std::string driveId, std::string tapeId);
-    bool driveIsUsable(std::shared_ptr<LTFSDMDrive> drive);
-    void moveTape(std::string driveId, std::string tapeId,
-            TapeMover::operation op);
-    bool poolResAvail(unsigned long minFileSize);
-    bool tapeResAvail();
-    bool resAvail(unsigned long minFileSize);
-    bool resAvailTapeMove();
-    unsigned long smallestMigJob(int reqNum, int replNum);
+    bool nextRequest(SchedulerPolicy::request_t *req, bool first);
+    void setAged(const SchedulerPolicy::request_t& req);
+    int pendingWork(std::string tapeId,
+            SchedulerPolicy::priority_t minPriority);
+    std::map<std::string, SchedulerPolicy::limitkey_t> getUsedDrives();
+    std::list<std::string> getDriveIds();
+    bool driveIsBusy(std::string driveId);
+    int getMoveReqNum(std::string driveId);
+    std::string getMoveReqPool(std::string driveId);
+    std::string getMountedCartridge(std::string driveId);
+    int getToUnblock(std::string driveId);
+    void setToUnblock(std::string driveId, int op);
+    std::list<std::string> getCartridgeIds();
+    SchedulerPolicy::cart_state getCartridgeState(std::string tapeId);
+    std::string getMountingDrive(std::string tapeId);
+    double getMountTime(std::string tapeId);
+    unsigned long getRemainingCap(std::string tapeId);
+    std::string getPool(std::string tapeId);
+    std::set<std::string> getPoolCartridges(std::string pool);
+    bool isRequested(std::string tapeId);
+    void setRequested(std::string tapeId, bool requested);
+    double getRecallScore(std::string tapeId);
+    void moveTape(const SchedulerPolicy::request_t& req, std::string driveId,
+            std::string tapeId, SchedulerPolicy::operation op);
+    void premountTape(std::string driveId, std::string tapeId,
+            SchedulerPolicy::operation op);
+    void dispatch(const SchedulerPolicy::request_t& req, std::string driveId,
+            std::string tapeId);
 
-    static const std::string SELECT_REQUEST;
     static const std::string UPDATE_REQUEST;
-    static const std::string UPDATE_MIG_REQUEST;
+    static const std::string ADD_MIG_SESSION;
     static const std::string UPDATE_REC_REQUEST;
-    static const std::string SMALLEST_MIG_JOB;
 public:
     static std::mutex updmtx;
     static std::condition_variable updcond;
     static std::map<int, std::atomic<bool>> updReq;
     static std::map<std::string, std::atomic<bool>> suspend_map;
+    static std::atomic<int> minDwellTime;
+    static std::atomic<int> recallLatency;
+    static std::atomic<bool> premountHot;
 
     static void invoke();
+    static unsigned long smallestMigJob(int reqNum, int replNum);
+    static void queueRequest(request_t req);
+    static void requeueRequest(int reqNum, int replNum, std::string tapeId,
+            bool resetTape);
+    static void completeRequest(int reqNum, int replNum, std::string tapeId);
+    static void sessionStarted(int reqNum, int replNum);
+    static std::list<request_t> claimRecalls(std::string tapeId,
+            std::string driveId);
 
-    Scheduler() :
-            op(DataBase::NOOP), reqNum(Const::UNSET), numRepl(Const::UNSET), replNum(
-                    Const::UNSET), tgtState(Const::UNSET), mountTarget(
-                    TapeMover::MOUNT)
+    Scheduler()
     {
     }
     ~Scheduler()
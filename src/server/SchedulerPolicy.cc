@@ -0,0 +1,572 @@
+/*******************************************************************************
+ * Copyright 2018 IBM Corp. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *******************************************************************************/
+#include <sys/resource.h>
+#include <limits.h>
+
+#include <string>
+#include <list>
+#include <map>
+#include <set>
+#include <tuple>
+#include <chrono>
+
+#include "src/common/Const.h"
+
+#include "SchedulerPolicy.h"
+
+/*
+ * The scheduling policy is used by the Scheduler of the backend and by the
+ * simulator ltfsdmsim. It does not depend on the inventory or on the data
+ * base: the ready queue, the drives, and the cartridges are accessed by
+ * SchedulerPolicy::Resources. A scheduling pass (SchedulerPolicy::schedule)
+ * is performed the same way by both of them.
+ */
+
+int SchedulerPolicy::serviceClass(int recClass, bool aged)
+
+{
+    return (aged ? INTERACTIVE : recClass);
+}
+
+SchedulerPolicy::priority_t SchedulerPolicy::priority(int op, int recClass,
+        bool aged)
+
+{
+    return std::make_pair(op, serviceClass(recClass, aged));
+}
+
+SchedulerPolicy::queuekey_t SchedulerPolicy::queueKey(int op, int recClass,
+        bool aged, double timeAdded, int reqNum, int replNum,
+        std::string tapeId)
+
+{
+    return std::make_tuple(op, serviceClass(recClass, aged), timeAdded, reqNum,
+            replNum, tapeId);
+}
+
+bool SchedulerPolicy::needsAging(int op, int recClass, bool aged,
+        double waiting, int recallLatency)
+
+{
+    return (recallLatency > 0 && op == TRARECALL && recClass != INTERACTIVE
+            && aged == false && waiting >= recallLatency);
+}
+
+bool SchedulerPolicy::driveIsFree(Resources& res, std::string driveId)
+
+{
+    return (res.driveIsBusy(driveId) == false
+            && res.getMoveReqNum(driveId) == Const::UNSET);
+}
+
+bool SchedulerPolicy::driveIsUsable(Resources& res, std::string driveId,
+        const request_t& req)
+
+{
+    int rn = res.getMoveReqNum(driveId);
+
+    if (res.driveIsBusy(driveId) == true)
+        return false;
+
+    // reserved for a tape move of another request
+    if (rn != Const::UNSET
+            && !(rn == req.reqNum
+                    && res.getMoveReqPool(driveId).compare(req.pool) == 0))
+        return false;
+
+    return true;
+}
+
+bool SchedulerPolicy::mountedResource(Resources& res, const request_t& req)
+
+{
+    if (req.op == MOUNT || req.op == MOVE || req.op == UNMOUNT)
+        return false;
+
+    if (req.tapeId.compare("") != 0)
+        return (res.getCartridgeState(req.tapeId) == CART_MOUNTED);
+
+    for (std::string cartname : res.getPoolCartridges(req.pool))
+        if (res.getCartridgeState(cartname) == CART_MOUNTED
+                && res.getRemainingCap(cartname) >= req.minFileSize)
+            return true;
+
+    return false;
+}
+
+bool SchedulerPolicy::needsDrive(Resources& res, const request_t& req)
+
+{
+    // tape moves are performed on the drive that has been specified
+    if (req.op == MOUNT || req.op == MOVE || req.op == UNMOUNT)
+        return false;
+
+    // a cartridge in use or moving does not need a further drive
+    if (req.tapeId.compare("") != 0)
+        return (res.getCartridgeState(req.tapeId) == CART_UNMOUNTED);
+
+    return (mountedResource(res, req) == false);
+}
+
+bool SchedulerPolicy::limitKey(Resources& res, int op, std::string pool,
+        std::string tapeId, limitkey_t *key)
+
+{
+    switch (op) {
+        case MIGRATION:
+            *key = std::make_pair(pool, MIGRATION_DRIVES);
+            return true;
+        case SELRECALL:
+        case TRARECALL:
+            if (tapeId.compare("") == 0)
+                return false;
+            *key = std::make_pair(res.getPool(tapeId),
+                    RECALL_DRIVES);
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool SchedulerPolicy::driveLimitReached(Resources& res,
+        const std::map<limitkey_t, drive_limits>& limits, int op,
+        std::string pool, std::string tapeId)
+
+{
+    std::map<limitkey_t, drive_limits>::const_iterator it;
+    std::map<std::string, limitkey_t> usedDrives = res.getUsedDrives();
+    std::map<limitkey_t, int> inUse;
+    limitkey_t key;
+    int freeDrives = 0;
+    int reserved = 0;
+
+    if (limits.empty() || limitKey(res, op, pool, tapeId, &key) == false)
+        return false;
+
+    for (std::pair<const std::string, limitkey_t>& used : usedDrives)
+        inUse[used.second]++;
+
+    if ((it = limits.find(key)) != limits.end() && it->second.maxDrives > 0
+            && inUse[key] >= it->second.maxDrives)
+        return true;
+
+    /*
+     * Drives reserved for other pools or operations that are not in use
+     * by these need to stay available.
+     */
+    for (const std::pair<const limitkey_t, drive_limits>& limit : limits)
+        if (limit.first != key && limit.second.minDrives > inUse[limit.first])
+            reserved += limit.second.minDrives - inUse[limit.first];
+
+    if (reserved == 0)
+        return false;
+
+    for (std::string driveId : res.getDriveIds())
+        if (driveIsFree(res, driveId))
+            freeDrives++;
+
+    return (freeDrives <= reserved);
+}
+
+std::string SchedulerPolicy::selectUnmount(Resources& res,
+        const config_t& conf, double now, const request_t& req)
+
+{
+    std::string selected = "";
+    std::string tapeId;
+    long cost;
+    long minCost = LONG_MAX;
+    double score = 0;
+    double minScore = 0;
+    int pending;
+
+    for (std::string driveId : res.getDriveIds()) {
+        if (driveIsUsable(res, driveId, req) == false
+                || (tapeId = res.getMountedCartridge(driveId)).compare("") == 0)
+            continue;
+
+        if (conf.minDwellTime == 0 && conf.premountHot == false)
+            return driveId;
+
+        /*
+         * A cartridge that still has pending work is kept mounted at least
+         * for the minimum dwell time unless that work is less important
+         * than the request that is waiting for a drive. Otherwise the
+         * cartridge with the lowest estimated cost (unmount now plus the
+         * mounts needed later to process its pending work) is selected.
+         * If cartridges are pre-mounted the one with the lowest recall score
+         * is selected among those with the same cost.
+         */
+        if (now - res.getMountTime(tapeId) < conf.minDwellTime
+                && res.pendingWork(tapeId,
+                        priority(req.op, req.recClass, req.aged)) > 0)
+            continue;
+
+        pending = res.pendingWork(tapeId, std::make_pair(NOOP, BULK));
+
+        cost = Const::UNMOUNT_TIME_ESTIMATE
+                + pending * Const::MOUNT_TIME_ESTIMATE;
+
+        if (conf.premountHot)
+            score = res.getRecallScore(tapeId);
+
+        if (cost < minCost || (cost == minCost && score < minScore)) {
+            minCost = cost;
+            minScore = score;
+            selected = driveId;
+        }
+    }
+
+    return selected;
+}
+
+bool SchedulerPolicy::poolResAvail(Resources& res, const config_t& conf,
+        double now, const request_t& req, std::string *driveId,
+        std::string *tapeId)
+
+{
+    std::string toMount = "";
+    std::string victim;
+    bool unmountedExists = false;
+
+    for (std::string cartname : res.getPoolCartridges(req.pool)) {
+        switch (res.getCartridgeState(cartname)) {
+            case CART_MOUNTED:
+                if (res.getRemainingCap(cartname) >= req.minFileSize
+                        && driveIsUsable(res, res.getMountingDrive(cartname),
+                                req) == true) {
+                    *driveId = res.getMountingDrive(cartname);
+                    *tapeId = cartname;
+                    return true;
+                }
+                break;
+            case CART_UNMOUNTED:
+                unmountedExists = true;
+                if (toMount.compare("") == 0
+                        && res.getRemainingCap(cartname) >= req.minFileSize)
+                    toMount = cartname;
+                break;
+            default:
+                break;
+        }
+    }
+
+    // no need to unmount a cartridge of another pool
+    if (unmountedExists == false)
+        return false;
+
+    // check if there is an empty drive to mount a tape
+    if (toMount.compare("") != 0) {
+        for (std::string drive : res.getDriveIds()) {
+            if (driveIsUsable(res, drive, req) == true
+                    && res.getMountedCartridge(drive).compare("") == 0) {
+                res.moveTape(req, drive, toMount, MOUNT);
+                return false;
+            }
+        }
+    }
+
+    // a tape move already is in progress for this request
+    for (std::string drive : res.getDriveIds())
+        if (res.getMoveReqNum(drive) == req.reqNum
+                && res.getMoveReqPool(drive).compare(req.pool) == 0)
+            return false;
+
+    // check if there is a tape to unmount
+    if ((victim = selectUnmount(res, conf, now, req)).compare("") != 0)
+        res.moveTape(req, victim, res.getMountedCartridge(victim), UNMOUNT);
+
+    return false;
+}
+
+bool SchedulerPolicy::tapeResAvail(Resources& res, const config_t& conf,
+        double now, const request_t& req, std::string *driveId)
+
+{
+    cart_state state = res.getCartridgeState(req.tapeId);
+    std::string victim;
+    std::string inUse;
+
+    if (state == CART_MOVING)
+        return false;
+
+    // the operation using the cartridge is suspended if less important
+    if (state == CART_INUSE) {
+        if (serviceClass(req.recClass, req.aged) == INTERACTIVE
+                && (inUse = res.getMountingDrive(req.tapeId)).compare("")
+                        != 0 && req.op < res.getToUnblock(inUse))
+            res.setToUnblock(inUse, req.op);
+        return false;
+    }
+
+    /*
+     * The drive might already be reserved to unmount the cartridge for
+     * another request. Once the cartridge gets a drive a later request
+     * for it is allowed to suspend an operation again.
+     */
+    if (state == CART_MOUNTED) {
+        *driveId = res.getMountingDrive(req.tapeId);
+        if (driveIsUsable(res, *driveId, req) == false)
+            return false;
+        res.setRequested(req.tapeId, false);
+        return true;
+    }
+
+    // looking for a free drive
+    if (state == CART_UNMOUNTED) {
+        for (std::string drive : res.getDriveIds()) {
+            if (driveIsUsable(res, drive, req) == true
+                    && res.getMountedCartridge(drive).compare("") == 0) {
+                res.moveTape(req, drive, req.tapeId,
+                        (req.op == FORMAT || req.op == CHECK) ? MOVE : MOUNT);
+                res.setRequested(req.tapeId, false);
+                return false;
+            }
+        }
+    }
+
+    // a tape move already is in progress for this request
+    for (std::string drive : res.getDriveIds())
+        if (res.getMoveReqNum(drive) == req.reqNum
+                && res.getMoveReqPool(drive).compare(req.pool) == 0)
+            return false;
+
+    // looking for a tape to unmount
+    if ((victim = selectUnmount(res, conf, now, req)).compare("") != 0) {
+        res.moveTape(req, victim, res.getMountedCartridge(victim), UNMOUNT);
+        res.setRequested(req.tapeId, false);
+        return false;
+    }
+
+    // an operation already has been suspended for this cartridge
+    if (res.isRequested(req.tapeId))
+        return false;
+
+    // bulk recalls only suspend other operations after aging
+    if (serviceClass(req.recClass, req.aged) != INTERACTIVE)
+        return false;
+
+    // suspend an operation
+    for (std::string drive : res.getDriveIds()) {
+        if (req.op < res.getToUnblock(drive)) {
+            res.setToUnblock(drive, req.op);
+            res.setRequested(req.tapeId, true);
+            break;
+        }
+    }
+
+    return false;
+}
+
+bool SchedulerPolicy::tapeMoveResAvail(Resources& res, const request_t& req)
+
+{
+    if (res.driveIsBusy(req.driveId) == true)
+        return false;
+
+    if (req.op == MOUNT || req.op == MOVE)
+        return (res.getMountedCartridge(req.driveId).compare("") == 0);
+
+    return (res.getMountingDrive(req.tapeId).compare(req.driveId) == 0
+            && res.getCartridgeState(req.tapeId) == CART_MOUNTED);
+}
+
+bool SchedulerPolicy::resAvail(Resources& res, const config_t& conf,
+        double now, const request_t& req, std::string *driveId,
+        std::string *tapeId)
+
+{
+    *driveId = req.driveId;
+    *tapeId = req.tapeId;
+
+    switch (req.op) {
+        case MOUNT:
+        case MOVE:
+        case UNMOUNT:
+            return tapeMoveResAvail(res, req);
+        case MIGRATION:
+            if (req.tapeId.compare("") == 0)
+                return poolResAvail(res, conf, now, req, driveId, tapeId);
+            return tapeResAvail(res, conf, now, req, driveId);
+        default:
+            return tapeResAvail(res, conf, now, req, driveId);
+    }
+}
+
+void SchedulerPolicy::ageRequests(Resources& res, const config_t& conf,
+        double now)
+
+{
+    request_t req;
+    bool first = true;
+
+    if (conf.recallLatency == 0)
+        return;
+
+    /*
+     * An aged request moves to an earlier position of the ready queue.
+     * Therefore it is not visited a second time.
+     */
+    while (res.nextRequest(&req, first)) {
+        first = false;
+        if (needsAging(req.op, req.recClass, req.aged, now - req.timeAdded,
+                conf.recallLatency))
+            res.setAged(req);
+    }
+}
+
+void SchedulerPolicy::premount(Resources& res, const config_t& conf,
+        double now)
+
+{
+    request_t req;
+    std::string empty = "";
+    std::string idle = "";
+    std::string hottest = "";
+    std::string coldest = "";
+    std::string mounted;
+    double maxScore = Const::PREMOUNT_MIN_SCORE;
+    double minScore = 0;
+    double score;
+
+    if (conf.premountHot == false || res.nextRequest(&req, true) == true)
+        return;
+
+    for (std::string cartname : res.getCartridgeIds()) {
+        if (res.getCartridgeState(cartname) != CART_UNMOUNTED)
+            continue;
+        if ((score = res.getRecallScore(cartname)) >= maxScore) {
+            maxScore = score;
+            hottest = cartname;
+        }
+    }
+
+    if (hottest.compare("") == 0)
+        return;
+
+    for (std::string drive : res.getDriveIds()) {
+        // only one cartridge is mounted in advance at a time
+        if (res.getMoveReqNum(drive) == PREMOUNT_REQNUM)
+            return;
+        if (driveIsFree(res, drive) == false)
+            continue;
+        if ((mounted = res.getMountedCartridge(drive)).compare("") == 0) {
+            empty = drive;
+            continue;
+        }
+        if (now - res.getMountTime(mounted) < conf.minDwellTime)
+            continue;
+        score = res.getRecallScore(mounted);
+        if (coldest.compare("") == 0 || score < minScore) {
+            minScore = score;
+            coldest = mounted;
+            idle = drive;
+        }
+    }
+
+    if (empty.compare("") != 0) {
+        res.premountTape(empty, hottest, MOUNT);
+    } else if (coldest.compare("") != 0
+            && minScore * Const::PREMOUNT_SCORE_RATIO < maxScore) {
+        // free the drive, the cartridge is mounted within the next pass
+        res.premountTape(idle, coldest, UNMOUNT);
+    }
+}
+
+void SchedulerPolicy::schedule(Resources& res, const config_t& conf,
+        double now)
+
+{
+    request_t req;
+    std::string driveId;
+    std::string tapeId;
+    priority_t waitingPrio;
+    bool waiting;
+    bool first;
+
+    ageRequests(res, conf, now);
+
+    /*
+     * With a minimum dwell time the requests for cartridges that are
+     * already mounted are scheduled first. Thereafter the remaining
+     * requests are considered that may cause tape mounts or unmounts.
+     */
+    for (int phase = (conf.minDwellTime > 0 ? 0 : 1); phase < 2; phase++) {
+        first = true;
+        waiting = false;
+        while (res.nextRequest(&req, first)) {
+            first = false;
+
+            /*
+             * Work on mounted cartridges is only scheduled first if it is
+             * at least as important as the first request (in the order of
+             * the ready queue) that waits for a drive. Otherwise e.g. a
+             * suspended migration would be scheduled again on its cartridge
+             * and the cartridge would be protected by the dwell time
+             * before the recall that suspended it got a drive.
+             */
+            if (phase == 0) {
+                if (mountedResource(res, req) == false) {
+                    if (waiting == false && needsDrive(res, req) == true
+                            && driveLimitReached(res, conf.limits, req.op,
+                                    req.pool, req.tapeId) == false) {
+                        waiting = true;
+                        waitingPrio = priority(req.op, req.recClass,
+                                req.aged);
+                    }
+                    continue;
+                }
+                if (waiting == true
+                        && waitingPrio
+                                < priority(req.op, req.recClass, req.aged))
+                    continue;
+            }
+
+            if (driveLimitReached(res, conf.limits, req.op, req.pool,
+                    req.tapeId) == true)
+                continue;
+
+            if (resAvail(res, conf, now, req, &driveId, &tapeId) == false)
+                continue;
+
+            res.dispatch(req, driveId, tapeId);
+        }
+    }
+
+    premount(res, conf, now);
+}
+
+unsigned long SchedulerPolicy::migrationShare(unsigned long unclaimedSize,
+        unsigned long maxSize, int numDrives, unsigned long freeSpace)
+
+{
+    unsigned long share = unclaimedSize / numDrives;
+
+    /*
+     * Each session only takes its share of the remaining files (but at
+     * least the largest file and Const::MIN_MIG_SESSION_SIZE) such that
+     * the other drives get work as well.
+     */
+    if (share < maxSize)
+        share = maxSize;
+    if (share < Const::MIN_MIG_SESSION_SIZE)
+        share = Const::MIN_MIG_SESSION_SIZE;
+    if (share < freeSpace)
+        return share;
+
+    return freeSpace;
+}
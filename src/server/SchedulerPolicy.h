@@ -0,0 +1,161 @@
+/*******************************************************************************
+ * Copyright 2018 IBM Corp. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *******************************************************************************/
+#pragma once
+
+class SchedulerPolicy
+
+{
+public:
+    // same values as DataBase::operation, TransRecall::recall_class,
+    // and Configuration::drive_op
+    enum operation
+    {
+        MOUNT = 0,
+        MOVE = 1,
+        TRARECALL = 2,
+        SELRECALL = 3,
+        MIGRATION = 4,
+        FORMAT = 5,
+        CHECK = 6,
+        UNMOUNT = 7,
+        NOOP = 8
+    };
+    enum recall_class
+    {
+        INTERACTIVE, BULK
+    };
+    enum drive_op
+    {
+        MIGRATION_DRIVES, RECALL_DRIVES
+    };
+    enum cart_state
+    {
+        CART_INUSE, CART_MOUNTED, CART_MOVING, CART_UNMOUNTED, CART_UNKNOWN
+    };
+    struct drive_limits
+    {
+        int minDrives;
+        int maxDrives;
+    };
+    typedef std::pair<std::string, int> limitkey_t;
+    typedef std::tuple<int, int, double, int, int, std::string> queuekey_t;
+    // operation and service class, lower values are more important
+    typedef std::pair<int, int> priority_t;
+
+    // a request of the ready queue as seen by the policy
+    struct request_t
+    {
+        int op;
+        int reqNum;
+        int replNum;
+        std::string pool;
+        std::string tapeId;
+        std::string driveId;
+        double timeAdded;
+        unsigned long minFileSize;
+        int recClass;
+        bool aged;
+    };
+    struct config_t
+    {
+        int minDwellTime;
+        int recallLatency;
+        bool premountHot;
+        std::map<limitkey_t, drive_limits> limits;
+    };
+
+    // the ready queue, drives, and cartridges as seen by the policy
+    class Resources
+    {
+    public:
+        virtual ~Resources() = default;
+
+        // the request following the given one in the order of the ready queue
+        virtual bool nextRequest(request_t *req, bool first) = 0;
+        virtual void setAged(const request_t& req) = 0;
+        // number of waiting requests that need this cartridge and that
+        // have at least the given priority
+        virtual int pendingWork(std::string tapeId, priority_t minPriority) = 0;
+        // the pool and operation each drive in use is used for
+        virtual std::map<std::string, limitkey_t> getUsedDrives() = 0;
+
+        virtual std::list<std::string> getDriveIds() = 0;
+        virtual bool driveIsBusy(std::string driveId) = 0;
+        // request number and pool of a tape move the drive is reserved for
+        virtual int getMoveReqNum(std::string driveId) = 0;
+        virtual std::string getMoveReqPool(std::string driveId) = 0;
+        // the cartridge in that drive if it is mounted and not in use
+        virtual std::string getMountedCartridge(std::string driveId) = 0;
+        virtual int getToUnblock(std::string driveId) = 0;
+        virtual void setToUnblock(std::string driveId, int op) = 0;
+
+        virtual std::list<std::string> getCartridgeIds() = 0;
+        virtual cart_state getCartridgeState(std::string tapeId) = 0;
+        virtual std::string getMountingDrive(std::string tapeId) = 0;
+        virtual double getMountTime(std::string tapeId) = 0;
+        virtual unsigned long getRemainingCap(std::string tapeId) = 0;
+        virtual std::string getPool(std::string tapeId) = 0;
+        virtual std::set<std::string> getPoolCartridges(std::string pool) = 0;
+        virtual bool isRequested(std::string tapeId) = 0;
+        virtual void setRequested(std::string tapeId, bool requested) = 0;
+        virtual double getRecallScore(std::string tapeId) = 0;
+
+        // mount, move, or unmount a cartridge for a request
+        virtual void moveTape(const request_t& req, std::string driveId,
+                std::string tapeId, operation op) = 0;
+        // mount or unmount a cartridge in advance
+        virtual void premountTape(std::string driveId, std::string tapeId,
+                operation op) = 0;
+        // start processing a request on that drive and cartridge
+        virtual void dispatch(const request_t& req, std::string driveId,
+                std::string tapeId) = 0;
+    };
+
+    // reserves a drive for pre-mounting a cartridge
+    static const int PREMOUNT_REQNUM = -2;
+
+    static int serviceClass(int recClass, bool aged);
+    static priority_t priority(int op, int recClass, bool aged);
+    static queuekey_t queueKey(int op, int recClass, bool aged,
+            double timeAdded, int reqNum, int replNum, std::string tapeId);
+    static bool needsAging(int op, int recClass, bool aged, double waiting,
+            int recallLatency);
+    static bool driveIsFree(Resources& res, std::string driveId);
+    static bool driveIsUsable(Resources& res, std::string driveId,
+            const request_t& req);
+    static bool mountedResource(Resources& res, const request_t& req);
+    static bool needsDrive(Resources& res, const request_t& req);
+    static bool limitKey(Resources& res, int op, std::string pool,
+            std::string tapeId, limitkey_t *key);
+    static bool driveLimitReached(Resources& res,
+            const std::map<limitkey_t, drive_limits>& limits, int op,
+            std::string pool, std::string tapeId);
+    static std::string selectUnmount(Resources& res, const config_t& conf,
+            double now, const request_t& req);
+    static bool poolResAvail(Resources& res, const config_t& conf, double now,
+            const request_t& req, std::string *driveId, std::string *tapeId);
+    static bool tapeResAvail(Resources& res, const config_t& conf, double now,
+            const request_t& req, std::string *driveId);
+    static bool tapeMoveResAvail(Resources& res, const request_t& req);
+    static bool resAvail(Resources& res, const config_t& conf, double now,
+            const request_t& req, std::string *driveId, std::string *tapeId);
+    static void ageRequests(Resources& res, const config_t& conf, double now);
+    static void premount(Resources& res, const config_t& conf, double now);
+    static void schedule(Resources& res, const config_t& conf, double now);
+    static unsigned long migrationShare(unsigned long unclaimedSize,
+            unsigned long maxSize, int numDrives, unsigned long freeSpace);
+};
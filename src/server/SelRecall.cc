@@ -28,7 +28,9 @@
        recall requests are added to the internal queues.
     2. The Scheduler identifies a selective recall request to get scheduled.
        The order of files being recalled depends on the starting block of
-       the data files on tape: @snippet server/SQLStatements.cc sel_recall_sql_qry
+       the data files on tape. All recall jobs for the same tape are processed
+       within a single sweep even if these belong to different requests
+       (see @ref recall_session).
 
     @dot
     digraph sel_recall {
@@ -47,8 +49,8 @@
             label="second phase";
             scheduler [label="Scheduler"];
             subgraph cluster_rec_exec {
-                label="SelRecall::execRequest";
-                rec_exec [label="read from tape\n(SelRecall::processFiles)\nordered by starting block"];
+                label="RecallSession::execRequest";
+                rec_exec [label="read from tape\n(RecallSession::processFiles)\nordered by starting block"];
             }
             scheduler -> rec_exec [label="schedule\nrecall request", fontname="courier", fontsize=8, lhead=cluster_rec_exec];
         }
@@ -82,8 +84,9 @@
     to premigrated state.
 
     Thereafter the file names of the files to be recalled are sent to the backend.
-    When receiving this information corresponding entries are added to the SQL
-    table JOB_QUEUE. For each file one entry is created. After that an entry is
+    When receiving this information corresponding entries are added to the
+    job store, by default the SQL table JOB_QUEUE (see @ref job_store). For
+    each file one entry is created. After that an entry is
     added to the SQL table REQUEST_QUEUE.
 
     This is an example of these two tables in case of selectively recalling
@@ -113,8 +116,10 @@
       @ref LTFSDmProtocol::LTFSDmSelRecRequest::state "recreq.state()")
     - respond back to the client with a request number
     - MessageParser::getObjects: retrieving file names to recall
-        - SelRecall::addJob: add recall information the the SQLite table JOB_QUEUE
+        - SelRecall::addJob: determine the recall information of each file
+        - JobStore::addJob: add the jobs of a message to the SQLite table JOB_QUEUE
     - SelRecall::addRequest: add a request to the SQLite table REQUEST_QUEUE
+      and to the scheduler's ready queue (Scheduler::queueRequest)
     - MessageParser::reqStatusMessage: provide updates to the recall processing to the client
 
     </TT>
@@ -129,18 +134,24 @@
     Scheduler::run:
     - if a selective request is ready do be scheduled:
         - update record in request queue to mark it as DataBase::REQ_INPROGRESS
-        - SelRecall::execRequest
+        - RecallSession::execRequest
+            - take over all other recall requests waiting for the same tape
+              (Scheduler::claimRecalls)
             - add status: @ref Status::add "mrStatus.add"
-            - call SelRecall::processFiles depending the target state SelRecall::targetState
-            - if @ref SelRecall::needsTape "needsTape" is true:
-                - release tape for further operations since for stubbing files there is nothing written to tape
+            - call RecallSession::processFiles
+            - release tape for further operations
             - update record in request queue to mark it as DataBase::REQ_COMPLETED
+              or DataBase::REQ_NEW if it has been suspended
 
     </TT>
 
-    In SelRecall::execRequest adding an entry to the @ref mrStatus object is
-    necessary for the client that initiated the request to receive progress
-    information.
+    Files of a request that are all in premigrated state do not need a tape.
+    These files are recalled by SelRecall::execRequest without involving the
+    scheduler.
+
+    In SelRecall::execRequest and RecallSession::execRequest adding an entry
+    to the @ref mrStatus object is necessary for the client that initiated
+    the request to receive progress information.
 
     ### SelRecall::processFiles
 
@@ -179,10 +190,10 @@
             before -> after [];
        }
        @enddot
-    -# A list is returned containing the inode numbers of these files where
-       the previous operation was successful. Change all corresponding jobs
-       to FsObj::PREMIGRATED or FsObj::RESIDENT depending of the target
-       state. The following changed indicates that recall stopped
+    -# Each job where the previous operation was successful is changed to
+       FsObj::PREMIGRATED or FsObj::RESIDENT depending of the target state.
+       Like for migration these changes are committed in batches while the
+       files are recalled. The following changed indicates that recall stopped
        before file file.5 and target state is premigrated:
        @dot
        digraph step_1 {
@@ -196,8 +207,8 @@
             before -> after [];
        }
        @enddot
-    -# The remaining jobs (those where no corresponding inode numbers were
-       in the list) have not been processed and need to be changed to the
+    -# The remaining jobs (those that have not been changed in the previous
+       step) have not been processed and need to be changed to the
        original state if these were still in FsObj::RECALLING_MIG or
        FsObj::RECALLING_PREMIG state. Jobs that failed in the second step
        already have been marked as FsObj::FAILED. A reason for remaining
@@ -233,11 +244,12 @@ void SelRecall::addJob(std::string fileName)
 
 {
     struct stat statbuf;
-    SQLStatement stmt;
     std::string tapeName;
     int state;
     FsObj::mig_target_attr_t attr;
     fuid_t fuid;
+    std::string tapeId;
+    long startBlock;
 
     try {
         FsObj fso(fileName);
@@ -258,31 +270,38 @@ void SelRecall::addJob(std::string fileName)
 
         if (state == FsObj::MIGRATED) {
             needsTape.insert(attr.tapeInfo[0].tapeId);
+            inventory->addRecall(attr.tapeInfo[0].tapeId);
         }
 
         tapeName = Server::getTapeName(&fso, attr.tapeInfo[0].tapeId);
 
         fuid = fso.getfuid();
-        stmt(SelRecall::ADD_JOB) << DataBase::SELRECALL << fileName << reqNumber
-                << targetState << statbuf.st_size << fuid.fsid_h << fuid.fsid_l
-                << fuid.igen << fuid.inum << statbuf.st_mtim.tv_sec
-                << statbuf.st_mtim.tv_nsec << time(NULL) << state
-                << attr.tapeInfo[0].tapeId << attr.tapeInfo[0].startBlock;
+        tapeId = attr.tapeInfo[0].tapeId;
+        startBlock = attr.tapeInfo[0].startBlock;
     } catch (const std::exception& e) {
         TRACE(Trace::error, e.what());
-        stmt(SelRecall::ADD_JOB) << DataBase::SELRECALL << fileName << reqNumber
-                << targetState << Const::UNSET << Const::UNSET << Const::UNSET
-                << Const::UNSET << Const::UNSET << 0 << 0 << time(NULL)
-                << FsObj::FAILED << Const::FAILED_TAPE_ID << 0;
+        statbuf.st_size = Const::UNSET;
+        statbuf.st_mtim.tv_sec = 0;
+        statbuf.st_mtim.tv_nsec = 0;
+        fuid.fsid_h = Const::UNSET;
+        fuid.fsid_l = Const::UNSET;
+        fuid.igen = Const::UNSET;
+        fuid.inum = Const::UNSET;
+        state = FsObj::FAILED;
+        tapeId = Const::FAILED_TAPE_ID;
+        startBlock = 0;
         MSG(LTFSDMS0017E, fileName.c_str());
     }
 
-    TRACE(Trace::normal, stmt.str());
-
-    stmt.doall();
+    jobs.push_back(
+            (JobStore::job_t ) { DataBase::SELRECALL, fileName,
+                            static_cast<int>(reqNumber), targetState,
+                            Const::UNSET, "", statbuf.st_size, fuid,
+                            statbuf.st_mtim.tv_sec, statbuf.st_mtim.tv_nsec,
+                            static_cast<FsObj::file_state>(state), tapeId,
+                            startBlock, 0 });
 
-    TRACE(Trace::always, fileName, attr.tapeInfo[0].tapeId,
-            attr.tapeInfo[0].startBlock);
+    TRACE(Trace::always, fileName, tapeId, startBlock);
 
     return;
 }
@@ -290,21 +309,17 @@ void SelRecall::addJob(std::string fileName)
 void SelRecall::addRequest()
 
 {
-    SQLStatement gettapesstmt = SQLStatement(SelRecall::GET_TAPES) << reqNumber;
     SQLStatement addreqstmt;
-    std::string tapeId;
     int state;
     std::stringstream thrdinfo;
     SubServer subs;
 
-    gettapesstmt.prepare();
-
     {
         std::lock_guard<std::mutex> updlock(Scheduler::updmtx);
         Scheduler::updReq[reqNumber] = false;
     }
 
-    while (gettapesstmt.step(&tapeId)) {
+    for (std::string tapeId : jobStore->getTapes(reqNumber)) {
         if (tapeId.compare(Const::FAILED_TAPE_ID) == 0)
             state = DataBase::REQ_COMPLETED;
         else if (needsTape.count(tapeId) > 0)
@@ -312,8 +327,10 @@ void SelRecall::addRequest()
         else
             state = DataBase::REQ_INPROGRESS;
 
+        time_t timeAdded = time(NULL);
+
         addreqstmt(SelRecall::ADD_REQUEST) << DataBase::SELRECALL << reqNumber
-                << targetState << tapeId << time(NULL) << state;
+                << targetState << tapeId << timeAdded << state;
 
         TRACE(Trace::normal, addreqstmt.str());
 
@@ -322,17 +339,17 @@ void SelRecall::addRequest()
         TRACE(Trace::always, needsTape.count(tapeId), reqNumber, tapeId);
 
         if (needsTape.count(tapeId) > 0) {
+            Scheduler::queueRequest( { DataBase::SELRECALL,
+                    static_cast<int>(reqNumber), targetState, Const::UNSET,
+                    Const::UNSET, "", tapeId, "", timeAdded, 0 });
             Scheduler::invoke();
         } else {
             thrdinfo << "SR(" << reqNumber << ")";
             subs.enqueue(thrdinfo.str(), &SelRecall::execRequest,
-                    SelRecall(getpid(), reqNumber, targetState), "", tapeId,
-                    false);
+                    SelRecall(getpid(), reqNumber, targetState), tapeId);
         }
     }
 
-    gettapesstmt.finalize();
-
     subs.waitAllRemaining();
 }
 
@@ -343,11 +360,10 @@ unsigned long SelRecall::recall(std::string fileName, std::string tapeId,
     struct stat statbuf;
     struct stat statbuf_tape;
     std::string tapeName;
-    char buffer[Const::READ_BUFFER_SIZE];
     long rsize;
-    long wsize;
     int fd = -1;
     long offset = 0;
+    long memberOffset;
     FsObj::file_state curstate;
 
     try {
@@ -367,6 +383,7 @@ unsigned long SelRecall::recall(std::string fileName, std::string tapeId,
             return 0;
         } else if (state == FsObj::MIGRATED) {
             tapeName = Server::getTapeName(&target, tapeId);
+            memberOffset = Server::getMemberOffset(&target, tapeId, &tapeName);
             fd = Server::openTapeRetry(tapeId, tapeName.c_str(),
             O_RDWR | O_CLOEXEC);
 
@@ -378,7 +395,15 @@ unsigned long SelRecall::recall(std::string fileName, std::string tapeId,
 
             statbuf = target.stat();
 
-            if (fstat(fd, &statbuf_tape) == 0
+            if (memberOffset != Const::UNSET) {
+                if (fstat(fd, &statbuf_tape) == -1
+                        || statbuf_tape.st_size < memberOffset + statbuf.st_size
+                        || lseek(fd, memberOffset, SEEK_SET) != memberOffset) {
+                    TRACE(Trace::error, errno, memberOffset);
+                    MSG(LTFSDMS0128E, fileName, tapeName.c_str());
+                    THROW(Error::GENERAL_ERROR, fileName, memberOffset);
+                }
+            } else if (fstat(fd, &statbuf_tape) == 0
                     && statbuf_tape.st_size != statbuf.st_size) {
                 MSG(LTFSDMS0097W, fileName, statbuf.st_size,
                         statbuf_tape.st_size);
@@ -388,27 +413,22 @@ unsigned long SelRecall::recall(std::string fileName, std::string tapeId,
 
             target.prepareRecall();
 
+            DataMover mover(inventory->getBlockSize());
+
             while (offset < statbuf.st_size) {
                 if (Server::forcedTerminate)
                     THROW(Error::OK);
 
-                rsize = read(fd, buffer, sizeof(buffer));
-                if (rsize == 0) {
+                rsize = mover.fromTape(fd, &target, offset,
+                        statbuf.st_size - offset);
+                if (rsize == 0)
                     break;
-                }
 
                 if (rsize == -1) {
                     TRACE(Trace::error, errno);
-                    MSG(LTFSDMS0023E, tapeName.c_str());
+                    MSG(LTFSDMS0126E, tapeName.c_str());
                     THROW(Error::GENERAL_ERROR, fileName, errno);
                 }
-                wsize = target.write(offset, (unsigned long) rsize, buffer);
-                if (wsize != rsize) {
-                    TRACE(Trace::error, errno, wsize, rsize);
-                    MSG(LTFSDMS0027E, fileName.c_str());
-                    close(fd);
-                    THROW(Error::GENERAL_ERROR, fileName, wsize, rsize);
-                }
                 offset += rsize;
             }
 
@@ -428,17 +448,19 @@ unsigned long SelRecall::recall(std::string fileName, std::string tapeId,
     return statbuf.st_size;
 }
 
-bool SelRecall::processFiles(std::string tapeId, FsObj::file_state toState,
-bool needsTape)
+void SelRecall::failRecall(int reqNum, long jobId, FsObj::file_state toState)
 
 {
-    SQLStatement stmt;
-    std::string fileName;
-    FsObj::file_state state;
-    unsigned long inum;
-    std::shared_ptr<LTFSDMDrive> drive = nullptr;
-    std::list<unsigned long> inumList;
-    bool suspended = false;
+    // the recall already has been counted as successful
+    mrStatus.updateFailed(reqNum, toState);
+    jobStore->failJob(jobId);
+}
+
+void SelRecall::processFiles(std::string tapeId, FsObj::file_state toState)
+
+{
+    std::set<int> reqNums = { static_cast<int>(reqNumber) };
+    std::shared_ptr<JobStore::Batch> successes = jobStore->createBatch();
     time_t start;
 
     TRACE(Trace::full, reqNumber);
@@ -449,141 +471,152 @@ bool needsTape)
         Scheduler::updcond.notify_all();
     }
 
-    if (needsTape) {
-        for (std::shared_ptr<LTFSDMDrive> d : inventory->getDrives()) {
-            if (d->get_le()->get_slot()
-                    == inventory->getCartridge(tapeId)->get_le()->get_slot()) {
-                drive = d;
-                break;
-            }
-        }
-        assert(drive != nullptr);
-    }
-
-    stmt(SelRecall::SET_RECALLING) << FsObj::RECALLING_MIG << reqNumber
-            << FsObj::MIGRATED << tapeId;
-    TRACE(Trace::normal, stmt.str());
-    stmt.doall();
-
-    stmt(SelRecall::SET_RECALLING) << FsObj::RECALLING_PREMIG << reqNumber
-            << FsObj::PREMIGRATED << tapeId;
-    TRACE(Trace::normal, stmt.str());
-    stmt.doall();
+    jobStore->changeState(reqNums, Const::UNSET, tapeId,
+            FsObj::MIGRATED, FsObj::RECALLING_MIG);
+    jobStore->changeState(reqNums, Const::UNSET, tapeId,
+            FsObj::PREMIGRATED, FsObj::RECALLING_PREMIG);
 
-    stmt(SelRecall::SELECT_JOBS) << reqNumber << tapeId << FsObj::RECALLING_MIG
-            << FsObj::RECALLING_PREMIG;
-    TRACE(Trace::normal, stmt.str());
-    stmt.prepare();
     start = time(NULL);
-    while (stmt.step(&fileName, &state, &inum)) {
-        if (Server::terminate == true)
-            break;
-
-        if (state == FsObj::RECALLING_MIG)
-            state = FsObj::MIGRATED;
-        else
-            state = FsObj::PREMIGRATED;
-
-        TRACE(Trace::always, fileName, state, toState);
-
-        if (state == toState)
-            continue;
-
-        if (needsTape && drive->getToUnblock() == DataBase::TRARECALL) {
-            TRACE(Trace::always, tapeId);
-            suspended = true;
-            break;
-        }
-
-        try {
-            if ((state == FsObj::MIGRATED) && (needsTape == false)) {
-                MSG(LTFSDMS0047E, fileName);
-                THROW(Error::GENERAL_ERROR, fileName);
-            }
-            recall(fileName, tapeId, state, toState);
-            inumList.push_back(inum);
-            mrStatus.updateSuccess(reqNumber, state, toState);
-        } catch (const std::exception& e) {
-            TRACE(Trace::error, e.what());
-            mrStatus.updateFailed(reqNumber, state);
-            SQLStatement failstmt = SQLStatement(SelRecall::FAIL_JOB)
-                    << FsObj::FAILED << fileName << reqNumber << tapeId;
-
-            TRACE(Trace::error, stmt.str());
-            failstmt.doall();
-        }
+    jobStore->selectRecallJobs(reqNums, tapeId,
+            [&](const JobStore::rec_job_t& job) {
+                FsObj::file_state state;
+
+                if (Server::terminate == true)
+                    return false;
+
+                if (job.state == FsObj::RECALLING_MIG)
+                    state = FsObj::MIGRATED;
+                else
+                    state = FsObj::PREMIGRATED;
+
+                TRACE(Trace::always, job.fileName, state, toState);
+
+                if (state == toState)
+                    return true;
+
+                try {
+                    if (state == FsObj::MIGRATED) {
+                        MSG(LTFSDMS0047E, job.fileName);
+                        THROW(Error::GENERAL_ERROR, job.fileName);
+                    }
+                    recall(job.fileName, tapeId, state, toState);
+                    mrStatus.updateSuccess(reqNumber, state, toState);
+                    successes->setRecalled(
+                            std::bind(&SelRecall::failRecall, reqNumber,
+                                    job.jobId, toState), job.jobId, toState);
+                } catch (const std::exception& e) {
+                    TRACE(Trace::error, e.what());
+                    mrStatus.updateFailed(reqNumber, state);
+                    TRACE(Trace::error, job.fileName, reqNumber, tapeId);
+                    jobStore->failJob(job.jobId);
+                }
 
-        if (time(NULL) - start < 10)
-            continue;
+                if (time(NULL) - start < 10)
+                    return true;
 
-        start = time(NULL);
+                start = time(NULL);
 
-        std::lock_guard<std::mutex> lock(Scheduler::updmtx);
-        Scheduler::updReq[reqNumber] = true;
-        Scheduler::updcond.notify_all();
-    }
+                std::lock_guard<std::mutex> lock(Scheduler::updmtx);
+                Scheduler::updReq[reqNumber] = true;
+                Scheduler::updcond.notify_all();
+                return true;
+            });
     {
         std::lock_guard<std::mutex> lock(Scheduler::updmtx);
         Scheduler::updReq[reqNumber] = true;
         Scheduler::updcond.notify_all();
     }
-    stmt.finalize();
-
-    stmt(SelRecall::SET_JOB_SUCCESS) << toState << reqNumber << tapeId
-            << FsObj::RECALLING_MIG << FsObj::RECALLING_PREMIG
-            << genInumString(inumList);
-    TRACE(Trace::normal, stmt.str());
-    stmt.doall();
-
-    stmt(SelRecall::RESET_JOB_STATE) << FsObj::MIGRATED << reqNumber << tapeId
-            << FsObj::RECALLING_MIG;
-    TRACE(Trace::normal, stmt.str());
-    stmt.doall();
 
-    stmt(SelRecall::RESET_JOB_STATE) << FsObj::PREMIGRATED << reqNumber
-            << tapeId << FsObj::RECALLING_PREMIG;
-    TRACE(Trace::normal, stmt.str());
-    stmt.doall();
+    successes->flush();
 
-    return suspended;
+    jobStore->changeState(reqNums, Const::UNSET, tapeId,
+            FsObj::RECALLING_MIG, FsObj::MIGRATED);
+    jobStore->changeState(reqNums, Const::UNSET, tapeId,
+            FsObj::RECALLING_PREMIG, FsObj::PREMIGRATED);
 }
 
-void SelRecall::execRequest(std::string driveId, std::string tapeId,
-bool needsTape)
+void SelRecall::execRequest(std::string tapeId)
 
 {
     SQLStatement stmt;
-    bool suspended = false;
 
     mrStatus.add(reqNumber);
 
     if (targetState == FsObj::PREMIGRATED)
-        suspended = processFiles(tapeId, FsObj::PREMIGRATED, needsTape);
+        processFiles(tapeId, FsObj::PREMIGRATED);
     else
-        suspended = processFiles(tapeId, FsObj::RESIDENT, needsTape);
+        processFiles(tapeId, FsObj::RESIDENT);
 
-    TRACE(Trace::always, reqNumber, needsTape, tapeId);
-
-    if (needsTape) {
-        std::lock_guard<std::recursive_mutex> lock(LTFSDMInventory::mtx);
-        if (inventory->getCartridge(tapeId)->getState()
-                == LTFSDMCartridge::TAPE_INUSE)
-            inventory->getCartridge(tapeId)->setState(
-                    LTFSDMCartridge::TAPE_MOUNTED);
-
-        inventory->getDrive(driveId)->setFree();
-        inventory->getDrive(driveId)->clearToUnblock();
-    }
+    TRACE(Trace::always, reqNumber, tapeId);
 
     std::unique_lock<std::mutex> updlock(Scheduler::updmtx);
 
-    stmt(SelRecall::UPDATE_REQUEST)
-            << (suspended ? DataBase::REQ_NEW : DataBase::REQ_COMPLETED)
-            << reqNumber << tapeId;
+    stmt(SelRecall::UPDATE_REQUEST) << DataBase::REQ_COMPLETED << reqNumber
+            << tapeId;
     TRACE(Trace::normal, stmt.str());
     stmt.doall();
 
     Scheduler::updReq[reqNumber] = true;
     Scheduler::updcond.notify_all();
-    Scheduler::invoke();
+}
+
+int SelRecall::resumeRequests(SubServer& subs)
+
+{
+    SQLStatement stmt;
+    Scheduler::request_t req;
+    std::list<Scheduler::request_t> reqs;
+    std::stringstream thrdinfo;
+    int migrated;
+    int premigrated;
+    int resumed = 0;
+
+    stmt(SelRecall::RESUME_JOBS) << FsObj::MIGRATED << DataBase::SELRECALL
+            << FsObj::RECALLING_MIG;
+    stmt.doall();
+
+    stmt(SelRecall::RESUME_JOBS) << FsObj::PREMIGRATED << DataBase::SELRECALL
+            << FsObj::RECALLING_PREMIG;
+    stmt.doall();
+
+    req = (Scheduler::request_t ) { DataBase::SELRECALL, 0, 0, Const::UNSET,
+                    Const::UNSET, "", "", "", 0, 0 };
+    stmt(SelRecall::RESUME_REQUESTS) << DataBase::SELRECALL
+            << DataBase::REQ_COMPLETED << Const::FAILED_TAPE_ID;
+    stmt.prepare();
+    while (stmt.step(&req.reqNum, &req.tgtState, &req.tapeId, &req.timeAdded))
+        reqs.push_back(req);
+    stmt.finalize();
+
+    for (Scheduler::request_t req : reqs) {
+        migrated = jobStore->countJobs(req.reqNum, req.tapeId,
+                FsObj::MIGRATED);
+        premigrated = jobStore->countJobs(req.reqNum, req.tapeId,
+                FsObj::PREMIGRATED);
+
+        TRACE(Trace::always, req.reqNum, req.tapeId, migrated, premigrated);
+
+        if (migrated > 0) {
+            stmt(SelRecall::UPDATE_REQUEST) << DataBase::REQ_NEW << req.reqNum
+                    << req.tapeId;
+            stmt.doall();
+            Scheduler::queueRequest(req);
+            resumed++;
+        } else if (premigrated > 0) {
+            stmt(SelRecall::UPDATE_REQUEST) << DataBase::REQ_INPROGRESS
+                    << req.reqNum << req.tapeId;
+            stmt.doall();
+            thrdinfo.str("");
+            thrdinfo << "SR(" << req.reqNum << ")";
+            subs.enqueue(thrdinfo.str(), &SelRecall::execRequest,
+                    SelRecall(getpid(), req.reqNum, req.tgtState), req.tapeId);
+            resumed++;
+        } else {
+            stmt(SelRecall::UPDATE_REQUEST) << DataBase::REQ_COMPLETED
+                    << req.reqNum << req.tapeId;
+            stmt.doall();
+        }
+    }
+
+    return resumed;
 }
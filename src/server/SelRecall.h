@@ -18,25 +18,19 @@
 
 class SelRecall: public FileOperation
 {
+    friend class DataBase;
 private:
     unsigned long pid;
     long reqNumber;
     std::set<std::string> needsTape;
     int targetState;
-    static unsigned long recall(std::string fileName, std::string tapeId,
-            FsObj::file_state state, FsObj::file_state toState);
-    bool processFiles(std::string tapeId, FsObj::file_state toState,
-            bool needsTape);
+    void processFiles(std::string tapeId, FsObj::file_state toState);
+    static void failRecall(int reqNum, long jobId, FsObj::file_state toState);
 
-    static const std::string ADD_JOB;
-    static const std::string GET_TAPES;
     static const std::string ADD_REQUEST;
-    static const std::string SET_RECALLING;
-    static const std::string SELECT_JOBS;
-    static const std::string FAIL_JOB;
-    static const std::string SET_JOB_SUCCESS;
-    static const std::string RESET_JOB_STATE;
     static const std::string UPDATE_REQUEST;
+    static const std::string RESUME_JOBS;
+    static const std::string RESUME_REQUESTS;
 public:
     SelRecall(unsigned long _pid, long _reqNumber, int _targetState) :
             pid(_pid), reqNumber(_reqNumber), targetState(_targetState)
@@ -44,5 +38,8 @@ public:
     }
     void addJob(std::string fileName);
     void addRequest();
-    void execRequest(std::string driveId, std::string tapeId, bool needsTape);
+    static unsigned long recall(std::string fileName, std::string tapeId,
+            FsObj::file_state state, FsObj::file_state toState);
+    void execRequest(std::string tapeId);
+    static int resumeRequests(SubServer& subs);
 };
@@ -19,11 +19,12 @@
 std::atomic<bool> Server::terminate;
 std::atomic<bool> Server::forcedTerminate;
 std::atomic<bool> Server::finishTerminate;
+std::atomic<bool> Server::lazyLinks(false);
 std::mutex Server::termmtx;
 std::condition_variable Server::termcond;
 Configuration Server::conf;
 
-ThreadPool<Migration::mig_info_t, std::shared_ptr<std::list<unsigned long>>,
+ThreadPool<Migration::mig_info_t, std::shared_ptr<JobStore::Batch>,
         FsObj::file_state> *Server::wqs;
 
 int Server::statTapeRetry(std::string tapeId, const char *pathname,
@@ -91,6 +92,36 @@ std::string Server::getTapeName(unsigned long fsid_h, unsigned long fsid_l,
     return tapeName.str();
 }
 
+std::string Server::getContainerName(std::string tapeId, unsigned long id)
+
+{
+    std::stringstream tapeName;
+
+    tapeName << inventory->getMountPoint() << Const::DELIM << tapeId
+            << Const::DELIM << Const::LTFSDM_DATA_DIR << Const::DELIM
+            << Const::LTFS_NAME << ".container." << id;
+
+    return tapeName.str();
+}
+
+long Server::getMemberOffset(FsObj *diskFile, std::string tapeId,
+        std::string *tapeName)
+
+{
+    FsObj::mig_target_attr_t attr = diskFile->getAttribute();
+
+    for (int i = 0; i < attr.copies && i < Const::maxReplica; i++) {
+        if (tapeId.compare(attr.tapeInfo[i].tapeId) != 0)
+            continue;
+        if (attr.container[i].id == 0)
+            return Const::UNSET;
+        *tapeName = getContainerName(tapeId, attr.container[i].id);
+        return attr.container[i].offset;
+    }
+
+    return Const::UNSET;
+}
+
 long Server::getStartBlock(std::string tapeName, int fd)
 
 {
@@ -122,6 +153,15 @@ void Server::createDir(std::string tapeId, std::string path)
 {
     struct stat statbuf;
     int retry = Const::LTFS_OPERATION_RETRY;
+    std::shared_ptr<LTFSDMCartridge> cart = inventory->getCartridge(tapeId);
+
+    /*
+     * Directories that have been found or created on a cartridge are
+     * remembered until it gets unmounted such that each ancestor of the
+     * links is checked only once on tape.
+     */
+    if (cart != nullptr && cart->isKnownDir(path))
+        return;
 
     while (retry > 0) {
         if (Server::statTapeRetry(tapeId, path.c_str(), &statbuf) == -1) {
@@ -132,8 +172,11 @@ void Server::createDir(std::string tapeId, std::string path)
                         retry--;
                         continue;
                     }
-                    if ( errno == EEXIST)
+                    if ( errno == EEXIST) {
+                        if (cart != nullptr)
+                            cart->addKnownDir(path);
                         return;
+                    }
                     MSG(LTFSDMS0093E, path, errno);
                     THROW(Error::GENERAL_ERROR, errno);
                 }
@@ -145,6 +188,8 @@ void Server::createDir(std::string tapeId, std::string path)
             MSG(LTFSDMS0095E, path);
             THROW(Error::GENERAL_ERROR, statbuf.st_mode);
         } else {
+            if (cart != nullptr)
+                cart->addKnownDir(path);
             return;
         }
     }
@@ -191,6 +236,35 @@ void Server::createLink(std::string tapeId, std::string origPath,
     }
 }
 
+void Server::createLinks(std::string tapeId)
+{
+    std::shared_ptr<LTFSDMCartridge> cart = inventory->getCartridge(tapeId);
+    std::list<std::pair<std::string, std::string>> links;
+    int failed = 0;
+
+    if (cart == nullptr)
+        return;
+
+    links = cart->takePendingLinks();
+
+    // links within the same directory are created one after the other
+    links.sort();
+
+    TRACE(Trace::always, tapeId, links.size());
+
+    for (std::pair<std::string, std::string>& link : links) {
+        try {
+            createLink(tapeId, link.first, link.second);
+        } catch (const std::exception& e) {
+            TRACE(Trace::error, e.what(), link.first);
+            failed++;
+        }
+    }
+
+    if (failed > 0)
+        MSG(LTFSDMS0129W, failed, tapeId);
+}
+
 void Server::createDataDir(std::string tapeId)
 {
     std::stringstream tapeDir;
@@ -320,7 +394,8 @@ void Server::writeKey()
     keyFile.close();
 }
 
-void Server::initialize(bool dbUseMemory)
+void Server::initialize(bool dbUseMemory, std::string _dbFile,
+        bool columnJobs)
 
 {
     //! [set resource limits]
@@ -341,10 +416,13 @@ void Server::initialize(bool dbUseMemory)
     unlink(Const::CLIENT_SOCKET_FILE.c_str());
     unlink(Const::RECALL_SOCKET_FILE.c_str());
 
+    dbFile = _dbFile;
+
     //! [init db]
     try {
-        DB.cleanup();
-        DB.open(dbUseMemory);
+        if (dbFile.compare("") == 0)
+            DB.cleanup();
+        DB.open(dbUseMemory, dbFile);
         DB.createTables();
     } catch (const std::exception& e) {
         TRACE(Trace::error, e.what());
@@ -352,6 +430,51 @@ void Server::initialize(bool dbUseMemory)
         THROW(Error::GENERAL_ERROR);
     }
     //! [init db]
+
+    if (columnJobs)
+        jobStore = new ColumnJobStore();
+    else
+        jobStore = new SQLJobStore();
+}
+
+void Server::resumeRequests(SubServer& subs)
+
+{
+    SQLStatement stmt;
+    long maxReqNum = 0;
+    int resumed;
+
+    /*
+     * Request numbers need to be unique also for requests that are
+     * added after the restart.
+     */
+    stmt(Server::MAX_REQ_NUM);
+    stmt.prepare();
+    while (stmt.step(&maxReqNum)) {
+    }
+    stmt.finalize();
+    globalReqNumber = maxReqNum;
+
+    /*
+     * Transparent recalls cannot be resumed since the processes waiting
+     * for them are gone. The same applies to requests for tape operations.
+     */
+    stmt(Server::DELETE_REQUESTS) << DataBase::MIGRATION
+            << DataBase::SELRECALL;
+    stmt.doall();
+
+    resumed = Migration::resumeRequests(subs);
+    resumed += SelRecall::resumeRequests(subs);
+
+    // the clients that would have picked up these results are gone
+    stmt(Server::DELETE_COMPLETED_REQUESTS) << DataBase::REQ_COMPLETED;
+    stmt.doall();
+
+    stmt(Server::DELETE_JOBS);
+    stmt.doall();
+
+    TRACE(Trace::always, maxReqNum, resumed);
+    MSG(LTFSDMS0123I, resumed, dbFile);
 }
 
 void Server::daemonize()
@@ -427,11 +550,24 @@ void Server::run(sigset_t set)
 
     //! [thread pool for stubbing]
     Server::wqs = new ThreadPool<Migration::mig_info_t,
-            std::shared_ptr<std::list<unsigned long>>, FsObj::file_state>(
+            std::shared_ptr<JobStore::Batch>, FsObj::file_state>(
             &Migration::changeFileState, Const::MAX_STUBBING_THREADS,
             "stub1-wq");
     //! [thread pool for stubbing]
 
+    if (DB.isPersistent()) {
+        try {
+            resumeRequests(subs);
+        } catch (const std::exception& e) {
+            TRACE(Trace::error, e.what());
+            MSG(LTFSDMS0124E, dbFile);
+            Server::terminate = true;
+            subs.waitAllRemaining();
+            delete (Server::wqs);
+            goto end;
+        }
+    }
+
     subs.enqueue("Scheduler", &Scheduler::run, &sched, key);
     subs.enqueue("SigHandler", &Server::signalHandler, set, key);
     subs.enqueue("Receiver", &Receiver::run, &recv, key, connector);
@@ -16,23 +16,32 @@
  *******************************************************************************/
 class Server
 {
+    friend class DataBase;
 private:
     SubServer subServer;
     long key;
+    std::string dbFile;
     void lockServer();
     void writeKey();
+    void resumeRequests(SubServer& subs);
     static void signalHandler(sigset_t set, long key);
+
+    static const std::string MAX_REQ_NUM;
+    static const std::string DELETE_REQUESTS;
+    static const std::string DELETE_COMPLETED_REQUESTS;
+    static const std::string DELETE_JOBS;
 public:
     static std::mutex termmtx;
     static std::condition_variable termcond;
     static std::atomic<bool> terminate;
     static std::atomic<bool> forcedTerminate;
     static std::atomic<bool> finishTerminate;
+    static std::atomic<bool> lazyLinks;
 
     static Configuration conf;
 
     static ThreadPool<Migration::mig_info_t,
-            std::shared_ptr<std::list<unsigned long>>, FsObj::file_state> *wqs;
+            std::shared_ptr<JobStore::Batch>, FsObj::file_state> *wqs;
 
     static int statTapeRetry(std::string tapeId, const char *pathname,
             struct stat *buf);
@@ -42,17 +51,21 @@ public:
     static std::string getTapeName(FsObj *diskfile, std::string tapeId);
     static std::string getTapeName(unsigned long fsid_h, unsigned long fsid_l,
             unsigned int igen, unsigned long ino, std::string tapeId);
+    static std::string getContainerName(std::string tapeId, unsigned long id);
+    static long getMemberOffset(FsObj *diskFile, std::string tapeId,
+            std::string *tapeName);
     static long getStartBlock(std::string tapeName, int fd);
     static void createDir(std::string tapeId, std::string path);
     static void createLink(std::string tapeId, std::string origPath,
             std::string dataPath);
+    static void createLinks(std::string tapeId);
     static void createDataDir(std::string tapeId);
 
     Server() :
             key(Const::UNSET)
     {
     }
-    void initialize(bool dbUseMemory);
+    void initialize(bool dbUseMemory, std::string _dbFile, bool columnJobs);
     void daemonize();
     void run(sigset_t set);
 };
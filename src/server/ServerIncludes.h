@@ -29,7 +29,10 @@
 #include <libmount/libmount.h>
 #include <blkid/blkid.h>
 #include <sys/vfs.h>
+#include <sys/sendfile.h>
+#include <sys/syscall.h>
 #include <errno.h>
+#include <math.h>
 
 #include <string>
 #include <sstream>
@@ -37,12 +40,17 @@
 #include <list>
 #include <condition_variable>
 #include <unordered_map>
+#include <unordered_set>
 #include <thread>
 #include <mutex>
 #include <map>
 #include <set>
+#include <tuple>
 #include <vector>
 #include <future>
+#include <functional>
+#include <atomic>
+#include <algorithm>
 
 #include <sqlite3.h>
 
@@ -63,14 +71,22 @@
 #include "ThreadPool.h"
 #include "Status.h"
 #include "DataBase.h"
+#include "JobStore.h"
+#include "SQLJobStore.h"
+#include "ColumnJobStore.h"
 #include "FileOperation.h"
 #include "MessageParser.h"
 #include "Receiver.h"
+#include "TapeContainer.h"
 #include "Migration.h"
 #include "SelRecall.h"
 #include "TransRecall.h"
 #include "Server.h"
 #include "TapeMover.h"
 #include "TapeHandler.h"
+#include "BufferPool.h"
 #include "LTFSDMInventory.h"
+#include "SchedulerPolicy.h"
 #include "Scheduler.h"
+#include "RecallSession.h"
+#include "DataMover.h"
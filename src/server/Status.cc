@@ -21,10 +21,6 @@ Status mrStatus;
 void Status::add(int reqNumber)
 
 {
-    SQLStatement stmt;
-    int num;
-    FsObj::file_state migState;
-
     std::lock_guard<std::mutex> lock(Status::mtx);
 
     //assert( allStates.count(reqNumber) == 0 );
@@ -33,34 +29,32 @@ void Status::add(int reqNumber)
 
     singleState state;
 
-    stmt(Status::STATUS) << reqNumber;
-    stmt.prepare();
-    while (stmt.step(&migState, &num)) {
-        switch (migState) {
+    for (std::pair<const FsObj::file_state, int> num : jobStore->countStates(
+            reqNumber)) {
+        switch (num.first) {
             case FsObj::RESIDENT:
             case FsObj::TRANSFERRING:
-                state.resident = num;
+                state.resident = num.second;
                 break;
             case FsObj::TRANSFERRED:
-                state.transferred = num;
+                state.transferred = num.second;
                 break;
             case FsObj::PREMIGRATED:
             case FsObj::CHANGINGFSTATE:
             case FsObj::RECALLING_PREMIG:
-                state.premigrated = num;
+                state.premigrated = num.second;
                 break;
             case FsObj::MIGRATED:
             case FsObj::RECALLING_MIG:
-                state.migrated = num;
+                state.migrated = num.second;
                 break;
             case FsObj::FAILED:
-                state.failed = num;
+                state.failed = num.second;
                 break;
             default:
-                TRACE(Trace::error, migState);
+                TRACE(Trace::error, num.first);
         }
     }
-    stmt.finalize();
     allStates[reqNumber] = state;
 }
 
@@ -130,6 +124,9 @@ void Status::updateFailed(int reqNumber, FsObj::file_state from)
         case FsObj::RESIDENT:
             state.resident--;
             break;
+        case FsObj::TRANSFERRED:
+            state.transferred--;
+            break;
         case FsObj::PREMIGRATED:
             state.premigrated--;
             break;
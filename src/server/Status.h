@@ -30,7 +30,6 @@ private:
     std::map<int, singleState> allStates;
     std::mutex mtx;
 
-    static const std::string STATUS;
 public:
     Status()
     {
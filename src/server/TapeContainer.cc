@@ -0,0 +1,200 @@
+/*******************************************************************************
+ * Copyright 2018 IBM Corp. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *******************************************************************************/
+#include "ServerIncludes.h"
+
+/** @page tape_container Tape Container
+
+    Usually the data of each migrated file is written to a separate file
+    on tape (Server::getTapeName). For each of these files the tape file
+    system writes its own index entry and the backend sets the FILE_PATH
+    attribute, creates a symbolic link and retrieves the starting block.
+    For small files this overhead dominates the time of the data transfer.
+
+    If the backend is started with the -a option (see @ref server_code)
+    files smaller than the given number of bytes are aggregated: the data
+    transfers of a migration session (Migration::processFiles) write
+    these files one after the other into a common container file on tape
+    (Server::getContainerName). Each container is filled up to
+    Const::CONTAINER_SIZE bytes, then the next one is started. The data of
+    the members starts at the beginning of the container and is not
+    padded.
+
+    For each member the container id and the offset of its data within the
+    container are stored within the migration target attribute (see
+    @ref connector). The starting block of the container is retrieved
+    only once, the starting block stored for a member is estimated by
+    adding its offset divided by the block size. It is only used to order
+    the recalls of a cartridge.
+
+    A recall (SelRecall::recall, TransRecall::recall) opens the container
+    instead of a separate file (Server::getMemberOffset), positions to
+    the offset of the member and copies as much data as the file size
+    before migration.
+
+    If the data transfer of a member fails the data already written is
+    overwritten by the next member (TapeContainer::discard). Members
+    are not interrupted when a request with a higher priority needs the
+    drive, they are small by definition.
+
+    When the session finishes (TapeContainer::finish) an offset table is
+    appended to the data of the members. It consists of a record
+    "<offset> <length> <file name>" per member terminated by a zero byte.
+    The offset of the table is stored within the
+    Const::LTFS_CONTAINER_INDEX attribute of the container. It is not
+    needed for recalls but allows to identify the members of a container
+    on tape without the disk files.
+    No symbolic links are created for members.
+ */
+
+std::atomic<unsigned long> TapeContainer::nextId(time(NULL) << 20);
+std::atomic<unsigned long> TapeContainer::threshold(0);
+
+TapeContainer::~TapeContainer()
+
+{
+    finish();
+}
+
+void TapeContainer::create()
+
+{
+    Server::createDataDir(tapeId);
+
+    while (true) {
+        id = nextId++;
+        tapeName = Server::getContainerName(tapeId, id);
+
+        fd = Server::openTapeRetry(tapeId, tapeName.c_str(),
+                O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC);
+
+        if (fd != -1)
+            break;
+
+        if ( errno != EEXIST) {
+            TRACE(Trace::error, errno);
+            MSG(LTFSDMS0021E, tapeName.c_str());
+            THROW(Error::GENERAL_ERROR, tapeName, errno);
+        }
+    }
+
+    TRACE(Trace::always, tapeId, id);
+
+    size = 0;
+    startBlock = Const::UNSET;
+    members.clear();
+}
+
+int TapeContainer::prepare(long length)
+
+{
+    if (fd != Const::UNSET && size > 0
+            && size + length > Const::CONTAINER_SIZE)
+        finish();
+
+    if (fd == Const::UNSET)
+        create();
+
+    return fd;
+}
+
+long TapeContainer::addMember(std::string fileName, long length)
+
+{
+    long offset = size;
+    unsigned long blockSize = inventory->getBlockSize();
+
+    members.push_back((member_t ) { fileName, offset, length });
+    size += length;
+
+    if (startBlock == Const::UNSET && length > 0)
+        startBlock = Server::getStartBlock(tapeName, fd);
+
+    if (startBlock == Const::UNSET)
+        return Const::UNSET;
+    else if (blockSize == 0)
+        return startBlock;
+    else
+        return startBlock + offset / blockSize;
+}
+
+void TapeContainer::discard()
+
+{
+    TRACE(Trace::error, tapeName, size);
+
+    if (lseek(fd, size, SEEK_SET) != (off_t) size) {
+        TRACE(Trace::error, errno);
+        MSG(LTFSDMS0022E, tapeName.c_str());
+        THROW(Error::GENERAL_ERROR, tapeName, errno);
+    }
+}
+
+void TapeContainer::writeIndex()
+
+{
+    std::stringstream table;
+    std::string tableStr;
+    std::stringstream offsetStr;
+    unsigned long written = 0;
+    long wsize;
+
+    for (member_t& member : members)
+        table << member.offset << " " << member.length << " "
+                << member.fileName << '\0';
+    tableStr = table.str();
+
+    if (ftruncate(fd, size) == -1 || lseek(fd, size, SEEK_SET) != (off_t) size)
+        THROW(Error::GENERAL_ERROR, tapeName, errno);
+
+    while (written < tableStr.size()) {
+        wsize = write(fd, tableStr.c_str() + written,
+                tableStr.size() - written);
+        if (wsize == -1)
+            THROW(Error::GENERAL_ERROR, tapeName, errno);
+        written += wsize;
+    }
+
+    offsetStr << size;
+    if (fsetxattr(fd, Const::LTFS_CONTAINER_INDEX.c_str(),
+            offsetStr.str().c_str(), offsetStr.str().length(), 0) == -1)
+        THROW(Error::GENERAL_ERROR, tapeName, errno);
+}
+
+void TapeContainer::finish()
+
+{
+    if (fd == Const::UNSET)
+        return;
+
+    TRACE(Trace::always, tapeName, members.size(), size);
+
+    if (members.size() == 0) {
+        close(fd);
+        if (unlink(tapeName.c_str()) == -1)
+            TRACE(Trace::error, tapeName, errno);
+    } else {
+        try {
+            writeIndex();
+        } catch (const std::exception& e) {
+            TRACE(Trace::error, e.what());
+            MSG(LTFSDMS0127W, tapeName.c_str());
+        }
+        close(fd);
+    }
+
+    fd = Const::UNSET;
+}
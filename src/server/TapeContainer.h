@@ -0,0 +1,64 @@
+/*******************************************************************************
+ * Copyright 2018 IBM Corp. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *******************************************************************************/
+#pragma once
+
+class TapeContainer
+{
+private:
+    struct member_t
+    {
+        std::string fileName;
+        long offset;
+        long length;
+    };
+    std::string tapeId;
+    unsigned long id;
+    std::string tapeName;
+    int fd;
+    long size;
+    long startBlock;
+    std::list<member_t> members;
+    static std::atomic<unsigned long> nextId;
+
+    void create();
+    void writeIndex();
+public:
+    static std::atomic<unsigned long> threshold;
+
+    TapeContainer(std::string _tapeId) :
+            tapeId(_tapeId), id(0), tapeName(""), fd(Const::UNSET), size(0),
+            startBlock(Const::UNSET)
+    {
+    }
+    ~TapeContainer();
+    unsigned long getId()
+    {
+        return id;
+    }
+    std::string getTapeName()
+    {
+        return tapeName;
+    }
+    long getOffset()
+    {
+        return size;
+    }
+    int prepare(long length);
+    long addMember(std::string fileName, long length);
+    void discard();
+    void finish();
+};
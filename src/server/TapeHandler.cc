@@ -22,19 +22,24 @@ void TapeHandler::addRequest()
 {
     SQLStatement stmt;
     long reqNumber = ++globalReqNumber;
+    time_t timeAdded = time(NULL);
+    DataBase::operation dbop = (
+            op == TapeHandler::FORMAT ? DataBase::FORMAT : DataBase::CHECK);
 
     std::lock_guard<std::recursive_mutex> lock(LTFSDMInventory::mtx);
 
     TRACE(Trace::always, op, tapeId, poolName);
 
-    stmt(TapeHandler::ADD_REQUEST)
-            << (op == TapeHandler::FORMAT ? DataBase::FORMAT : DataBase::CHECK)
-            << reqNumber << Const::UNSET << tapeId << poolName << time(NULL)
-            << DataBase::REQ_NEW;
+    stmt(TapeHandler::ADD_REQUEST) << dbop << reqNumber << Const::UNSET
+            << tapeId << poolName << timeAdded << DataBase::REQ_NEW;
 
     TRACE(Trace::normal, stmt.str());
 
     stmt.doall();
+
+    Scheduler::queueRequest( { dbop, static_cast<int>(reqNumber),
+            Const::UNSET, Const::UNSET, Const::UNSET, poolName, tapeId, "",
+            timeAdded, 0 });
 }
 
 void TapeHandler::execRequest()
@@ -92,6 +97,8 @@ void TapeHandler::execRequest()
         MSG(LTFSDMS0109E, tapeId, poolName);
     }
 
+    Scheduler::completeRequest(reqNum, Const::UNSET, tapeId);
+
     TRACE(Trace::always, driveId, tapeId, poolName);
 
     {
@@ -18,6 +18,7 @@
 
 class TapeHandler
 {
+    friend class DataBase;
 private:
     std::string poolName;
     std::string driveId;
@@ -22,16 +22,21 @@ void TapeMover::addRequest()
 {
     SQLStatement stmt;
     long reqNumber = ++globalReqNumber;
+    time_t timeAdded = time(NULL);
 
     TRACE(Trace::always, op, tapeId, driveId);
 
     stmt(TapeMover::ADD_REQUEST) << op << reqNumber << Const::UNSET << tapeId
-            << driveId << time(NULL) << DataBase::REQ_NEW;
+            << driveId << timeAdded << DataBase::REQ_NEW;
 
     TRACE(Trace::normal, stmt.str());
 
     stmt.doall();
 
+    Scheduler::queueRequest( { static_cast<DataBase::operation>(op),
+            static_cast<int>(reqNumber), Const::UNSET, Const::UNSET,
+            Const::UNSET, "", tapeId, driveId, timeAdded, 0 });
+
     Scheduler::invoke();
 }
 
@@ -66,6 +71,8 @@ void TapeMover::execRequest()
         MSG(LTFSDMS0104E, tapeId);
     }
 
+    Scheduler::completeRequest(reqNum, Const::UNSET, tapeId);
+
     TRACE(Trace::always, driveId, tapeId);
 
     Scheduler::invoke();
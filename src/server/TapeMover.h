@@ -18,6 +18,7 @@
 
 class TapeMover
 {
+    friend class DataBase;
 private:
     std::string driveId;
     std::string tapeId;
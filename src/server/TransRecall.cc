@@ -90,9 +90,9 @@
        job is created within the JOB_QUEUE table and - if it does not exist - a
        request is created within the REQUEST_QUEUE table.
     2. The Scheduler identifies a transparent recall request to get scheduled.
-       The order of files being recalled depends on the starting block of
-       the data files on tape: @snippet server/SQLStatements.cc trans_recall_sql_qry
-       If the transparent recall job is finally processed (even it is failed)
+       The jobs are processed together with all other recall jobs for the
+       same tape in the order of the starting block of the data files on
+       tape (see @ref recall_session). If the transparent recall job is finally processed (even it is failed)
        the event is responded  as a Protocol Buffers message
        (LTFSDmProtocol::LTFSDmTransRecResp).
 
@@ -113,9 +113,9 @@
             label="second phase";
             scheduler [label="Scheduler"];
             subgraph cluster_rec_exec {
-                label="SelRecall::execRequest";
+                label="RecallSession::execRequest";
                 subgraph cluster_proc_files {
-                    label="SelRecall::processFiles";
+                    label="RecallSession::processFiles";
                     rec_exec [label="{read from tape\n\nordered by starting block|respond event}"];
                 }
             }
@@ -143,6 +143,31 @@
     REQUEST_QUEUE table this existing request is used for further
     processing this request/event.
 
+    ## Recall service classes
+
+    If the backend is started with the option <TT>-r &lt;seconds&gt;</TT>
+    a latency target for bulk recalls is set (Scheduler::recallLatency)
+    and transparent recalls are divided into two service classes
+    (TransRecall::recall_class):
+
+    - TransRecall::INTERACTIVE: recalls of processes that only access a
+      few files, e.g. a user opening a single file.
+    - TransRecall::BULK: recalls of processes that caused more than
+      Const::BULK_RECALL_EVENTS recall events within
+      Const::BULK_RECALL_WINDOW seconds, e.g. <TT>find | xargs cat</TT>.
+
+    The process id is provided by the Fuse overlay file system
+    (LTFSDmProtocol::LTFSDmTransRecRequest::pid) and the classification is
+    performed within TransRecall::classify. There is one request per
+    cartridge and service class. Within the scheduler's ready queue
+    interactive requests are placed before bulk requests. Bulk requests
+    do not suspend migrations or selective recalls on a drive
+    (LTFSDMDrive::setToUnblock) unless these have been waiting for longer
+    than the latency target. Thereafter these are treated like interactive
+    requests (SchedulerPolicy::ageRequests) such that bulk recalls cannot
+    starve.
+    Without this option all transparent recalls are interactive.
+
     The second step will not start before the first step is completed. For
     the second step the required tape and drive resources need to be
     available: e.g. a corresponding cartridge is mounted on a tape drive.
@@ -209,6 +234,7 @@
         - change request state to new
     - else
         - create a request within the REQUEST_QUEUE table
+    - add the request to the scheduler's ready queue (Scheduler::queueRequest)
 
     </TT>
 
@@ -222,21 +248,24 @@
     Scheduler::run:
     - if a transparent request is ready do be scheduled:
         - update record in request queue to mark it as DataBase::REQ_INPROGRESS
-        - TransRecall::execRequest
-            - call TransRecall::processFiles
+        - RecallSession::execRequest
+            - take over all other recall requests waiting for the same tape
+              (Scheduler::claimRecalls)
+            - call RecallSession::processFiles
                 - respond recall event Connector::respondRecallEvent
             - if there are outstanding transparent recall requests for the same tape (remaining)
                 - update record in request queue to mark it as DataBase::REQ_NEW
+                - add it to the ready queue again (Scheduler::requeueRequest)
             - else
                 - delete request within the REQUEST_QUEUE table
 
     </TT>
 
-    ### TransRecall::processFiles
+    ### RecallSession::processFiles
 
-    The TransRecall::processFiles method is traversing the JOB_QUEUE table to
-    process individual files for transparent recall. In general the following
-    steps are performed:
+    The RecallSession::processFiles method is traversing the JOB_QUEUE table to
+    process individual files for transparent recall. For the jobs of a
+    transparent recall request the following steps are performed:
 
     -# All corresponding jobs are changed to FsObj::RECALLING_MIG or FsObj::RECALLING_PREMIG
        depending if it is called for files in migrated or in premigrated state. The following
@@ -300,7 +329,7 @@
  */
 
 void TransRecall::addJob(Connector::rec_info_t recinfo, std::string tapeId,
-        long reqNum)
+        long reqNum, int recClass)
 
 {
     struct stat statbuf;
@@ -308,14 +337,8 @@ void TransRecall::addJob(Connector::rec_info_t recinfo, std::string tapeId,
     std::string tapeName;
     int state;
     FsObj::mig_target_attr_t attr;
-    std::string filename;
     bool reqExists = false;
 
-    if (recinfo.filename.compare("") == 0)
-        filename = "NULL";
-    else
-        filename = std::string("'") + recinfo.filename + "'";
-
     try {
         FsObj fso(recinfo);
         statbuf = fso.stat();
@@ -335,30 +358,32 @@ void TransRecall::addJob(Connector::rec_info_t recinfo, std::string tapeId,
 
         attr = fso.getAttribute();
 
+        if (state == FsObj::MIGRATED)
+            inventory->addRecall(tapeId);
+
         tapeName = Server::getTapeName(recinfo.fuid.fsid_h, recinfo.fuid.fsid_l,
                 recinfo.fuid.igen, recinfo.fuid.inum, tapeId);
     } catch (const std::exception& e) {
         TRACE(Trace::error, e.what());
-        if (filename.compare("NULL") != 0)
-            MSG(LTFSDMS0073E, filename);
+        if (recinfo.filename.compare("") != 0)
+            MSG(LTFSDMS0073E, recinfo.filename);
         else
             MSG(LTFSDMS0032E, recinfo.fuid.inum);
     }
 
-    stmt(TransRecall::ADD_JOB) << DataBase::TRARECALL << filename.c_str()
-            << reqNum
-            << (recinfo.toresident ? FsObj::RESIDENT : FsObj::PREMIGRATED)
-            << Const::UNSET << statbuf.st_size << recinfo.fuid.fsid_h
-            << recinfo.fuid.fsid_l << recinfo.fuid.igen << recinfo.fuid.inum
-            << statbuf.st_mtime << 0 << time(NULL) << state << tapeId
-            << attr.tapeInfo[0].startBlock << (std::intptr_t) recinfo.conn_info;
-
-    TRACE(Trace::normal, stmt.str());
-
-    stmt.doall();
-
-    if (filename.compare("NULL") != 0)
-        TRACE(Trace::always, filename);
+    jobStore->addJob(
+            (JobStore::job_t ) { DataBase::TRARECALL, recinfo.filename,
+                            static_cast<int>(reqNum),
+                            (recinfo.toresident ?
+                                    FsObj::RESIDENT : FsObj::PREMIGRATED),
+                            Const::UNSET, "", statbuf.st_size, recinfo.fuid,
+                            statbuf.st_mtime, 0,
+                            static_cast<FsObj::file_state>(state), tapeId,
+                            attr.tapeInfo[0].startBlock,
+                            (std::intptr_t) recinfo.conn_info });
+
+    if (recinfo.filename.compare("") != 0)
+        TRACE(Trace::always, recinfo.filename);
     else
         TRACE(Trace::always, recinfo.fuid.inum);
 
@@ -375,43 +400,81 @@ void TransRecall::addJob(Connector::rec_info_t recinfo, std::string tapeId,
                 << tapeId;
         TRACE(Trace::normal, stmt.str());
         stmt.doall();
+        Scheduler::queueRequest( { DataBase::TRARECALL,
+                static_cast<int>(reqNum), Const::UNSET, Const::UNSET,
+                Const::UNSET, "", tapeId, "", time(NULL), 0, recClass,
+                false });
         Scheduler::invoke();
     } else {
+        time_t timeAdded = time(NULL);
         stmt(TransRecall::ADD_REQUEST) << DataBase::TRARECALL << reqNum
-                << Const::UNSET << attr.tapeInfo[0].tapeId << time(NULL)
+                << Const::UNSET << attr.tapeInfo[0].tapeId << timeAdded
                 << DataBase::REQ_NEW;
         TRACE(Trace::normal, stmt.str());
         stmt.doall();
+        Scheduler::queueRequest( { DataBase::TRARECALL,
+                static_cast<int>(reqNum), Const::UNSET, Const::UNSET,
+                Const::UNSET, "", attr.tapeInfo[0].tapeId, "", timeAdded, 0,
+                recClass, false });
         Scheduler::invoke();
     }
 }
 
+TransRecall::recall_class TransRecall::classify(pid_t pid)
+
+{
+    time_t now = time(NULL);
+    std::map<pid_t, pid_events_t>::iterator it;
+
+    if (Scheduler::recallLatency == 0 || pid == 0)
+        return TransRecall::INTERACTIVE;
+
+    if (pidEvents.size() > Const::MAX_TRANSPARENT_RECALL_THREADS) {
+        for (it = pidEvents.begin(); it != pidEvents.end();) {
+            if (now - it->second.windowStart >= Const::BULK_RECALL_WINDOW)
+                it = pidEvents.erase(it);
+            else
+                ++it;
+        }
+    }
+
+    pid_events_t& events = pidEvents[pid];
+
+    if (now - events.windowStart >= Const::BULK_RECALL_WINDOW)
+        events = (pid_events_t ) { now, 0 };
+
+    if (++events.numEvents > Const::BULK_RECALL_EVENTS)
+        return TransRecall::BULK;
+    else
+        return TransRecall::INTERACTIVE;
+}
+
 void TransRecall::cleanupEvents()
 
 {
-    Connector::rec_info_t recinfo;
-    SQLStatement stmt = SQLStatement(TransRecall::REMAINING_JOBS)
-            << DataBase::TRARECALL;
-    TRACE(Trace::normal, stmt.str());
-    stmt.prepare();
-    while (stmt.step(&recinfo.fuid.fsid_h, &recinfo.fuid.fsid_l,
-            &recinfo.fuid.igen, &recinfo.fuid.inum, &recinfo.filename,
-            (std::intptr_t *) &recinfo.conn_info)) {
+    jobStore->selectTransRecalls([](const JobStore::rec_job_t& job) {
+        Connector::rec_info_t recinfo;
+
+        recinfo.conn_info = (struct conn_info_t *) job.connInfo;
+        recinfo.fuid = job.fuid;
+        recinfo.filename = job.fileName;
         TRACE(Trace::always, recinfo.filename, recinfo.fuid.inum);
         Connector::respondRecallEvent(recinfo, false);
-    }
-    stmt.finalize();
+        return true;
+    });
 }
 
 void TransRecall::run(std::shared_ptr<Connector> connector)
 
 {
-    ThreadPool<TransRecall, Connector::rec_info_t, std::string, long> wqr(
+    ThreadPool<TransRecall, Connector::rec_info_t, std::string, long, int> wqr(
             &TransRecall::addJob, Const::MAX_TRANSPARENT_RECALL_THREADS,
             "trec-wq");
     Connector::rec_info_t recinfo;
-    std::map<std::string, long> reqmap;
+    std::map<std::pair<std::string, int>, long> reqmap;
+    std::pair<std::string, int> reqkey;
     std::string tapeId;
+    recall_class recClass;
 
     try {
         connector->initTransRecalls();
@@ -503,13 +566,17 @@ void TransRecall::run(std::shared_ptr<Connector> connector)
         std::stringstream thrdinfo;
         thrdinfo << "TrRec(" << recinfo.fuid.inum << ")";
 
-        if (reqmap.count(tapeId) == 0)
-            reqmap[tapeId] = ++globalReqNumber;
+        recClass = classify(recinfo.pid);
+        reqkey = std::make_pair(tapeId, recClass);
 
-        TRACE(Trace::always, recinfo.fuid.inum, tapeId, reqmap[tapeId]);
+        if (reqmap.count(reqkey) == 0)
+            reqmap[reqkey] = ++globalReqNumber;
+
+        TRACE(Trace::always, recinfo.fuid.inum, tapeId, recinfo.pid, recClass,
+                reqmap[reqkey]);
 
         wqr.enqueue(Const::UNSET, TransRecall(), recinfo, tapeId,
-                reqmap[tapeId]);
+                reqmap[reqkey], recClass);
     }
 
     MSG(LTFSDMS0083I);
@@ -526,11 +593,10 @@ unsigned long TransRecall::recall(Connector::rec_info_t recinfo,
     struct stat statbuf;
     struct stat statbuf_tape;
     std::string tapeName;
-    char buffer[Const::READ_BUFFER_SIZE];
     long rsize;
-    long wsize;
     int fd = -1;
     long offset = 0;
+    long memberOffset;
     FsObj::file_state curstate;
 
     try {
@@ -552,6 +618,7 @@ unsigned long TransRecall::recall(Connector::rec_info_t recinfo,
             tapeName = Server::getTapeName(recinfo.fuid.fsid_h,
                     recinfo.fuid.fsid_l, recinfo.fuid.igen, recinfo.fuid.inum,
                     tapeId);
+            memberOffset = Server::getMemberOffset(&target, tapeId, &tapeName);
             fd = Server::openTapeRetry(tapeId, tapeName.c_str(),
             O_RDWR | O_CLOEXEC);
 
@@ -563,7 +630,16 @@ unsigned long TransRecall::recall(Connector::rec_info_t recinfo,
 
             statbuf = target.stat();
 
-            if (fstat(fd, &statbuf_tape) == 0
+            if (memberOffset != Const::UNSET) {
+                if (fstat(fd, &statbuf_tape) == -1
+                        || statbuf_tape.st_size < memberOffset + statbuf.st_size
+                        || lseek(fd, memberOffset, SEEK_SET) != memberOffset) {
+                    TRACE(Trace::error, errno, memberOffset);
+                    MSG(LTFSDMS0128E, recinfo.fuid.inum, tapeName.c_str());
+                    THROW(Error::GENERAL_ERROR, recinfo.fuid.inum,
+                            memberOffset);
+                }
+            } else if (fstat(fd, &statbuf_tape) == 0
                     && statbuf_tape.st_size != statbuf.st_size) {
                 if (recinfo.filename.size() != 0)
                     MSG(LTFSDMS0097W, recinfo.filename, statbuf.st_size,
@@ -577,26 +653,21 @@ unsigned long TransRecall::recall(Connector::rec_info_t recinfo,
 
             target.prepareRecall();
 
+            DataMover mover(inventory->getBlockSize());
+
             while (offset < statbuf.st_size) {
                 if (Server::forcedTerminate)
                     THROW(Error::GENERAL_ERROR, tapeName);
 
-                rsize = read(fd, buffer, sizeof(buffer));
-                if (rsize == 0) {
+                rsize = mover.fromTape(fd, &target, offset,
+                        statbuf.st_size - offset);
+                if (rsize == 0)
                     break;
-                }
+
                 if (rsize == -1) {
                     TRACE(Trace::error, errno);
-                    MSG(LTFSDMS0023E, tapeName.c_str());
-                    THROW(Error::GENERAL_ERROR, tapeName, errno);
-                }
-                wsize = target.write(offset, (unsigned long) rsize, buffer);
-                if (wsize != rsize) {
-                    TRACE(Trace::error, errno, wsize, rsize);
-                    MSG(LTFSDMS0033E, recinfo.fuid.inum);
-                    close(fd);
-                    THROW(Error::GENERAL_ERROR, recinfo.fuid.inum, wsize,
-                            rsize);
+                    MSG(LTFSDMS0126E, tapeName.c_str());
+                    THROW(Error::GENERAL_ERROR, recinfo.fuid.inum, errno);
                 }
                 offset += rsize;
             }
@@ -616,110 +687,3 @@ unsigned long TransRecall::recall(Connector::rec_info_t recinfo,
 
     return statbuf.st_size;
 }
-
-void TransRecall::processFiles(int reqNum, std::string tapeId)
-
-{
-    Connector::rec_info_t recinfo;
-    SQLStatement stmt;
-    FsObj::file_state state;
-    FsObj::file_state toState;
-    struct respinfo_t
-    {
-        Connector::rec_info_t recinfo;bool succeeded;
-    };
-    std::list<respinfo_t> resplist;
-    int numFiles = 0;
-    bool succeeded;
-
-    stmt(TransRecall::SET_RECALLING) << FsObj::RECALLING_MIG << reqNum
-            << FsObj::MIGRATED << tapeId;
-    TRACE(Trace::normal, stmt.str());
-    stmt.doall();
-
-    stmt(TransRecall::SET_RECALLING) << FsObj::RECALLING_PREMIG << reqNum
-            << FsObj::PREMIGRATED << tapeId;
-    TRACE(Trace::normal, stmt.str());
-    stmt.doall();
-
-    stmt(TransRecall::SELECT_JOBS) << reqNum << FsObj::RECALLING_MIG
-            << FsObj::RECALLING_PREMIG << tapeId;
-    TRACE(Trace::normal, stmt.str());
-    stmt.prepare();
-    while (stmt.step(&recinfo.fuid.fsid_h, &recinfo.fuid.fsid_l,
-            &recinfo.fuid.igen, &recinfo.fuid.inum, &recinfo.filename, &state,
-            &toState, (std::intptr_t *) &recinfo.conn_info)) {
-        numFiles++;
-
-        if (state == FsObj::RECALLING_MIG)
-            state = FsObj::MIGRATED;
-        else
-            state = FsObj::PREMIGRATED;
-
-        if (toState == FsObj::RESIDENT)
-            recinfo.toresident = true;
-
-        TRACE(Trace::always, recinfo.filename, recinfo.fuid.inum, state,
-                toState);
-
-        try {
-            recall(recinfo, tapeId, state, toState);
-            succeeded = true;
-        } catch (const std::exception& e) {
-            TRACE(Trace::error, e.what());
-            succeeded = false;
-        }
-
-        TRACE(Trace::always, succeeded);
-        resplist.push_back((respinfo_t ) { recinfo, succeeded });
-    }
-    stmt.finalize();
-    TRACE(Trace::always, numFiles);
-
-    stmt(TransRecall::DELETE_JOBS) << reqNum << FsObj::RECALLING_MIG
-            << FsObj::RECALLING_PREMIG << tapeId;
-    TRACE(Trace::normal, stmt.str());
-    stmt.doall();
-
-    for (respinfo_t respinfo : resplist)
-        Connector::respondRecallEvent(respinfo.recinfo, respinfo.succeeded);
-}
-
-void TransRecall::execRequest(int reqNum, std::string driveId,
-        std::string tapeId)
-
-{
-    SQLStatement stmt;
-    int remaining = 0;
-
-    TRACE(Trace::always, reqNum, tapeId);
-
-    processFiles(reqNum, tapeId);
-
-    {
-        std::lock_guard<std::recursive_mutex> inventorylock(
-                LTFSDMInventory::mtx);
-        if (inventory->getCartridge(tapeId)->getState()
-                == LTFSDMCartridge::TAPE_INUSE)
-            inventory->getCartridge(tapeId)->setState(
-                    LTFSDMCartridge::TAPE_MOUNTED);
-
-        inventory->getDrive(driveId)->setFree();
-    }
-
-    stmt(TransRecall::COUNT_REMAINING_JOBS) << reqNum << tapeId;
-    TRACE(Trace::normal, stmt.str());
-    stmt.prepare();
-    while (stmt.step(&remaining)) {
-    }
-    stmt.finalize();
-
-    if (remaining)
-        stmt(TransRecall::CHANGE_REQUEST_TO_NEW) << DataBase::REQ_NEW << reqNum
-                << tapeId;
-    else
-        stmt(TransRecall::DELETE_REQUEST) << reqNum << tapeId;
-    TRACE(Trace::normal, stmt.str());
-    stmt.doall();
-    Scheduler::invoke();
-}
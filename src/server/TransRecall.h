@@ -19,19 +19,25 @@
 class TransRecall
 
 {
+    friend class DataBase;
+public:
+    enum recall_class
+    {
+        INTERACTIVE, BULK
+    };
 private:
-    static const std::string ADD_JOB;
+    struct pid_events_t
+    {
+        time_t windowStart;
+        int numEvents;
+    };
+    std::map<pid_t, pid_events_t> pidEvents;
+
+    recall_class classify(pid_t pid);
+
     static const std::string CHECK_REQUEST_EXISTS;
     static const std::string CHANGE_REQUEST_TO_NEW;
     static const std::string ADD_REQUEST;
-    static const std::string REMAINING_JOBS;
-    static const std::string SET_RECALLING;
-    static const std::string SELECT_JOBS;
-    static const std::string DELETE_JOBS;
-    static const std::string COUNT_REMAINING_JOBS;
-    static const std::string DELETE_REQUEST;
-
-    void processFiles(int reqNum, std::string tapeId);
 public:
     TransRecall()
     {
@@ -39,12 +45,11 @@ public:
     ~TransRecall()
     {
     }
-    void addJob(Connector::rec_info_t recinfo, std::string tapeId, long reqNum);
+    void addJob(Connector::rec_info_t recinfo, std::string tapeId, long reqNum,
+            int recClass);
     void cleanupEvents();
     void run(std::shared_ptr<Connector> connector);
     static unsigned long recall(Connector::rec_info_t recinfo,
             std::string tapeId, FsObj::file_state state,
             FsObj::file_state toState);
-
-    void execRequest(int reqNum, std::string driveId, std::string tapeId);
 };
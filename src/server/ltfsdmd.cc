@@ -29,7 +29,7 @@
     the
 
     @verbatim
-    ltfsdmd [-f] [-m] [-d <debug level>]
+    ltfsdmd [-f] [-m] [-d <debug level>] [-t <seconds>] [-r <seconds>] [-p] [-j <file>] [-c] [-a <bytes>] [-l]
     @endverbatim
 
     command.
@@ -41,6 +41,13 @@
     -f | Start the backend in foreground. Messages will be printed out to stdout.
     -m | Store the SQLite database in memory. By default it is stored in "/var/run" which usually is memory mapped.
     -d | Use a different trace level. See @ref tracing_system "tracing" for details of trace levels.
+    -t | Minimum dwell time of mounted cartridges in seconds. See @ref scheduler "Scheduler".
+    -r | Latency target of bulk transparent recalls in seconds. See @ref transparent_recall "transparent recall".
+    -p | Pre-mount cartridges that have been used for recalls frequently. See @ref scheduler "Scheduler".
+    -j | Keep the jobs within the given file and resume unfinished migration and selective recall requests at startup. Cannot be combined with -m. See @ref sqlite "SQLite".
+    -c | Keep the jobs in memory column by column instead of within the SQLite database. Cannot be combined with -j. See @ref job_store "job store".
+    -a | Aggregate files smaller than the given number of bytes into container files on tape. See @ref tape_container "TapeContainer".
+    -l | Create the symbolic links on tape for all files of a migration session at the end of the session instead of after each file.
 
     ## Server components
 
@@ -130,8 +137,7 @@
     function | description
     ---|---
     Migration::execRequest | schedules a migration request
-    SelRecall::execRequest | schedules a selective recall request
-    TransRecall::execRequest | schedules a transparent recall request
+    RecallSession::execRequest | schedules selective and transparent recall requests for a tape
 
     For each of these threads there will be an additional waiter thread.
 
@@ -155,8 +161,7 @@
         Server::wqs (1 thread pool)
         Scheduler::run (1 thread)
             Migration::execRequest (number of thread less or equal number of drives)
-            SelRecall::execRequest (number of thread less or equal number of drives)
-            TransRecall::execRequest (number of thread less or equal number of drives)
+            RecallSession::execRequest (number of thread less or equal number of drives)
         Server::signalHandler (1 thread)
         Receiver::run (1 thread)
             Receiver::run -> wqm (1 thread pool)
@@ -187,6 +192,10 @@
 
     - @subpage transparent_recall
 
+    Selective and transparent recalls for the same tape are processed together:
+
+    - @subpage recall_session
+
     ## The startup sequence
 
     During the startup initialization is done and threads are started for
@@ -323,6 +332,8 @@ int main(int argc, char **argv)
     int opt;
     sigset_t set;
     bool dbUseMemory = false;
+    std::string dbFile = "";
+    bool columnJobs = false;
     Trace::traceLevel tl = Trace::error;
 
     opterr = 0;
@@ -333,7 +344,7 @@ int main(int argc, char **argv)
     }
 
     //! [option processing]
-    while ((opt = getopt(argc, argv, "fmd:")) != -1) {
+    while ((opt = getopt(argc, argv, "fmd:t:r:pj:ca:l")) != -1) {
         switch (opt) {
             case 'f':
                 detach = false;
@@ -349,6 +360,50 @@ int main(int argc, char **argv)
                     tl = Trace::error;
                 }
                 break;
+            case 't':
+                // minimum dwell time of mounted tapes in seconds
+                try {
+                    Scheduler::minDwellTime = std::stoi(optarg);
+                } catch (const std::exception& e) {
+                    std::cerr << ltfsdm_messages[LTFSDMC0013E] << std::endl;
+                    err = static_cast<int>(Error::GENERAL_ERROR);
+                    goto end;
+                }
+                break;
+            case 'r':
+                // latency target of bulk transparent recalls in seconds
+                try {
+                    Scheduler::recallLatency = std::stoi(optarg);
+                } catch (const std::exception& e) {
+                    std::cerr << ltfsdm_messages[LTFSDMC0013E] << std::endl;
+                    err = static_cast<int>(Error::GENERAL_ERROR);
+                    goto end;
+                }
+                break;
+            case 'p':
+                Scheduler::premountHot = true;
+                break;
+            case 'j':
+                // file of the persistent job store
+                dbFile = optarg;
+                break;
+            case 'c':
+                // in-memory job store
+                columnJobs = true;
+                break;
+            case 'a':
+                // files below this size are aggregated into containers
+                try {
+                    TapeContainer::threshold = std::stoul(optarg);
+                } catch (const std::exception& e) {
+                    std::cerr << ltfsdm_messages[LTFSDMC0013E] << std::endl;
+                    err = static_cast<int>(Error::GENERAL_ERROR);
+                    goto end;
+                }
+                break;
+            case 'l':
+                Server::lazyLinks = true;
+                break;
             default:
                 std::cerr << ltfsdm_messages[LTFSDMC0013E] << std::endl;
                 err = static_cast<int>(Error::GENERAL_ERROR);
@@ -357,6 +412,12 @@ int main(int argc, char **argv)
     }
     //! [option processing]
 
+    if ((dbUseMemory || columnJobs) && dbFile.compare("") != 0) {
+        std::cerr << ltfsdm_messages[LTFSDMC0013E] << std::endl;
+        err = static_cast<int>(Error::GENERAL_ERROR);
+        goto end;
+    }
+
     //! [setup signals]
     sigemptyset(&set);
     sigaddset(&set, SIGQUIT);
@@ -379,7 +440,7 @@ int main(int argc, char **argv)
     MSG(LTFSDMX0029I, LTFSDM_VERSION);
 
     try {
-        ltfsdmd.initialize(dbUseMemory);
+        ltfsdmd.initialize(dbUseMemory, dbFile, columnJobs);
 
         if (detach)
             ltfsdmd.daemonize();
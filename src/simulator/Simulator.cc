@@ -0,0 +1,783 @@
+/*******************************************************************************
+ * Copyright 2018 IBM Corp. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *******************************************************************************/
+#include <sys/resource.h>
+#include <limits.h>
+#include <math.h>
+
+#include <string>
+#include <list>
+#include <vector>
+#include <map>
+#include <set>
+#include <tuple>
+#include <memory>
+#include <functional>
+#include <random>
+#include <chrono>
+#include <algorithm>
+
+#include "src/common/Const.h"
+#include "src/server/SchedulerPolicy.h"
+
+#include "Simulator.h"
+
+/** @page simulator Scheduler simulator
+
+    # Simulator
+
+    The simulator <TT>ltfsdmsim</TT> replays a stream of migration,
+    selective recall, and transparent recall requests against a simulated
+    tape library without the need of tape hardware, Spectrum Archive LE,
+    or a managed file system. It is used to evaluate changes of the
+    scheduling policy and to tune the scheduling options for a given
+    workload.
+
+    The library consists of a number of drives and of cartridges that are
+    assigned to tape storage pools. Mounting and unmounting a cartridge,
+    locating to a file, and transferring data take simulated time. The time
+    to locate is proportional to the distance between two files on tape
+    where the time for the whole tape length can be specified. The
+    position of a recalled file on tape is chosen randomly.
+
+    The simulation is event driven (Simulator::run). After each event
+    (arrival of a request, a mount or unmount completed, a file
+    transferred) the scheduling pass of the backend is performed
+    (SchedulerPolicy::schedule, see @ref scheduler):
+
+    - the ready queue is ordered by operation, service class, and the time
+      a request has been added (SchedulerPolicy::queueKey)
+    - with a minimum dwell time the requests for mounted cartridges are
+      considered first unless a more important request waits for a drive
+      and cartridges with pending work are not unmounted before the dwell
+      time has passed (SchedulerPolicy::selectUnmount)
+    - drive limits per pool and operation
+      (SchedulerPolicy::driveLimitReached)
+    - a migration request for a pool is processed in parallel on several
+      cartridges, each session gets its share of the files
+      (SchedulerPolicy::migrationShare)
+    - a recall session processes all recall requests for a cartridge
+      within one sweep ordered by the position on tape
+      (Simulator::startRecall)
+    - transparent recalls are classified as interactive or bulk by
+      process id and bulk recalls are aged with the recall latency target
+      (Simulator::classify, SchedulerPolicy::needsAging)
+    - a recall with a higher priority suspends a migration or a selective
+      recall on a drive (SchedulerPolicy::tapeResAvail)
+    - cartridges with a high recall score are mounted in advance on empty
+      or idle drives if nothing else is to be scheduled
+      (SchedulerPolicy::premount)
+
+    The scheduling pass is the same code as within the backend:
+    SchedulerPolicy (src/server/SchedulerPolicy.cc) is linked into both,
+    ltfsdmd and ltfsdmsim. It accesses the ready queue, the drives, and the
+    cartridges by the SchedulerPolicy::Resources interface that is
+    implemented by the Scheduler for the inventory and by the Simulator for
+    the simulated library. The remaining parts of the backend require
+    Spectrum Archive LE and file systems and are not linked: the tape
+    moves, the recall sweeps, the processing of suspended requests, and the
+    classification of transparent recalls follow the corresponding
+    TapeMover, TransRecall, and RecallSession methods. As a difference to
+    the backend migrations are suspended at file boundaries rather than
+    after a chunk of data.
+
+    After all requests are processed the following information is reported:
+
+    - the number of tape mounts and unmounts and how many of the mounts
+      have been pre-mounts
+    - the utilization of each drive: transferring data, locating, and moving
+      cartridges
+    - the latency percentiles of transparent recalls (per file and service
+      class), of selective recall requests, and of migration requests
+
+    ## Usage
+
+    @verbatim
+    ltfsdmsim [-d <drives>] [-p <pool>:<number of cartridges>|<tape id>[,<tape id>…]] …
+              [-c <capacity GB>] [-m <mount time>] [-u <unmount time>]
+              [-s <locate time>] [-b <MB/s>] [-t <dwell time>] [-r <latency>] [-P]
+              [-l <pool>:migration|recall:<min drives>:<max drives>] …
+              -w <workload file> | -g <seed> [-D <duration>] [-H <hot cartridges>] [-o <workload file>]
+    @endverbatim
+
+    The options <TT>-t</TT>, <TT>-r</TT>, <TT>-P</TT> (<TT>-p</TT> of the
+    backend), and <TT>-l</TT> correspond to the backend options and the @ref ltfsdm_pool_limit "ltfsdm pool limit"
+    command. Times are provided in seconds.
+
+    A workload file contains one request per line, ordered by time:
+
+    @verbatim
+    # <time> migrate <pool> <number of files> <file size MB>
+    0 migrate pool1 500 1024
+    # <time> recall <tape id> <number of files> <file size MB>
+    60 recall pool1-3 20 1024
+    # <time> trecall <tape id> <file size MB> <process id>
+    75.5 trecall pool1-7 100 4711
+    @endverbatim
+
+    With the option <TT>-g</TT> a synthetic workload is generated for the
+    duration specified by <TT>-D</TT>. It consists of migrations,
+    selective recalls, interactive transparent recalls, and bursts of
+    transparent recalls of a single process. With <TT>-H</TT> half of the
+    interactive transparent recalls go to the specified number of hot
+    cartridges. The generated workload can be written with <TT>-o</TT> to
+    be replayed with different options.
+
+    The test test/test11.py runs the simulator for a couple of generated
+    workloads and fails if the 99th percentile of interactive transparent
+    recalls gets worse with a minimum dwell time. The test test/test12.py
+    checks that pre-mounting hot cartridges saves tape mounts without
+    increasing the recall latency if there are more drives than needed
+    for the regular workload.
+ */
+
+Simulator::Simulator(config_t _conf) :
+        conf(_conf), stats( { }), now(0), seq(0), nextReqNum(1), rng(0)
+
+{
+    policy.minDwellTime = conf.minDwellTime;
+    policy.recallLatency = conf.recallLatency;
+    policy.premountHot = conf.premountHot;
+    policy.limits = conf.limits;
+
+    stats.drives.resize(conf.numDrives);
+
+    for (int i = 0; i < conf.numDrives; i++)
+        drives.push_back(
+                (drive_t ) { "", false, Const::UNSET, "", NOOP, std::make_pair(
+                        "", Const::UNSET) });
+
+    for (std::pair<std::string, std::list<std::string>> pool : conf.pools)
+        for (std::string tapeId : pool.second)
+            carts[tapeId] = (cart_t ) { pool.first, UNMOUNTED, Const::UNSET, 0,
+                    conf.capacity, false, 0, 0 };
+}
+
+void Simulator::at(double time, std::function<void()> func)
+
+{
+    events[std::make_pair(time, seq++)] = func;
+}
+
+SchedulerPolicy::queuekey_t Simulator::queueKey(const request_t& req)
+
+{
+    return SchedulerPolicy::queueKey(req.op, req.recClass, req.aged,
+            req.timeAdded, req.reqNum, 0, req.tapeId);
+}
+
+void Simulator::queueRequest(int reqNum)
+
+{
+    request_t& req = requests[reqNum];
+
+    if (req.queued)
+        return;
+
+    readyQueue.insert(queueKey(req));
+    req.queued = true;
+}
+
+void Simulator::unqueueRequest(int reqNum)
+
+{
+    request_t& req = requests[reqNum];
+
+    if (!req.queued)
+        return;
+
+    readyQueue.erase(queueKey(req));
+    req.queued = false;
+}
+
+void Simulator::completeRequest(int reqNum)
+
+{
+    request_t& req = requests[reqNum];
+    std::map<std::pair<std::string, int>, int>::iterator it;
+
+    unqueueRequest(reqNum);
+
+    switch (req.op) {
+        case MIGRATION:
+            stats.migrationLatency.push_back(now - req.arrival);
+            break;
+        case SELRECALL:
+            stats.selRecallLatency.push_back(now - req.arrival);
+            break;
+        default:
+            it = openRecalls.find(std::make_pair(req.tapeId, req.recClass));
+            if (it != openRecalls.end() && it->second == reqNum)
+                openRecalls.erase(it);
+    }
+
+    requests.erase(reqNum);
+}
+
+Simulator::recall_class Simulator::classify(int pid)
+
+{
+    if (conf.recallLatency == 0 || pid == 0)
+        return INTERACTIVE;
+
+    std::pair<double, int>& window = pidEvents[pid];
+
+    if (now - window.first >= Const::BULK_RECALL_WINDOW)
+        window = std::make_pair(now, 0);
+
+    if (++window.second > Const::BULK_RECALL_EVENTS)
+        return BULK;
+    else
+        return INTERACTIVE;
+}
+
+void Simulator::addRecall(const std::string& tapeId)
+
+{
+    cart_t& cart = carts[tapeId];
+
+    // see LTFSDMInventory::addRecall
+    if (cart.recallScore > 0
+            && now - cart.lastRecall < Const::BULK_RECALL_WINDOW)
+        return;
+
+    cart.recallScore = getRecallScore(tapeId) + 1;
+    cart.lastRecall = now;
+}
+
+double Simulator::getRecallScore(std::string tapeId)
+
+{
+    cart_t& cart = carts[tapeId];
+
+    return cart.recallScore
+            * pow(0.5,
+                    (now - cart.lastRecall) / Const::RECALL_HISTORY_HALF_LIFE);
+}
+
+void Simulator::arrival(event_t event)
+
+{
+    std::uniform_real_distribution<double> position(0, 1);
+    std::map<std::pair<std::string, int>, int>::iterator it;
+    request_t req;
+    int recClass;
+
+    if (event.op != MIGRATION)
+        addRecall(event.target);
+
+    if (event.op == TRARECALL) {
+        recClass = classify(event.pid);
+        it = openRecalls.find(std::make_pair(event.target, recClass));
+        if (it != openRecalls.end()) {
+            requests[it->second].files.push_back(
+                    (file_t ) { it->second, event.size, position(rng), now,
+                                    recClass });
+            return;
+        }
+    } else {
+        recClass = INTERACTIVE;
+    }
+
+    req = (request_t ) { event.op, nextReqNum++, recClass, false, now, now,
+            "", "", { }, 0, false };
+
+    if (event.op == MIGRATION)
+        req.pool = event.target;
+    else
+        req.tapeId = event.target;
+
+    for (int i = 0; i < event.numFiles; i++)
+        req.files.push_back(
+                (file_t ) { req.reqNum, event.size, position(rng), now,
+                                recClass });
+
+    requests[req.reqNum] = req;
+    if (event.op == TRARECALL)
+        openRecalls[std::make_pair(event.target, recClass)] = req.reqNum;
+
+    queueRequest(req.reqNum);
+}
+
+unsigned long Simulator::minFileSize(const request_t& req)
+
+{
+    unsigned long min = ULONG_MAX;
+
+    for (const file_t& file : req.files)
+        if (file.size < min)
+            min = file.size;
+
+    return min;
+}
+
+bool Simulator::isMounted(int drive)
+
+{
+    return (drives[drive].tapeId.compare("") != 0
+            && carts[drives[drive].tapeId].state == MOUNTED);
+}
+
+void Simulator::moveTape(int drive, std::string tapeId, bool mount,
+        int reqNum, std::string pool)
+
+{
+    for (drive_t& d : drives)
+        if (d.moveReqNum == reqNum && d.moveReqPool.compare(pool) == 0)
+            return;
+
+    drives[drive].moveReqNum = reqNum;
+    drives[drive].moveReqPool = pool;
+    drives[drive].busy = true;
+    carts[tapeId].state = MOVING;
+
+    if (mount) {
+        stats.mounts++;
+        stats.drives[drive].move += conf.mountTime;
+        at(now + conf.mountTime, [this, drive, tapeId]() {
+            drives[drive].tapeId = tapeId;
+            drives[drive].busy = false;
+            drives[drive].moveReqNum = Const::UNSET;
+            drives[drive].moveReqPool = "";
+            carts[tapeId].state = MOUNTED;
+            carts[tapeId].drive = drive;
+            carts[tapeId].mountTime = now;
+        });
+    } else {
+        stats.unmounts++;
+        stats.drives[drive].move += conf.unmountTime;
+        at(now + conf.unmountTime, [this, drive, tapeId]() {
+            drives[drive].tapeId = "";
+            drives[drive].busy = false;
+            drives[drive].moveReqNum = Const::UNSET;
+            drives[drive].moveReqPool = "";
+            carts[tapeId].state = UNMOUNTED;
+            carts[tapeId].drive = Const::UNSET;
+        });
+    }
+}
+
+bool Simulator::nextRequest(SchedulerPolicy::request_t *req, bool first)
+
+{
+    std::set<SchedulerPolicy::queuekey_t>::iterator it;
+
+    if (first)
+        it = readyQueue.begin();
+    else
+        it = readyQueue.upper_bound(
+                SchedulerPolicy::queueKey(req->op, req->recClass, req->aged,
+                        req->timeAdded, req->reqNum, req->replNum,
+                        req->tapeId));
+
+    if (it == readyQueue.end())
+        return false;
+
+    request_t& next = requests[std::get<3>(*it)];
+
+    *req = (SchedulerPolicy::request_t ) { next.op, next.reqNum, 0, next.pool,
+                    next.tapeId, "", next.timeAdded, minFileSize(next),
+                    next.recClass, next.aged };
+
+    return true;
+}
+
+void Simulator::setAged(const SchedulerPolicy::request_t& req)
+
+{
+    unqueueRequest(req.reqNum);
+    requests[req.reqNum].aged = true;
+    queueRequest(req.reqNum);
+}
+
+int Simulator::pendingWork(std::string tapeId,
+        SchedulerPolicy::priority_t minPriority)
+
+{
+    int pending = 0;
+
+    for (const SchedulerPolicy::queuekey_t& key : readyQueue) {
+        request_t& req = requests[std::get<3>(key)];
+        if (SchedulerPolicy::priority(req.op, req.recClass, req.aged)
+                > minPriority)
+            continue;
+        if (req.tapeId.compare(tapeId) == 0
+                || (req.tapeId.compare("") == 0
+                        && req.pool.compare(carts[tapeId].pool) == 0))
+            pending++;
+    }
+
+    return pending;
+}
+
+std::map<std::string, SchedulerPolicy::limitkey_t> Simulator::getUsedDrives()
+
+{
+    std::map<std::string, SchedulerPolicy::limitkey_t> usedDrives;
+
+    for (int drive = 0; drive < conf.numDrives; drive++)
+        if (drives[drive].usedBy.second != Const::UNSET)
+            usedDrives[std::to_string(drive)] = drives[drive].usedBy;
+
+    return usedDrives;
+}
+
+std::list<std::string> Simulator::getDriveIds()
+
+{
+    std::list<std::string> driveIds;
+
+    for (int drive = 0; drive < conf.numDrives; drive++)
+        driveIds.push_back(std::to_string(drive));
+
+    return driveIds;
+}
+
+bool Simulator::driveIsBusy(std::string driveId)
+
+{
+    return drives[std::stoi(driveId)].busy;
+}
+
+int Simulator::getMoveReqNum(std::string driveId)
+
+{
+    return drives[std::stoi(driveId)].moveReqNum;
+}
+
+std::string Simulator::getMoveReqPool(std::string driveId)
+
+{
+    return drives[std::stoi(driveId)].moveReqPool;
+}
+
+std::string Simulator::getMountedCartridge(std::string driveId)
+
+{
+    int drive = std::stoi(driveId);
+
+    if (isMounted(drive) == false)
+        return "";
+
+    return drives[drive].tapeId;
+}
+
+int Simulator::getToUnblock(std::string driveId)
+
+{
+    return drives[std::stoi(driveId)].toUnblock;
+}
+
+void Simulator::setToUnblock(std::string driveId, int op)
+
+{
+    drive_t& drive = drives[std::stoi(driveId)];
+
+    if (op < drive.toUnblock)
+        drive.toUnblock = static_cast<operation>(op);
+}
+
+std::list<std::string> Simulator::getCartridgeIds()
+
+{
+    std::list<std::string> tapeIds;
+
+    for (std::pair<const std::string, cart_t>& cart : carts)
+        tapeIds.push_back(cart.first);
+
+    return tapeIds;
+}
+
+SchedulerPolicy::cart_state Simulator::getCartridgeState(std::string tapeId)
+
+{
+    std::map<std::string, cart_t>::iterator it = carts.find(tapeId);
+
+    if (it == carts.end())
+        return SchedulerPolicy::CART_UNKNOWN;
+
+    return static_cast<SchedulerPolicy::cart_state>(it->second.state);
+}
+
+std::string Simulator::getMountingDrive(std::string tapeId)
+
+{
+    if (carts[tapeId].drive == Const::UNSET)
+        return "";
+
+    return std::to_string(carts[tapeId].drive);
+}
+
+double Simulator::getMountTime(std::string tapeId)
+
+{
+    return carts[tapeId].mountTime;
+}
+
+unsigned long Simulator::getRemainingCap(std::string tapeId)
+
+{
+    return carts[tapeId].remaining;
+}
+
+std::string Simulator::getPool(std::string tapeId)
+
+{
+    return carts[tapeId].pool;
+}
+
+std::set<std::string> Simulator::getPoolCartridges(std::string pool)
+
+{
+    std::list<std::string>& cartnames = conf.pools[pool];
+
+    return std::set<std::string>(cartnames.begin(), cartnames.end());
+}
+
+bool Simulator::isRequested(std::string tapeId)
+
+{
+    return carts[tapeId].requested;
+}
+
+void Simulator::setRequested(std::string tapeId, bool requested)
+
+{
+    carts[tapeId].requested = requested;
+}
+
+void Simulator::moveTape(const SchedulerPolicy::request_t& req,
+        std::string driveId, std::string tapeId, SchedulerPolicy::operation op)
+
+{
+    moveTape(std::stoi(driveId), tapeId, op != SchedulerPolicy::UNMOUNT,
+            req.reqNum, req.pool);
+}
+
+void Simulator::premountTape(std::string driveId, std::string tapeId,
+        SchedulerPolicy::operation op)
+
+{
+    if (op == SchedulerPolicy::MOUNT)
+        stats.premounts++;
+
+    moveTape(std::stoi(driveId), tapeId, op == SchedulerPolicy::MOUNT,
+            SchedulerPolicy::PREMOUNT_REQNUM, "");
+}
+
+void Simulator::dispatch(const SchedulerPolicy::request_t& req,
+        std::string driveId, std::string tapeId)
+
+{
+    if (req.op == MIGRATION)
+        startMigration(req.reqNum, std::stoi(driveId), tapeId);
+    else
+        startRecall(std::stoi(driveId), tapeId);
+}
+
+void Simulator::startMigration(int reqNum, int drive, std::string tapeId)
+
+{
+    request_t& req = requests[reqNum];
+    std::shared_ptr<session_t> session = std::make_shared<session_t>();
+    std::list<file_t>::iterator it;
+    unsigned long unclaimedSize = 0;
+    unsigned long maxSize = 0;
+    unsigned long share;
+
+    carts[tapeId].state = INUSE;
+    drives[drive].busy = true;
+    drives[drive].usedBy = std::make_pair(req.pool,
+            SchedulerPolicy::MIGRATION_DRIVES);
+
+    *session = (session_t ) { MIGRATION, drive, tapeId, { }, { reqNum }, 0 };
+
+    // sizes are in MB within the simulator and in bytes for the policy
+    for (file_t& file : req.files) {
+        unclaimedSize += file.size;
+        maxSize = std::max(maxSize, file.size);
+    }
+    share = SchedulerPolicy::migrationShare(unclaimedSize * 1024 * 1024,
+            maxSize * 1024 * 1024, conf.numDrives,
+            carts[tapeId].remaining * 1024 * 1024) / (1024 * 1024);
+
+    // first fit decreasing as Migration::assignJobs
+    req.files.sort([](const file_t& a, const file_t& b) {
+        return a.size > b.size;
+    });
+
+    for (it = req.files.begin(); it != req.files.end();) {
+        if (it->size <= share) {
+            share -= it->size;
+            session->files.push_back(*it);
+            it = req.files.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    req.sessions++;
+    if (req.files.empty())
+        unqueueRequest(reqNum);
+
+    processNext(session);
+}
+
+void Simulator::startRecall(int drive, std::string tapeId)
+
+{
+    std::shared_ptr<session_t> session = std::make_shared<session_t>();
+    std::list<int> claimed;
+
+    carts[tapeId].state = INUSE;
+    drives[drive].busy = true;
+    drives[drive].usedBy = std::make_pair(carts[tapeId].pool,
+            SchedulerPolicy::RECALL_DRIVES);
+
+    *session = (session_t ) { TRARECALL, drive, tapeId, { }, { }, 0 };
+
+    // all recall requests for this cartridge, see Scheduler::claimRecalls
+    for (const SchedulerPolicy::queuekey_t& key : readyQueue) {
+        request_t& req = requests[std::get<3>(key)];
+        if (req.op != MIGRATION && req.tapeId.compare(tapeId) == 0)
+            claimed.push_back(req.reqNum);
+    }
+
+    for (int reqNum : claimed) {
+        request_t& req = requests[reqNum];
+        unqueueRequest(reqNum);
+        req.sessions++;
+        session->reqNums.insert(reqNum);
+        session->files.splice(session->files.end(), req.files);
+    }
+
+    session->files.sort([](const file_t& a, const file_t& b) {
+        return a.pos < b.pos;
+    });
+
+    processNext(session);
+}
+
+void Simulator::processNext(std::shared_ptr<session_t> session)
+
+{
+    drive_t& drive = drives[session->drive];
+    drive_stats_t& dstats = stats.drives[session->drive];
+    double locate;
+    double transfer;
+
+    while (session->files.empty() == false) {
+        file_t file = session->files.front();
+        request_t& req = requests[file.reqNum];
+
+        if (session->op == MIGRATION && drive.toUnblock < MIGRATION) {
+            stats.suspended++;
+            req.files.splice(req.files.begin(), session->files);
+            break;
+        }
+
+        session->files.pop_front();
+
+        if (req.op == SELRECALL && drive.toUnblock == TRARECALL) {
+            req.files.push_back(file);
+            continue;
+        }
+
+        transfer = file.size / conf.throughput;
+        if (session->op == MIGRATION)
+            locate = 0;
+        else
+            locate = conf.locateTime * fabs(file.pos - session->pos);
+
+        dstats.transfer += transfer;
+        dstats.locate += locate;
+
+        at(now + locate + transfer, [this, session, file]() {
+            request_t& req = requests[file.reqNum];
+            if (req.op == MIGRATION) {
+                carts[session->tapeId].remaining -= file.size;
+                stats.migrated += file.size;
+            } else {
+                session->pos = file.pos;
+                stats.recalled += file.size;
+                if (req.op == TRARECALL)
+                    stats.recallLatency[file.recClass].push_back(
+                            now - file.arrival);
+            }
+            processNext(session);
+        });
+        return;
+    }
+
+    finishSession(session);
+}
+
+void Simulator::finishSession(std::shared_ptr<session_t> session)
+
+{
+    drive_t& drive = drives[session->drive];
+
+    carts[session->tapeId].state = MOUNTED;
+    drive.busy = false;
+    drive.toUnblock = NOOP;
+    drive.usedBy = std::make_pair("", Const::UNSET);
+
+    for (int reqNum : session->reqNums) {
+        request_t& req = requests[reqNum];
+        req.sessions--;
+        if (req.files.empty() == false) {
+            if (req.op == TRARECALL) {
+                req.timeAdded = now;
+                req.aged = false;
+            }
+            queueRequest(reqNum);
+        } else if (req.sessions == 0) {
+            completeRequest(reqNum);
+        }
+    }
+}
+
+Simulator::stats_t Simulator::run(std::list<event_t> workload)
+
+{
+    std::function<void()> tick;
+    std::map<std::pair<double, long>, std::function<void()>>::iterator it;
+
+    for (event_t event : workload)
+        at(event.time, [this, event]() {arrival(event);});
+
+    // corresponds to the timed wait of Scheduler::run
+    tick = [this, &tick]() {
+        if (events.empty() == false)
+            at(now + conf.recallLatency, tick);
+    };
+    if (conf.recallLatency > 0)
+        at(0, tick);
+
+    while (events.empty() == false) {
+        it = events.begin();
+        now = it->first.first;
+        std::function<void()> func = it->second;
+        events.erase(it);
+        func();
+        SchedulerPolicy::schedule(*this, policy, now);
+    }
+
+    stats.endTime = now;
+    stats.unfinished = requests.size();
+
+    return stats;
+}
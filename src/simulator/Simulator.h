@@ -0,0 +1,205 @@
+/*******************************************************************************
+ * Copyright 2018 IBM Corp. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *******************************************************************************/
+#pragma once
+
+class Simulator: public SchedulerPolicy::Resources
+
+{
+public:
+    // same order (and therefore priority) as DataBase::operation
+    enum operation
+    {
+        TRARECALL = SchedulerPolicy::TRARECALL,
+        SELRECALL = SchedulerPolicy::SELRECALL,
+        MIGRATION = SchedulerPolicy::MIGRATION,
+        NOOP = SchedulerPolicy::NOOP
+    };
+    enum recall_class
+    {
+        INTERACTIVE = SchedulerPolicy::INTERACTIVE,
+        BULK = SchedulerPolicy::BULK
+    };
+    struct config_t
+    {
+        int numDrives;
+        std::map<std::string, std::list<std::string>> pools;
+        double mountTime;
+        double unmountTime;
+        double locateTime;
+        double throughput;
+        unsigned long capacity;
+        int minDwellTime;
+        int recallLatency;
+        std::map<SchedulerPolicy::limitkey_t, SchedulerPolicy::drive_limits>
+        limits;
+        bool premountHot;
+    };
+    struct event_t
+    {
+        double time;
+        operation op;
+        std::string target;
+        int numFiles;
+        unsigned long size;
+        int pid;
+    };
+    struct drive_stats_t
+    {
+        double transfer;
+        double locate;
+        double move;
+    };
+    struct stats_t
+    {
+        int mounts;
+        int unmounts;
+        int premounts;
+        int suspended;
+        int unfinished;
+        double endTime;
+        unsigned long migrated;
+        unsigned long recalled;
+        std::vector<double> recallLatency[2];
+        std::vector<double> selRecallLatency;
+        std::vector<double> migrationLatency;
+        std::vector<drive_stats_t> drives;
+    };
+private:
+    enum cart_state
+    {
+        UNMOUNTED = SchedulerPolicy::CART_UNMOUNTED,
+        MOVING = SchedulerPolicy::CART_MOVING,
+        MOUNTED = SchedulerPolicy::CART_MOUNTED,
+        INUSE = SchedulerPolicy::CART_INUSE
+    };
+    struct file_t
+    {
+        int reqNum;
+        unsigned long size;
+        double pos;
+        double arrival;
+        int recClass;
+    };
+    struct request_t
+    {
+        operation op;
+        int reqNum;
+        int recClass;
+        bool aged;
+        double timeAdded;
+        double arrival;
+        std::string pool;
+        std::string tapeId;
+        std::list<file_t> files;
+        int sessions;
+        bool queued;
+    };
+    struct drive_t
+    {
+        std::string tapeId;
+        bool busy;
+        int moveReqNum;
+        std::string moveReqPool;
+        operation toUnblock;
+        SchedulerPolicy::limitkey_t usedBy;
+    };
+    struct cart_t
+    {
+        std::string pool;
+        cart_state state;
+        int drive;
+        double mountTime;
+        unsigned long remaining;
+        bool requested;
+        double recallScore;
+        double lastRecall;
+    };
+    struct session_t
+    {
+        operation op;
+        int drive;
+        std::string tapeId;
+        std::list<file_t> files;
+        std::set<int> reqNums;
+        double pos;
+    };
+    config_t conf;
+    SchedulerPolicy::config_t policy;
+    stats_t stats;
+    double now;
+    long seq;
+    int nextReqNum;
+    std::map<std::pair<double, long>, std::function<void()>> events;
+    std::map<int, request_t> requests;
+    std::set<SchedulerPolicy::queuekey_t> readyQueue;
+    std::map<std::pair<std::string, int>, int> openRecalls;
+    std::map<int, std::pair<double, int>> pidEvents;
+    std::vector<drive_t> drives;
+    std::map<std::string, cart_t> carts;
+    std::mt19937 rng;
+
+    void at(double time, std::function<void()> func);
+    SchedulerPolicy::queuekey_t queueKey(const request_t& req);
+    void queueRequest(int reqNum);
+    void unqueueRequest(int reqNum);
+    void completeRequest(int reqNum);
+    void arrival(event_t event);
+    recall_class classify(int pid);
+    unsigned long minFileSize(const request_t& req);
+    void addRecall(const std::string& tapeId);
+
+    bool isMounted(int drive);
+    void moveTape(int drive, std::string tapeId, bool mount,
+            int reqNum, std::string pool);
+
+    bool nextRequest(SchedulerPolicy::request_t *req, bool first);
+    void setAged(const SchedulerPolicy::request_t& req);
+    int pendingWork(std::string tapeId,
+            SchedulerPolicy::priority_t minPriority);
+    std::map<std::string, SchedulerPolicy::limitkey_t> getUsedDrives();
+    std::list<std::string> getDriveIds();
+    bool driveIsBusy(std::string driveId);
+    int getMoveReqNum(std::string driveId);
+    std::string getMoveReqPool(std::string driveId);
+    std::string getMountedCartridge(std::string driveId);
+    int getToUnblock(std::string driveId);
+    void setToUnblock(std::string driveId, int op);
+    std::list<std::string> getCartridgeIds();
+    SchedulerPolicy::cart_state getCartridgeState(std::string tapeId);
+    std::string getMountingDrive(std::string tapeId);
+    double getMountTime(std::string tapeId);
+    unsigned long getRemainingCap(std::string tapeId);
+    std::string getPool(std::string tapeId);
+    std::set<std::string> getPoolCartridges(std::string pool);
+    bool isRequested(std::string tapeId);
+    void setRequested(std::string tapeId, bool requested);
+    double getRecallScore(std::string tapeId);
+    void moveTape(const SchedulerPolicy::request_t& req, std::string driveId,
+            std::string tapeId, SchedulerPolicy::operation op);
+    void premountTape(std::string driveId, std::string tapeId,
+            SchedulerPolicy::operation op);
+    void dispatch(const SchedulerPolicy::request_t& req, std::string driveId,
+            std::string tapeId);
+
+    void startMigration(int reqNum, int drive, std::string tapeId);
+    void startRecall(int drive, std::string tapeId);
+    void processNext(std::shared_ptr<session_t> session);
+    void finishSession(std::shared_ptr<session_t> session);
+public:
+    Simulator(config_t _conf);
+    stats_t run(std::list<event_t> workload);
+};
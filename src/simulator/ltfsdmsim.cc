@@ -0,0 +1,453 @@
+/*******************************************************************************
+ * Copyright 2018 IBM Corp. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *******************************************************************************/
+#include <unistd.h>
+#include <sys/resource.h>
+#include <math.h>
+
+#include <string>
+#include <sstream>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <list>
+#include <vector>
+#include <map>
+#include <set>
+#include <tuple>
+#include <memory>
+#include <functional>
+#include <random>
+#include <chrono>
+#include <algorithm>
+
+#include "src/common/Const.h"
+#include "src/server/SchedulerPolicy.h"
+
+#include "Simulator.h"
+
+void usage(char *name)
+
+{
+    std::cout << "usage: " << name
+            << " [-d <drives>] [-p <pool>:<number of cartridges>|<tape id>[,<tape id>…]] …"
+            << std::endl
+            << "          [-c <capacity GB>] [-m <mount time>] [-u <unmount time>]"
+            << std::endl
+            << "          [-s <locate time>] [-b <MB/s>] [-t <dwell time>] [-r <latency>] [-P]"
+            << std::endl
+            << "          [-l <pool>:migration|recall:<min drives>:<max drives>] …"
+            << std::endl
+            << "          -w <workload file> | -g <seed> [-D <duration>] [-H <hot cartridges>] [-o <workload file>]"
+            << std::endl;
+}
+
+std::vector<std::string> split(std::string str)
+
+{
+    std::vector<std::string> tokens;
+    std::istringstream strss(str);
+    std::string token;
+
+    while (std::getline(strss, token, ':'))
+        tokens.push_back(token);
+
+    return tokens;
+}
+
+bool addPool(Simulator::config_t *conf, std::string arg)
+
+{
+    std::vector<std::string> tokens = split(arg);
+    std::istringstream tapess;
+    std::string tapeId;
+    int num;
+
+    if (tokens.size() != 2 || tokens[0].compare("") == 0)
+        return false;
+
+    if (tokens[1].find_first_not_of("0123456789") == std::string::npos) {
+        num = std::stoi(tokens[1]);
+        for (int i = 0; i < num; i++)
+            conf->pools[tokens[0]].push_back(
+                    tokens[0] + "-" + std::to_string(i));
+    } else {
+        tapess.str(tokens[1]);
+        while (std::getline(tapess, tapeId, ','))
+            conf->pools[tokens[0]].push_back(tapeId);
+    }
+
+    return true;
+}
+
+bool addLimit(Simulator::config_t *conf, std::string arg)
+
+{
+    std::vector<std::string> tokens = split(arg);
+    SchedulerPolicy::drive_limits limits;
+    int op;
+
+    if (tokens.size() != 4)
+        return false;
+
+    if (tokens[1].compare("migration") == 0)
+        op = SchedulerPolicy::MIGRATION_DRIVES;
+    else if (tokens[1].compare("recall") == 0)
+        op = SchedulerPolicy::RECALL_DRIVES;
+    else
+        return false;
+
+    limits.minDrives = std::stoi(tokens[2]);
+    limits.maxDrives = std::stoi(tokens[3]);
+
+    if (limits.minDrives < 0 || limits.maxDrives < 0
+            || (limits.maxDrives > 0 && limits.minDrives > limits.maxDrives))
+        return false;
+
+    conf->limits[std::make_pair(tokens[0], op)] = limits;
+
+    return true;
+}
+
+bool readWorkload(std::string fileName, std::list<Simulator::event_t> *workload)
+
+{
+    std::ifstream infile(fileName);
+    std::string line;
+    std::string op;
+    Simulator::event_t event;
+
+    if (!infile.is_open())
+        return false;
+
+    while (std::getline(infile, line)) {
+        std::istringstream liness(line);
+
+        if (line.size() == 0 || line[0] == '#')
+            continue;
+
+        event = (Simulator::event_t ) { 0, Simulator::NOOP, "", 1, 0, 0 };
+
+        if (!(liness >> event.time >> op >> event.target))
+            return false;
+
+        if (op.compare("migrate") == 0) {
+            event.op = Simulator::MIGRATION;
+            liness >> event.numFiles >> event.size;
+        } else if (op.compare("recall") == 0) {
+            event.op = Simulator::SELRECALL;
+            liness >> event.numFiles >> event.size;
+        } else if (op.compare("trecall") == 0) {
+            event.op = Simulator::TRARECALL;
+            liness >> event.size >> event.pid;
+        } else {
+            return false;
+        }
+
+        if (liness.fail())
+            return false;
+
+        workload->push_back(event);
+    }
+
+    return true;
+}
+
+void writeWorkload(std::string fileName,
+        const std::list<Simulator::event_t>& workload)
+
+{
+    std::ofstream outfile(fileName, outfile.trunc);
+
+    for (const Simulator::event_t& event : workload) {
+        outfile << std::fixed << std::setprecision(1) << event.time << " ";
+        switch (event.op) {
+            case Simulator::MIGRATION:
+                outfile << "migrate " << event.target << " " << event.numFiles
+                        << " " << event.size;
+                break;
+            case Simulator::SELRECALL:
+                outfile << "recall " << event.target << " " << event.numFiles
+                        << " " << event.size;
+                break;
+            default:
+                outfile << "trecall " << event.target << " " << event.size
+                        << " " << event.pid;
+        }
+        outfile << std::endl;
+    }
+}
+
+/*
+ * The synthetic workload consists of
+ * - a migration every 30 minutes on average,
+ * - a selective recall of 50 files every two hours on average,
+ * - an interactive transparent recall every two minutes on average, and
+ * - a burst of 200 transparent recalls of a single process that spans
+ *   one or two cartridges every hour on average.
+ * If a number of hot cartridges is specified half of the interactive
+ * transparent recalls go to the first of them. Otherwise all cartridges
+ * are recalled from with the same probability.
+ */
+std::list<Simulator::event_t> genWorkload(const Simulator::config_t& conf,
+        int seed, double duration, int hot)
+
+{
+    std::mt19937 rng(seed);
+    std::vector<std::string> pools;
+    std::vector<std::string> tapes;
+    std::list<Simulator::event_t> workload;
+    std::vector<unsigned long> sizes = { 256, 1024, 4096 };
+    std::uniform_int_distribution<int> numFiles(100, 1000);
+    int pid = 2000;
+
+    for (std::pair<std::string, std::list<std::string>> pool : conf.pools) {
+        pools.push_back(pool.first);
+        for (std::string tapeId : pool.second)
+            tapes.push_back(tapeId);
+    }
+
+    std::uniform_int_distribution<int> pool(0, pools.size() - 1);
+    std::uniform_int_distribution<int> tape(0, tapes.size() - 1);
+    std::uniform_int_distribution<int> size(0, sizes.size() - 1);
+    std::uniform_int_distribution<int> hotTape(0,
+            std::max(std::min(hot, (int) tapes.size()), 1) - 1);
+    std::bernoulli_distribution toHot(0.5);
+
+    auto poisson =
+            [&](double interval, std::function<void(double)> add) {
+                std::exponential_distribution<double> next(1 / interval);
+                for (double t = next(rng); t < duration; t += next(rng))
+                add(t);
+            };
+
+    poisson(1800, [&](double t) {
+        workload.push_back( {t, Simulator::MIGRATION, pools[pool(rng)],
+                    numFiles(rng), sizes[size(rng)], 0});
+    });
+
+    poisson(7200, [&](double t) {
+        workload.push_back( {t, Simulator::SELRECALL, tapes[tape(rng)], 50,
+                    512, 0});
+    });
+
+    poisson(120, [&](double t) {
+        std::string target =
+                (hot > 0 && toHot(rng)) ? tapes[hotTape(rng)] : tapes[tape(rng)];
+        workload.push_back( {t, Simulator::TRARECALL, target, 1,
+                    100, 1000 + static_cast<int>(t) % 1000});
+    });
+
+    poisson(3600, [&](double t) {
+        std::string first = tapes[tape(rng)];
+        std::string second = tapes[tape(rng)];
+        pid++;
+        for (int i = 0; i < 200; i++)
+        workload.push_back( {t + i * 0.1, Simulator::TRARECALL,
+                    (i % 2 == 0 ? first : second), 1, 100, pid});
+    });
+
+    workload.sort(
+            [](const Simulator::event_t& a, const Simulator::event_t& b) {
+                return a.time < b.time;
+            });
+
+    return workload;
+}
+
+void printLatency(std::string name, std::vector<double> latency)
+
+{
+    std::cout << std::left << std::setw(36) << name << std::right
+            << std::setw(8) << latency.size();
+
+    if (latency.size() == 0) {
+        std::cout << std::endl;
+        return;
+    }
+
+    std::sort(latency.begin(), latency.end());
+
+    for (double p : { 0.5, 0.9, 0.99 })
+        std::cout << std::setw(10)
+                << latency[ceil(p * latency.size()) - 1];
+
+    std::cout << std::setw(10) << latency.back() << std::endl;
+}
+
+void report(const Simulator::stats_t& stats)
+
+{
+    double total = (stats.endTime > 0 ? stats.endTime : 1);
+    int i = 0;
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "simulated time:       " << stats.endTime << " s" << std::endl;
+    std::cout << "mounts:               " << stats.mounts << std::endl;
+    std::cout << "unmounts:             " << stats.unmounts << std::endl;
+    std::cout << "pre-mounts:           " << stats.premounts << std::endl;
+    std::cout << "migrated:             " << stats.migrated << " MB"
+            << std::endl;
+    std::cout << "recalled:             " << stats.recalled << " MB"
+            << std::endl;
+    std::cout << "suspended migrations: " << stats.suspended << std::endl;
+    std::cout << "unfinished requests:  " << stats.unfinished << std::endl;
+    std::cout << std::endl;
+
+    std::cout << "drive  transfer %  locate %    move %    idle %" << std::endl;
+    for (const Simulator::drive_stats_t& drive : stats.drives) {
+        std::cout << std::left << std::setw(5) << i++ << std::right
+                << std::setw(12) << 100 * drive.transfer / total
+                << std::setw(10) << 100 * drive.locate / total << std::setw(10)
+                << 100 * drive.move / total << std::setw(10)
+                << 100 * (total - drive.transfer - drive.locate - drive.move)
+                        / total << std::endl;
+    }
+    std::cout << std::endl;
+
+    std::cout << "latency (s)                          number       p50       p90       p99       max"
+            << std::endl;
+    printLatency("transparent recall (interactive)",
+            stats.recallLatency[Simulator::INTERACTIVE]);
+    printLatency("transparent recall (bulk)",
+            stats.recallLatency[Simulator::BULK]);
+    printLatency("selective recall request", stats.selRecallLatency);
+    printLatency("migration request", stats.migrationLatency);
+}
+
+int main(int argc, char **argv)
+
+{
+    Simulator::config_t conf = { 4, { }, Const::MOUNT_TIME_ESTIMATE,
+            Const::UNMOUNT_TIME_ESTIMATE, 100, 300, 6000UL * 1024, 0, 0, { }, false };
+    std::list<Simulator::event_t> workload;
+    std::string workloadFile;
+    std::string outputFile;
+    double duration = 86400;
+    int seed = Const::UNSET;
+    int hot = 0;
+    int opt;
+
+    try {
+        while ((opt = getopt(argc, argv, "hd:p:c:m:u:s:b:t:r:Pl:w:g:D:H:o:"))
+                != -1) {
+            switch (opt) {
+                case 'd':
+                    conf.numDrives = std::stoi(optarg);
+                    break;
+                case 'p':
+                    if (addPool(&conf, optarg) == false) {
+                        usage(argv[0]);
+                        return 1;
+                    }
+                    break;
+                case 'c':
+                    conf.capacity = std::stoul(optarg) * 1024;
+                    break;
+                case 'm':
+                    conf.mountTime = std::stod(optarg);
+                    break;
+                case 'u':
+                    conf.unmountTime = std::stod(optarg);
+                    break;
+                case 's':
+                    conf.locateTime = std::stod(optarg);
+                    break;
+                case 'b':
+                    conf.throughput = std::stod(optarg);
+                    break;
+                case 't':
+                    conf.minDwellTime = std::stoi(optarg);
+                    break;
+                case 'r':
+                    conf.recallLatency = std::stoi(optarg);
+                    break;
+                case 'P':
+                    conf.premountHot = true;
+                    break;
+                case 'l':
+                    if (addLimit(&conf, optarg) == false) {
+                        usage(argv[0]);
+                        return 1;
+                    }
+                    break;
+                case 'w':
+                    workloadFile = optarg;
+                    break;
+                case 'g':
+                    seed = std::stoi(optarg);
+                    break;
+                case 'D':
+                    duration = std::stod(optarg);
+                    break;
+                case 'H':
+                    hot = std::stoi(optarg);
+                    break;
+                case 'o':
+                    outputFile = optarg;
+                    break;
+                default:
+                    usage(argv[0]);
+                    return 1;
+            }
+        }
+    } catch (const std::exception& e) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    if (optind != argc || conf.numDrives <= 0 || conf.throughput <= 0
+            || hot < 0
+            || (workloadFile.compare("") == 0) == (seed == Const::UNSET)) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    if (conf.pools.empty())
+        addPool(&conf, "pool1:10");
+
+    if (workloadFile.compare("") != 0) {
+        if (readWorkload(workloadFile, &workload) == false) {
+            std::cout << "unable to read workload file " << workloadFile
+                    << "." << std::endl;
+            return 1;
+        }
+    } else {
+        workload = genWorkload(conf, seed, duration, hot);
+    }
+
+    std::set<std::string> tapes;
+    for (std::pair<std::string, std::list<std::string>> pool : conf.pools)
+        tapes.insert(pool.second.begin(), pool.second.end());
+
+    for (Simulator::event_t event : workload) {
+        if ((event.op == Simulator::MIGRATION
+                && conf.pools.count(event.target) == 0)
+                || (event.op != Simulator::MIGRATION
+                        && tapes.count(event.target) == 0)) {
+            std::cout << "unknown pool or cartridge " << event.target << "."
+                    << std::endl;
+            return 1;
+        }
+    }
+
+    if (outputFile.compare("") != 0)
+        writeWorkload(outputFile, workload);
+
+    report(Simulator(conf).run(workload));
+
+    return 0;
+}
@@ -0,0 +1,68 @@
+#!/usr/bin/python
+
+# Copyright 2018 IBM Corp. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#  https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Runs the scheduling simulator (no tape library required) for a couple of
+# generated workloads and checks that a minimum dwell time does not make the
+# tail latency of interactive transparent recalls worse. Build the simulator
+# first (make simulator) and start this script from the repository root or
+# from within the test directory.
+
+import sys
+import os.path
+import subprocess
+
+simulator = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                         "..", "bin", "ltfsdmsim")
+seeds = [1, 2, 3, 4]
+dwelltimes = [300, 600]
+
+def p99(args):
+    try:
+        output = subprocess.check_output([simulator] + args)
+    except Exception:
+        print("unable to run " + simulator + " " + " ".join(args))
+        exit(-1)
+
+    for line in output.decode().splitlines():
+        if line.startswith("transparent recall (interactive)"):
+            return float(line.split()[6])
+
+    print("no recall latency reported by " + simulator + " " + " ".join(args))
+    exit(-1)
+
+def main(argv):
+    failed = False
+
+    for seed in seeds:
+        base = p99(["-g", str(seed)])
+        for dwelltime in dwelltimes:
+            value = p99(["-g", str(seed), "-t", str(dwelltime)])
+            print("seed " + str(seed) + ": recall p99 " + str(base)
+                  + " s without and " + str(value) + " s with a dwell time of "
+                  + str(dwelltime) + " s")
+            if value > base:
+                print("recall p99 got worse with a dwell time of "
+                      + str(dwelltime) + " s, seed " + str(seed))
+                failed = True
+
+    if failed:
+        exit(-1)
+
+    print("== test finished ==")
+
+
+if __name__ == "__main__":
+    main(sys.argv[1:])
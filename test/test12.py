@@ -0,0 +1,77 @@
+#!/usr/bin/python
+
+# Copyright 2018 IBM Corp. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#  https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Runs the scheduling simulator (no tape library required) for generated
+# workloads where half of the interactive transparent recalls go to a few
+# hot cartridges and more drives are available than needed for the
+# regular workload. Pre-mounting hot cartridges (option -P) needs to save
+# tape mounts without making the recall latency worse. Build the simulator
+# first (make simulator) and start this script from the repository root or
+# from within the test directory.
+
+import sys
+import os.path
+import subprocess
+
+simulator = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                         "..", "bin", "ltfsdmsim")
+seeds = [1, 2, 3]
+options = ["-d", "8", "-p", "pool1:40", "-H", "4", "-t", "300"]
+
+def run(args):
+    mounts = None
+    latency = None
+
+    try:
+        output = subprocess.check_output([simulator] + args)
+    except Exception:
+        print("unable to run " + simulator + " " + " ".join(args))
+        exit(-1)
+
+    for line in output.decode().splitlines():
+        if line.startswith("mounts:"):
+            mounts = int(line.split()[1])
+        elif line.startswith("transparent recall (interactive)"):
+            latency = [float(value) for value in line.split()[4:7]]
+
+    if mounts is None or latency is None:
+        print("unexpected output of " + simulator + " " + " ".join(args))
+        exit(-1)
+
+    return mounts, latency
+
+def main(argv):
+    failed = False
+
+    for seed in seeds:
+        mounts, latency = run(["-g", str(seed)] + options)
+        pmounts, platency = run(["-g", str(seed)] + options + ["-P"])
+        print("seed " + str(seed) + ": " + str(mounts) + " mounts, recall p50/p90/p99 "
+              + "/".join(str(value) for value in latency) + " s without and "
+              + str(pmounts) + " mounts, "
+              + "/".join(str(value) for value in platency) + " s with pre-mounting")
+        if pmounts >= mounts or platency[2] > latency[2]:
+            print("pre-mounting does not show a benefit, seed " + str(seed))
+            failed = True
+
+    if failed:
+        exit(-1)
+
+    print("== test finished ==")
+
+
+if __name__ == "__main__":
+    main(sys.argv[1:])
@@ -0,0 +1,136 @@
+#!/usr/bin/python
+
+# Copyright 2018 IBM Corp. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#  https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Checks that the SQL statements of the backend use an index. The tables
+# and indexes are created in an in-memory database the same way as by
+# DataBase::createTables and the query plan of each statement defined in
+# src/server/SQLStatements.cc is determined (EXPLAIN QUERY PLAN). The test
+# fails if one of them performs a full table scan. Statements that are
+# allowed to scan a table need to be listed in "unindexed" below; a new
+# statement therefore is checked without adding it anywhere. Neither a
+# tape library nor a running backend is required.
+
+import sys
+import os.path
+import re
+import sqlite3
+
+statements = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                          "..", "src", "server", "SQLStatements.cc")
+
+# classes whose statements are not checked at all
+unchecked = [
+    "DataBase",      # tables, indexes, pragmas, transaction control
+    "Server",        # cleanup at startup
+    "MessageParser"  # lists all requests, filter and page clauses
+]
+
+# statements that are allowed to perform a full table scan
+unindexed = [
+    "Migration::RESUME_JOBS",            # executed at startup only
+    "Migration::RESUME_UNASSIGNED_JOBS",
+    "Migration::RESUME_TRANSFERS",
+    "Migration::DELETE_SESSIONS",
+    "Migration::RESUME_REQUESTS",
+    "SelRecall::RESUME_JOBS",
+    "SelRecall::RESUME_REQUESTS",
+    "SQLJobStore::SELECT_TRANS_RECALLS", # executed at shutdown only
+    "SQLJobStore::INFO_JOBS",            # lists all jobs
+    "SQLJobStore::INFO_JOBS_GROUPED",
+    "SQLJobStore::FILTER_FILE_STATE",    # filter clauses
+    "SQLJobStore::FILTER_PATH_PREFIX"
+]
+
+def strip(text):
+    # C++ comments are removed, string literals are kept
+    return re.sub(r'"(?:\\.|[^"\\])*"|/\*.*?\*/|//[^\n]*',
+                  lambda m: m.group(0) if m.group(0).startswith('"') else " ",
+                  text, flags=re.S)
+
+def readStatements():
+    stmts = {}
+
+    try:
+        with open(statements) as f:
+            text = strip(f.read())
+    except Exception:
+        print("unable to read " + statements)
+        exit(-1)
+
+    # const std::string Class::NAME = "..." "...";
+    for m in re.finditer(r'const std::string (\w+)::(\w+)\s*=\s*'
+                         r'((?:"(?:\\.|[^"\\])*"\s*)+);', text):
+        literals = re.findall(r'"((?:\\.|[^"\\])*)"', m.group(3))
+        stmts[m.group(1) + "::" + m.group(2)] = "".join(literals)
+
+    if len(stmts) == 0:
+        print("no statements found in " + statements)
+        exit(-1)
+
+    return stmts
+
+def toParameters(sql):
+    # the same as DataBase::toParameters: %n% and '%n%' become ?n
+    return re.sub(r"'%(\d+)%'|%(\d+)%",
+                  lambda m: "?" + (m.group(1) or m.group(2)), sql)
+
+def main(argv):
+    failed = False
+    checked = 0
+    stmts = readStatements()
+    db = sqlite3.connect(":memory:")
+
+    for name in sorted(stmts):
+        if name.startswith("DataBase::CREATE_"):
+            db.execute(stmts[name])
+
+    for name in sorted(stmts):
+        if name.split("::")[0] in unchecked or name in unindexed:
+            continue
+
+        sql = toParameters(stmts[name])
+        params = [int(n) for n in re.findall(r"\?(\d+)", sql)]
+
+        try:
+            plan = db.execute("EXPLAIN QUERY PLAN " + sql,
+                              [None] * max(params + [0])).fetchall()
+        except Exception as e:
+            print(name + ": unable to determine the query plan: " + str(e))
+            failed = True
+            continue
+
+        checked += 1
+
+        for row in plan:
+            if row[3].startswith("SCAN "):
+                print(name + " performs a full table scan: " + row[3])
+                failed = True
+
+    for name in unindexed:
+        if name not in stmts:
+            print(name + " does not exist anymore")
+            failed = True
+
+    print(str(checked) + " statements checked")
+
+    if failed:
+        exit(-1)
+
+    print("== test finished ==")
+
+
+if __name__ == "__main__":
+    main(sys.argv[1:])